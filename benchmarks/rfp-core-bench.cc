@@ -0,0 +1,302 @@
+/**
+ * Microbenchmarks for the RFP core modules (TMM, LDM, RMM, SatelliteHelper)
+ *
+ * Core-only ns-3 build, no DCE or Quagga: vtysh commands take the simulated path
+ * and the simulator is never run. Every benchmark repeats its batch until it has
+ * run for --minTime seconds and reports ns/op and ops/s.
+ *
+ *   ./waf --run "satnet-rfp-bench --scales=100,1000,10000,100000 --csv=bench.csv"
+ *   ./waf --run "satnet-rfp-bench --baseline=bench.csv --tolerance=0.25"
+ *
+ * With --baseline the exit status is 1 when a benchmark is slower than the baseline
+ * by more than the tolerance.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+
+#include "helpers/satellite-helper.h"
+#include "modules/topology-mgmt.h"
+#include "modules/link-detection.h"
+#include "modules/route-mgmt.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("SatnetRfpBench");
+
+struct BenchResult {
+    std::string name;
+    uint32_t scale;
+    uint64_t ops;
+    double nsPerOp;
+};
+
+struct SyntheticLink {
+    int nodeA;
+    int nodeB;
+};
+
+static double g_minTime = 0.2;
+
+/**
+ * Runs batch() (which performs opsPerBatch operations) until g_minTime has elapsed
+ * setup() runs before every batch and is not timed
+ */
+template <typename Setup, typename Batch>
+static BenchResult RunBench(const std::string& name, uint32_t scale, uint64_t opsPerBatch,
+                            Setup setup, Batch batch) {
+    double elapsed = 0.0;
+    uint64_t ops = 0;
+    do {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        batch();
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ops += opsPerBatch;
+    } while (elapsed < g_minTime);
+
+    BenchResult result = {name, scale, ops, elapsed * 1e9 / ops};
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(9) << scale
+              << std::setw(12) << ops << std::fixed << std::setprecision(1)
+              << std::setw(14) << result.nsPerOp << std::setprecision(0)
+              << std::setw(16) << 1e9 / result.nsPerOp << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    return result;
+}
+
+static void NoSetup() {}
+
+/**
+ * Random links between numNodes nodes, as (min, max) pairs
+ */
+static std::vector<SyntheticLink> MakeLinks(uint32_t count, uint32_t numNodes, std::mt19937& rng) {
+    std::uniform_int_distribution<int> pick(0, numNodes - 1);
+    std::vector<SyntheticLink> links;
+    links.reserve(count);
+    while (links.size() < count) {
+        int a = pick(rng);
+        int b = pick(rng);
+        if (a == b) continue;
+        links.push_back(SyntheticLink{std::min(a, b), std::max(a, b)});
+    }
+    return links;
+}
+
+static void BenchScale(uint32_t scale, NodeContainer& nodes, std::vector<BenchResult>& results) {
+    // ~4 ISLs per satellite: scale links between scale / 2 nodes
+    uint32_t numNodes = std::max<uint32_t>(scale / 2, 4);
+    if (nodes.GetN() < numNodes) {
+        MobilityHelper mobility;
+        NodeContainer added;
+        added.Create(numNodes - nodes.GetN());
+        mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+        mobility.Install(added);
+        nodes.Add(added);
+    }
+
+    std::mt19937 rng(scale);
+    std::vector<SyntheticLink> links = MakeLinks(scale, numNodes, rng);
+    std::uniform_real_distribution<double> eventTime(10.0, 1000.0);
+    std::vector<double> times(scale);
+    for (double& t : times) t = eventTime(rng);
+
+    // TMM: predicted event insertion
+    TopologyManagementModule* tmm = nullptr;
+    results.push_back(RunBench("tmm.add_event", scale, scale,
+        [&]() { delete tmm; tmm = new TopologyManagementModule(); },
+        [&]() {
+            for (uint32_t i = 0; i < scale; i++) {
+                tmm->AddPredictableLinkDown(i, links[i].nodeA, links[i].nodeB, times[i]);
+            }
+        }));
+
+    // TMM: BLD queries against `scale` registered events
+    const uint32_t queries = 1000;
+    volatile uint32_t hits = 0;
+    results.push_back(RunBench("tmm.bld_query", scale, queries, NoSetup,
+        [&]() {
+            for (uint32_t i = 0; i < queries; i++) {
+                const SyntheticLink& link = links[(i * 7919) % scale];
+                hits = hits + tmm->IsInBldPeriod(link.nodeA, link.nodeB, times[i % scale]);
+            }
+        }));
+
+    // LDM: real link-state updates (BLD check, reported state, simulated Quagga call)
+    // Each update scans the TMM events, so the batch is capped to keep 100k links tractable
+    LinkDetectionModule ldm;
+    bool up = true;
+    const uint32_t updateOps = std::min(scale, queries);
+    results.push_back(RunBench("ldm.link_state_update", scale, updateOps,
+        [&]() { up = !up; },
+        [&]() {
+            for (uint32_t i = 0; i < updateOps; i++) {
+                ldm.UpdateRealLinkState(links[i].nodeA, links[i].nodeB, up, 0.0, tmm);
+            }
+        }));
+    delete tmm;
+
+    // RMM: BFU buffering, then the synchronous flush at T2
+    std::vector<std::string> updates(scale);
+    for (uint32_t i = 0; i < scale; i++) {
+        std::ostringstream update;
+        update << "ADD " << NodePrefix(links[i].nodeB) << " " << NodeNextHop(links[i].nodeA) << " " << (1 + i % 10);
+        updates[i] = update.str();
+    }
+
+    RouteManagementModule* rmm = nullptr;
+    results.push_back(RunBench("rmm.bfu_buffer", scale, scale,
+        [&]() {
+            delete rmm;
+            rmm = new RouteManagementModule();
+            rmm->StartBfuPeriod(0.0);
+        },
+        [&]() {
+            for (uint32_t i = 0; i < scale; i++) {
+                rmm->OnNewRoutingTable(nodes.Get(links[i].nodeA), updates[i], 0.0);
+            }
+        }));
+
+    results.push_back(RunBench("rmm.bfu_flush", scale, scale,
+        [&]() {
+            delete rmm;
+            rmm = new RouteManagementModule();
+            rmm->StartBfuPeriod(0.0);
+            for (uint32_t i = 0; i < scale; i++) {
+                rmm->OnNewRoutingTable(nodes.Get(links[i].nodeA), updates[i], 0.0);
+            }
+        },
+        [&]() { rmm->EndBfuPeriod(1.0); }));
+    delete rmm;
+
+    // SatelliteHelper: constellation propagation and ISL visibility
+    SatelliteHelper satHelper;
+    NodeContainer satellites;
+    for (uint32_t i = 0; i < numNodes; i++) {
+        satellites.Add(nodes.Get(i));
+    }
+    double t = 0.5;
+    results.push_back(RunBench("sat.update_positions", numNodes, numNodes, NoSetup,
+        [&]() {
+            satHelper.UpdatePositions(satellites, t);
+            t += 1.0;       // stays off the once-per-second position print
+        }));
+
+    volatile uint32_t visible = 0;
+    results.push_back(RunBench("sat.visibility", scale, scale, NoSetup,
+        [&]() {
+            for (uint32_t i = 0; i < scale; i++) {
+                visible = visible + satHelper.IsSatelliteVisible(links[i].nodeA, links[i].nodeB, true);
+            }
+        }));
+}
+
+static std::vector<uint32_t> ParseScales(const std::string& text) {
+    std::vector<uint32_t> scales;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) scales.push_back(std::stoul(item));
+    }
+    return scales;
+}
+
+static void WriteCsv(const std::string& filename, const std::vector<BenchResult>& results) {
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Error writing benchmark CSV " << filename << std::endl;
+        return;
+    }
+    out << "benchmark,scale,ops,ns_per_op,ops_per_sec" << std::endl;
+    for (const BenchResult& r : results) {
+        out << r.name << "," << r.scale << "," << r.ops << "," << r.nsPerOp << "," << 1e9 / r.nsPerOp << std::endl;
+    }
+}
+
+/**
+ * Compares against a previous CSV, returns the number of regressions
+ */
+static uint32_t CompareBaseline(const std::string& filename, const std::vector<BenchResult>& results, double tolerance) {
+    std::ifstream in(filename);
+    if (!in) {
+        std::cerr << "Error reading baseline " << filename << std::endl;
+        return 0;
+    }
+
+    std::map<std::pair<std::string, uint32_t>, double> baseline;
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+        std::istringstream row(line);
+        std::string name, scale, ops, nsPerOp;
+        if (std::getline(row, name, ',') && std::getline(row, scale, ',') &&
+            std::getline(row, ops, ',') && std::getline(row, nsPerOp, ',')) {
+            baseline[std::make_pair(name, (uint32_t)std::stoul(scale))] = std::stod(nsPerOp);
+        }
+    }
+
+    uint32_t regressions = 0;
+    for (const BenchResult& r : results) {
+        auto it = baseline.find(std::make_pair(r.name, r.scale));
+        if (it == baseline.end()) continue;
+        double ratio = r.nsPerOp / it->second;
+        if (ratio > 1.0 + tolerance) {
+            std::cout << "REGRESSION " << r.name << " @" << r.scale << ": " << it->second << " -> "
+                      << r.nsPerOp << " ns/op (x" << ratio << ")" << std::endl;
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+int main(int argc, char* argv[]) {
+    std::string scaleList = "100,1000,10000,100000";
+    std::string csv = "";
+    std::string baseline = "";
+    double tolerance = 0.25;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scales", "Comma-separated synthetic link counts", scaleList);
+    cmd.AddValue("minTime", "Minimum measured time per benchmark (s)", g_minTime);
+    cmd.AddValue("csv", "Write the results as CSV", csv);
+    cmd.AddValue("baseline", "CSV of a previous run to compare against", baseline);
+    cmd.AddValue("tolerance", "Allowed slowdown against the baseline (0.25 = 25%)", tolerance);
+    cmd.Parse(argc, argv);
+
+    // Keep the module traces out of the measurements
+    GetLogger().SetDefaultLevel(LOG_LEVEL_ERROR);
+
+    std::cout << std::left << std::setw(28) << "benchmark" << std::right << std::setw(9) << "scale"
+              << std::setw(12) << "ops" << std::setw(14) << "ns/op" << std::setw(16) << "ops/s" << std::endl;
+
+    NodeContainer nodes;
+    std::vector<BenchResult> results;
+    for (uint32_t scale : ParseScales(scaleList)) {
+        BenchScale(scale, nodes, results);
+    }
+
+    if (!csv.empty()) {
+        WriteCsv(csv, results);
+    }
+
+    int status = 0;
+    if (!baseline.empty()) {
+        uint32_t regressions = CompareBaseline(baseline, results, tolerance);
+        std::cout << regressions << " regression(s) against " << baseline << std::endl;
+        status = regressions > 0 ? 1 : 0;
+    }
+
+    GetLogger().Shutdown();
+    Simulator::Destroy();
+    return status;
+}
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cmath>
+#include <limits>
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
@@ -17,14 +19,26 @@
 #include "ns3/netanim-module.h"
 #include "ns3/dce-module.h"
 #include "ns3/quagga-helper.h"
+#ifdef SATNET_MPI
+#include "ns3/mpi-module.h"
+#endif
 
 #include "core/constellation-params.h"
+#include "core/constellation-config.h"
 #include "core/constellation.h"
 #include "helpers/quagga-integration.h"
 #include "helpers/satellite-helper.h"
 #include "helpers/animation-helper.h"
 #include "applications/satnet-controller.h"
 #include "applications/traffic-generator.h"
+#include "modules/gsl-management.h"
+#include "modules/prediction-horizon.h"
+#include "helpers/satellite-channel.h"
+#include "helpers/plane-partition.h"
+#include "helpers/quagga-activation.h"
+#include "helpers/quagga-config.h"
+#include "helpers/kernel-fib.h"
+#include "helpers/satnet-routing.h"
 
 using namespace ns3;
 
@@ -34,59 +48,229 @@ NS_LOG_COMPONENT_DEFINE("SatnetDceQuaggaRfpConstellation");
 SatnetOspfController* g_rfpController = nullptr;
 SatelliteHelper* g_satHelper = nullptr;
 AnimationHelper* g_animHelper = nullptr;
+TopologyModel* g_topology = nullptr;        // Contact plan (CGR routing mode only)
+ContactGraphRouter* g_cgr = nullptr;
+LinkLoadMonitor* g_loadMonitor = nullptr;   // Queue occupancy for load-aware ECMP
+GroundStationLinkManager* g_gslManager = nullptr;
+SatelliteLinkHelper* g_islHelper = nullptr;     // Range-based ISL delay (nullptr = fixed SATELLITE_DELAY)
+OspfModel* g_ospfModel = nullptr;               // In-simulator OSPF (model routing, or outside the Quagga region)
+ConvergenceMonitor* g_convergenceMonitor = nullptr;     // Measured convergence between T1 and T2
+KernelFibReader* g_kernelFib = nullptr;                 // DCE forwarding tables read by the monitor (pure Quagga runs)
+PredictionHorizon* g_predictionHorizon = nullptr;       // Streams the planned link-downs to the controller
+SatnetForwarding* g_forwarding = nullptr;               // RMM tables on the packet path (SatnetRouting)
+std::vector<std::pair<uint32_t, uint32_t>> g_islPairs;
+
+/**
+ * Physical state of an installed ISL (same index as g_islPairs)
+ */
+struct IslState {
+    NetDeviceContainer devices;
+    bool up;
+    double downAt;          // T0 of a planned link-down, the contact ends there
+};
+std::vector<IslState> g_islStates;
+double g_simTime = SIM_STOP;
+uint32_t g_numSatellites = 25;
+uint32_t g_linkEvents = 6;              // Predicted link-down events (event density)
+double g_eventInterval = 8.0;           // Spacing between predicted link-down events (s)
+bool g_randomEvents = false;            // Link and T0 jitter of each event drawn from --RngSeed/--RngRun
+
+const uint32_t QUAGGA_DAEMONS_PER_NODE = 2;    // zebra + ospfd
+const char* const QUAGGA_DAEMON_BINARIES[QUAGGA_DAEMONS_PER_NODE] = {"zebra", "ospfd"};
+const uint32_t DCE_STACK_QUAGGA_HELPER = 1 << 16;   // Daemon stack QuaggaHelper sets
+
+/**
+ * Staged start (waves): zebra at startTime, ospfd QUAGGA_OSPFD_DELAY later.
+ * Without waves the DCE helper's own start times are kept. Either way vtysh commands
+ * on the node are simulated until its daemons run.
+ */
+void StartQuaggaDaemons(ApplicationContainer& daemons, Ptr<Node> node, double startTime, bool staged) {
+    for (uint32_t i = 0; i < daemons.GetN(); i++) {
+        double daemonStart = staged ? startTime + i * QUAGGA_OSPFD_DELAY : 0.0;
+        if (staged) {
+            daemons.Get(i)->SetStartTime(Seconds(daemonStart));
+        }
+        
+        // Per-binary stack from the profile, set before the fiber is created at start
+        uint32_t stackSize = DCE_STACK_QUAGGA_HELPER;
+        if (i < QUAGGA_DAEMONS_PER_NODE) {
+            stackSize = GetDceFiberPool().GetStackSize(QUAGGA_DAEMON_BINARIES[i], DCE_STACK_QUAGGA_HELPER);
+            Ptr<DceApplication> daemon = DynamicCast<DceApplication>(daemons.Get(i));
+            if (daemon) {
+                daemon->SetStackSize(stackSize);
+            }
+        }
+        GetDceFiberPool().AddDaemon(stackSize, daemonStart);
+    }
+    double ready = 0.0;
+    if (staged && daemons.GetN() > 0) {
+        ready = startTime + (daemons.GetN() - 1) * QUAGGA_OSPFD_DELAY;
+    }
+    SetQuaggaNode(node->GetId(), ready);
+}
+
+/**
+ * Longest shortest path (hops) of the ISL graph, BFS from every satellite
+ */
+uint32_t IslHopDiameter(const std::vector<std::pair<uint32_t, uint32_t>>& links, uint32_t numSatellites) {
+    std::vector<std::vector<uint32_t>> adjacency(numSatellites);
+    for (const auto& link : links) {
+        adjacency[link.first].push_back(link.second);
+        adjacency[link.second].push_back(link.first);
+    }
+    uint32_t diameter = 0;
+    std::vector<uint32_t> hops(numSatellites);
+    std::vector<uint32_t> queue;
+    queue.reserve(numSatellites);
+    for (uint32_t source = 0; source < numSatellites; source++) {
+        std::fill(hops.begin(), hops.end(), UINT32_MAX);
+        hops[source] = 0;
+        queue.assign(1, source);
+        for (size_t head = 0; head < queue.size(); head++) {
+            uint32_t node = queue[head];
+            diameter = std::max(diameter, hops[node]);
+            for (uint32_t next : adjacency[node]) {
+                if (hops[next] != UINT32_MAX) continue;
+                hops[next] = hops[node] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return diameter;
+}
 
 // Callbacks
-void CreatePredictableLinkEvents() {
+
+const double POSITION_UPDATE_INTERVAL = 0.1; // s between two position (and ISL state) updates
+const double LINK_EVENTS_START = 10.0;      // Planned link-down k happens at LINK_EVENTS_START + k * eventInterval
+const double LINK_EVENTS_END_GUARD = 15.0;  // None in the last seconds of the run
+const double LINK_EVENTS_JITTER = 0.25;     // --randomEvents: T0 within +/- jitter x eventInterval of its slot
+
+/**
+ * Uniform [0, 1) draw of planned event k from the ns-3 seed and run number. Stateless, so
+ * every prediction window and every rank draws the same value for the same event
+ */
+static double PlannedEventDraw(uint32_t k, uint32_t salt) {
+    uint64_t x = ((uint64_t)RngSeedManager::GetSeed() << 32) ^ (RngSeedManager::GetRun() * 0x9e3779b97f4a7c15ULL) ^
+                 (((uint64_t)k << 8) | salt);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Index in g_islPairs of the link planned event k takes down
+ */
+static uint32_t PlannedIsl(uint32_t k) {
+    if (!g_randomEvents) return (k - 1) % g_islPairs.size();
+    return std::min<uint32_t>(PlannedEventDraw(k, 0) * g_islPairs.size(), g_islPairs.size() - 1);
+}
+
+static double PlannedLinkDownTime(uint32_t k) {
+    double time = LINK_EVENTS_START + k * g_eventInterval;
+    if (g_randomEvents) {
+        time += (2.0 * PlannedEventDraw(k, 1) - 1.0) * LINK_EVENTS_JITTER * g_eventInterval;
+    }
+    return time;
+}
+
+/**
+ * Contact plan of the planned ISL link-downs with T0 in [from, until), at most g_linkEvents:
+ * event k (1-based) goes round the installed ISLs in installation order, or with
+ * --randomEvents takes a random ISL with its T0 jittered around its slot (still in k order)
+ */
+void CollectPlannedLinkDowns(double from, double until, std::vector<PredictedTransition>& transitions) {
+    if (g_islPairs.empty() || g_eventInterval <= 0.0) return;
+    
+    until = std::min(until, g_simTime - LINK_EVENTS_END_GUARD);
+    uint32_t first = 1;
+    if (from > LINK_EVENTS_START + g_eventInterval) {
+        first = (uint32_t)std::floor((from - LINK_EVENTS_START) / g_eventInterval);
+    }
+    for (uint32_t k = first; k <= g_linkEvents; k++) {
+        double linkDownTime = PlannedLinkDownTime(k);
+        if (linkDownTime >= until) break;
+        if (linkDownTime < from) continue;
+        
+        const std::pair<uint32_t, uint32_t>& isl = g_islPairs[PlannedIsl(k)];
+        if (!ValidateNodeIndices(isl.first, isl.second)) continue;
+        transitions.push_back({(int)k, (int)isl.first, (int)isl.second, linkDownTime});
+    }
+}
+
+/**
+ * One window of the prediction horizon: TMM/timeline, then the CGR contact plan
+ */
+void SchedulePredictedLinkDowns(const std::vector<PredictedTransition>& transitions) {
     try {
         if (!g_rfpController) return;
         
-        NS_LOG_INFO("========== CREATING PREDICTABLE LINK EVENTS ==========");
-        
-        uint32_t eventCount = 0;
-        double currentTime = 10.0;
-        
-        uint32_t totalNodes = NodeList::GetNNodes();
-        uint32_t maxSatellites = std::min(totalNodes, (uint32_t)30);
-        
-        if (maxSatellites < 2) {
-            NS_LOG_ERROR("Not enough nodes to create links");
-            return;
-        }
-        
-        for (uint32_t i = 0; i < 6 && eventCount < 6; i++) {
-            uint32_t nodeA = i % maxSatellites;
-            uint32_t nodeB = (i + 1) % maxSatellites;
-            
-            if (nodeA == nodeB) {
-                nodeB = (nodeB + 1) % maxSatellites;
-            }
-            
-            if (!ValidateNodeIndices(nodeA, nodeB)) {
-                continue;
+        for (const PredictedTransition& transition : transitions) {
+            g_rfpController->SchedulePredictableLinkDown(transition.linkId, transition.nodeA, transition.nodeB, transition.time);
+            uint32_t link = PlannedIsl(transition.linkId);
+            if (link < g_islStates.size()) {
+                g_islStates[link].downAt = std::min(g_islStates[link].downAt, transition.time);
             }
-            
-            double linkDownTime = currentTime + (eventCount + 1) * 8.0;
-            
-            if (linkDownTime < SIM_STOP - 15.0) {
-                g_rfpController->SchedulePredictableLinkDown(eventCount + 1, nodeA, nodeB, linkDownTime);
-                eventCount++;
+            if (g_topology) {
+                g_topology->EndLinkAt(g_topology->FindLink(transition.nodeA, transition.nodeB), transition.time);
             }
         }
         
-        NS_LOG_INFO("📅 Successfully scheduled " << eventCount << " predictable link-down events");
+        if (g_cgr && g_topology) {
+            g_cgr->LoadContactPlan(*g_topology, Simulator::Now().GetSeconds(), g_simTime);
+        }
+        
+        NS_LOG_INFO("📅 Successfully scheduled " << transitions.size() << " predictable link-down events");
         
     } catch (const std::exception& e) {
         NS_LOG_ERROR("Error creating predictable link events: " << e.what());
     }
 }
 
-static void GlobalSatPosUpdate(double time) {
+/**
+ * ISL link-state update: a link is up while it is visible and its contact has not ended.
+ * Changes take both interfaces up or down and reach the controller (LDM, fast failover)
+ */
+static void UpdateIslStates(double time) {
+    if (!g_rfpController) return;
+    const ConstellationConfig& constellation = GetConstellation();
+    for (uint32_t l = 0; l < g_islStates.size(); l++) {
+        IslState& state = g_islStates[l];
+        uint32_t a = g_islPairs[l].first;
+        uint32_t b = g_islPairs[l].second;
+        bool interPlane = constellation.PlaneOf(a) != constellation.PlaneOf(b);
+        bool up = time < state.downAt && g_satHelper->IsSatelliteVisible(a, b, interPlane);
+        if (up == state.up) continue;
+        
+        state.up = up;
+        for (uint32_t i = 0; i < state.devices.GetN(); i++) {
+            Ptr<NetDevice> device = state.devices.Get(i);
+            Ptr<Ipv4> ipv4 = device->GetNode()->GetObject<Ipv4>();
+            int32_t interface = ipv4 ? ipv4->GetInterfaceForDevice(device) : -1;
+            if (interface < 0) continue;
+            if (up) {
+                ipv4->SetUp(interface);
+            } else {
+                ipv4->SetDown(interface);
+            }
+        }
+        g_rfpController->OnLinkStateChange(a, b, up, time);
+    }
+}
+
+// Position update number step, chained until the end of the run
+static void GlobalSatPosUpdate(uint32_t step) {
+    double time = step * POSITION_UPDATE_INTERVAL;
+    if (time + POSITION_UPDATE_INTERVAL <= g_simTime + 1e-9) {
+        Simulator::Schedule(Seconds(POSITION_UPDATE_INTERVAL), &GlobalSatPosUpdate, step + 1);
+    }
+    
     try {
         if (!g_satHelper) return;
         
         uint32_t totalNodes = NodeList::GetNNodes();
-        uint32_t theoreticalSatellites = NUM_PLANES * SATS_PER_PLANE;
-        uint32_t maxSats = std::min(theoreticalSatellites, (uint32_t)25);
+        uint32_t maxSats = g_numSatellites;
         
         if (maxSats == 0) return;
         
@@ -100,6 +284,7 @@ static void GlobalSatPosUpdate(double time) {
         
         if (satellites.GetN() > 0) {
             g_satHelper->UpdatePositions(satellites, time);
+            UpdateIslStates(time);
         }
         
     } catch (const std::exception& e) {
@@ -107,28 +292,310 @@ static void GlobalSatPosUpdate(double time) {
     }
 }
 
+// Traffic traces feeding the end-to-end delay histogram
+static void OnTrafficTx(Ptr<const Packet> packet) {
+    if (g_rfpController) g_rfpController->GetAnalyzer().OnPacketSent(packet->GetUid());
+}
+
+static void OnTrafficRx(Ptr<const Packet> packet) {
+    if (g_rfpController) g_rfpController->GetAnalyzer().OnPacketReceived(packet->GetUid());
+}
+
+// Probe traces: the SeqTsHeader is still on the packet when Tx/Rx fire
+static void OnProbeTx(uint32_t flowId, Ptr<const Packet> packet) {
+    SeqTsHeader seqTs;
+    packet->PeekHeader(seqTs);
+    g_rfpController->GetAnalyzer().OnProbeSent(flowId, seqTs.GetSeq());
+}
+
+static void OnProbeRx(uint32_t flowId, Ptr<const Packet> packet) {
+    SeqTsHeader seqTs;
+    packet->PeekHeader(seqTs);
+    g_rfpController->GetAnalyzer().OnProbeReceived(flowId, seqTs.GetSeq(), seqTs.GetTs().GetSeconds());
+}
+
 int main(int argc, char *argv[]) {
     try {
+        SATNET_PHASE_BEGIN(TIMER_PHASE_SETUP);
         LogComponentEnable("SatnetDceQuaggaRfpConstellation", LOG_LEVEL_INFO);
         
-        SetupDceEnvironmentSafe(); // DCE enabled
-        
         double simTime = SIM_STOP;
         std::string animFile = "satnet-ospf-rfp-real-quagga.xml";
+        std::string routing = "quagga";
+        double cgrBucket = 1.0;
+        bool loadAware = false;
+        std::string gslPolicy = "elevation";
+        double minElevation = 10.0;
+        bool rangeDelay = true;
+        std::string histogramOut = "";
+        std::string histogramIn = "";
+        std::string instrumentationOut = "";
+        uint32_t numSatellites = 25;
+        uint32_t islLinks = 8;
+        std::string islTopology = "chain";
+        bool partition = false;
+        uint32_t quaggaNodes = 5;
+        std::string quaggaRegion = "first";
+        uint32_t regionHops = 1;
+        uint32_t quaggaWaveSize = 16;
+        double quaggaWaveRate = 0.0;
+        double quaggaStart = 1.0;
+        std::string dceStackProfile = "";
+        uint32_t vtyshStack = 0;
+        uint32_t zebraStack = 0;
+        uint32_t ospfdStack = 0;
+        uint32_t ospfCost = QUAGGA_DEFAULT_COST;
+        bool useQuagga = true;
+        bool headless = false;
+        std::string constellationFile = "";
+        std::string shells = "";
+        double timeScale = -1.0;
+        double probeInterval = 0.01;
+        std::string resultsPrefix = "";
+        bool resultsCompress = true;
+        std::string logLevel = "info";
+        std::string ospfProfile = "default";
+        OspfTimers ospfOverrides = OspfTimers::Unset();
+        bool tcMeasured = false;
+        bool convergenceMonitor = false;
+        double convergencePoll = CONVERGENCE_POLL_INTERVAL;
+        std::string logFile = "";
+        bool logAsync = true;
+        double predictionHorizon = 0.0;
+        double predictionMargin = PREDICTION_HORIZON_MARGIN;
         
         CommandLine cmd(__FILE__);
         cmd.AddValue("simTime", "Simulation time", simTime);
         cmd.AddValue("animFile", "File name for animation output", animFile);
+        cmd.AddValue("routing", "Route source: quagga (OSPF+RFP via DCE), model (in-simulator OSPF, no DCE) or cgr (Contact Graph Routing)", routing);
+        cmd.AddValue("cgrBucket", "CGR route table departure-time bucket (s)", cgrBucket);
+        cmd.AddValue("loadAware", "Weight ECMP next hops by link queue occupancy", loadAware);
+        cmd.AddValue("gslPolicy", "Serving satellite selection: elevation or contact (longest remaining)", gslPolicy);
+        cmd.AddValue("minElevation", "GSL elevation mask (degrees)", minElevation);
+        cmd.AddValue("results", "Write columnar binary results to <prefix>_<table>.scol", resultsPrefix);
+        cmd.AddValue("resultsCompress", "LZ4-compress the result columns", resultsCompress);
+        cmd.AddValue("probeInterval", "Interval between sequence-numbered probes (s)", probeInterval);
+        cmd.AddValue("histogramOut", "Export latency histograms to this file", histogramOut);
+        cmd.AddValue("histogramIn", "Merge latency histograms exported by previous runs", histogramIn);
+        cmd.AddValue("rangeDelay", "ISL delay from inter-satellite range (false: fixed SATELLITE_DELAY)", rangeDelay);
+        cmd.AddValue("logLevel", "Level of the components NS_LOG leaves unset: error, warn, debug, info or logic", logLevel);
+        cmd.AddValue("logFile", "Write LDM/RMM/RFP/Quagga logs to this file instead of stdout/stderr", logFile);
+        cmd.AddValue("logAsync", "Format and write logs on a background thread", logAsync);
+        cmd.AddValue("instrumentationOut", "Export hot-path counters and timers as CSV (needs SATNET_INSTRUMENTATION)", instrumentationOut);
+        cmd.AddValue("numSatellites", "Satellites of the default layout (at most NUM_PLANES * SATS_PER_PLANE)", numSatellites);
+        cmd.AddValue("constellation", "Constellation file (shell/plane lines, see core/constellation-config.h)", constellationFile);
+        cmd.AddValue("shells", "Walker shells, ';'-separated: \"pattern=delta planes=6 sats=18 phasing=1 altitude=1200 inclination=55\"", shells);
+        cmd.AddValue("timeScale", "Orbit time compression (default: ANIMATION_SPEED_FACTOR without shells, 1 with)", timeScale);
+        cmd.AddValue("islLinks", "Inter-satellite links (at most), in the order of islTopology", islLinks);
+        cmd.AddValue("islTopology", "chain (satellite i to i+1) or grid (intra-plane rings + same slot of the next plane)", islTopology);
+        cmd.AddValue("partition", "Distributed run, orbital planes split over the MPI ranks (needs SATNET_MPI, see scripts/run_partitioned.sh)", partition);
+        cmd.AddValue("quaggaNodes", "Satellites running Quagga OSPF (quaggaRegion=first)", quaggaNodes);
+        cmd.AddValue("quaggaRegion", "Satellites running Quagga: first (quaggaNodes), all, or path (ground station paths + regionHops, OSPF model elsewhere)", quaggaRegion);
+        cmd.AddValue("regionHops", "Hops around the ground station paths that also run Quagga (quaggaRegion=path)", regionHops);
+        cmd.AddValue("quaggaWaveSize", "Nodes whose daemons start together", quaggaWaveSize);
+        cmd.AddValue("quaggaWaveRate", "Daemon start rate (nodes/s, 0: DCE helper start times)", quaggaWaveRate);
+        cmd.AddValue("quaggaStart", "Start of the first daemon wave (s)", quaggaStart);
+        cmd.AddValue("dceStackProfile", "Measured stack high-water marks (\"<binary> <bytes>\" lines) sizing the DCE fibers", dceStackProfile);
+        cmd.AddValue("vtyshStack", "vtysh fiber stack (bytes, 0: profile or 64 KiB)", vtyshStack);
+        cmd.AddValue("zebraStack", "zebra fiber stack (bytes, 0: profile or QuaggaHelper's)", zebraStack);
+        cmd.AddValue("ospfdStack", "ospfd fiber stack (bytes, 0: profile or QuaggaHelper's)", ospfdStack);
+        cmd.AddValue("linkEvents", "Predicted link-down events to schedule", g_linkEvents);
+        cmd.AddValue("randomEvents", "Random ISL and T0 jitter per link-down event, drawn from --RngSeed/--RngRun", g_randomEvents);
+        cmd.AddValue("eventInterval", "Spacing between predicted link-down events (s)", g_eventInterval);
+        cmd.AddValue("predictionHorizon", "Look-ahead of the link-down predictions (s, 0: 2 x (Tc + 2dT) + predictionMargin)", predictionHorizon);
+        cmd.AddValue("predictionMargin", "Margin of the default prediction horizon (s)", predictionMargin);
+        cmd.AddValue("quagga", "Run Quagga under DCE (false: no DCE processes, vtysh simulated)", useQuagga);
+        cmd.AddValue("headless", "Do not write the NetAnim trace", headless);
+        cmd.AddValue("ospfHello", "OSPF hello interval (s, default: profile; < 1 uses fast hellos)", ospfOverrides.helloInterval);
+        cmd.AddValue("ospfDead", "OSPF dead interval (s, default: profile)", ospfOverrides.deadInterval);
+        cmd.AddValue("ospfFloodDelay", "OSPF model LSA flooding delay per hop (s, default: profile)", ospfOverrides.floodDelay);
+        cmd.AddValue("ospfLsaInterval", "OSPF minimum interval between LSAs of a router (s, default: profile)", ospfOverrides.lsaInterval);
+        cmd.AddValue("ospfSpfDelay", "OSPF delay from LSA arrival to SPF (s, default: profile)", ospfOverrides.spfDelay);
+        cmd.AddValue("ospfSpfHold", "OSPF initial SPF hold time (s, default: profile)", ospfOverrides.spfHold);
+        cmd.AddValue("ospfSpfMaxHold", "OSPF maximum SPF hold time (s, default: profile)", ospfOverrides.spfMaxHold);
+        cmd.AddValue("ospfProfile", "OSPF timers for the model and the Quagga configs: default (Quagga 0.99) or fast (sub-second hellos, SPF/LSA throttling)", ospfProfile);
+        cmd.AddValue("tcMeasured", "Derive Tc from the OSPF timers, then from the measured convergence (ignores --tc)", tcMeasured);
+        cmd.AddValue("convergenceMonitor", "Watch the routing tables from T1: flush the BFU once they match the post-failure SPF, report when Tc was too short", convergenceMonitor);
+        cmd.AddValue("convergencePoll", "Interval between two reads of the DCE forwarding tables by the convergence monitor (s)", convergencePoll);
+        cmd.AddValue("ospfCost", "OSPF cost of the ISL interfaces in the Quagga configs", ospfCost);
+        cmd.AddValue("tc", "RFP convergence time Tc (s)", GetRfpTiming().tc);
+        cmd.AddValue("dt", "RFP safety margin dT (s)", GetRfpTiming().dt);
         cmd.Parse(argc, argv);
         
+        // Before anything touches the simulator (the logger reads Simulator::Now)
+        uint32_t rank = 0;
+        uint32_t ranks = 1;
+        if (partition) {
+#ifdef SATNET_MPI
+            GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+            MpiInterface::Enable(&argc, &argv);
+            rank = MpiInterface::GetSystemId();
+            ranks = MpiInterface::GetSize();
+#else
+            std::cerr << "--partition needs a build with SATNET_MPI (SATNET_MPI=1 ./waf build, ns-3 with --enable-mpi)" << std::endl;
+            return 1;
+#endif
+        }
+        
+        SetupDceEnvironmentSafe(); // DCE enabled
+        
+        LogLevel defaultLevel;
+        if (!ParseLogLevel(logLevel, defaultLevel)) {
+            std::cerr << "Unknown log level " << logLevel << ", using info" << std::endl;
+            defaultLevel = LOG_LEVEL_INFO;
+        }
+        GetLogger().SetDefaultLevel(defaultLevel);
+        if (!logFile.empty()) {
+            GetLogger().SetOutputFile(logFile);
+        }
+        GetLogger().SetAsync(logAsync);
+        
+        OspfTimers ospfTimers;
+        if (!OspfTimers::ForProfile(ospfProfile, ospfTimers)) {
+            std::cerr << "Unknown OSPF profile " << ospfProfile << " (default or fast)" << std::endl;
+            return 1;
+        }
+        ospfTimers.Override(ospfOverrides);
+        GetRfpTiming().measuredTc = tcMeasured;
+        
+        if (GetRfpTiming().tc <= 0.0 || GetRfpTiming().dt < 0.0) {
+            std::cerr << "Invalid RFP timing: need tc > 0 and dt >= 0" << std::endl;
+            return 1;
+        }
+        
+        if (routing != "quagga" && routing != "model" && routing != "cgr") {
+            std::cerr << "Unknown routing " << routing << " (quagga, model or cgr)" << std::endl;
+            return 1;
+        }
+        bool useCgr = (routing == "cgr");
+        bool useModel = (routing == "model");
+        bool runQuagga = useQuagga && !useCgr && !useModel && !partition;
+        if (partition && useQuagga && !useCgr && !useModel) {
+            NS_LOG_WARN("DCE does not run under the distributed simulator: Quagga disabled, vtysh simulated");
+        }
+        if (runQuagga) {
+            if (ospfTimers.helloInterval < 1.0 / QUAGGA_HELLO_MULTIPLIER_MAX) {
+                std::cerr << "OSPF hello " << ospfTimers.helloInterval << "s: Quagga's fast hellos go down to "
+                          << 1.0 / QUAGGA_HELLO_MULTIPLIER_MAX << "s" << std::endl;
+                return 1;
+            }
+            // Quagga 0.99 has no LSA throttle: model and Tc bound use its fixed interval
+            if (ospfTimers.lsaInterval != OspfTimers().lsaInterval) {
+                std::cout << "OSPF LSA interval " << ospfTimers.lsaInterval << "s is OSPF model only, Quagga 0.99 uses "
+                          << OspfTimers().lsaInterval << "s" << std::endl;
+                ospfTimers.lsaInterval = OspfTimers().lsaInterval;
+            }
+        }
+        if (quaggaRegion != "first" && quaggaRegion != "all" && quaggaRegion != "path") {
+            std::cerr << "Unknown Quagga region " << quaggaRegion << " (first, all or path)" << std::endl;
+            return 1;
+        }
+        if (!dceStackProfile.empty()) {
+            std::string profileError;
+            if (!GetDceFiberPool().LoadProfile(dceStackProfile, profileError)) {
+                std::cerr << "Invalid DCE stack profile: " << profileError << std::endl;
+                return 1;
+            }
+        }
+        GetDceFiberPool().SetStackSize("vtysh", vtyshStack);
+        GetDceFiberPool().SetStackSize("zebra", zebraStack);
+        GetDceFiberPool().SetStackSize("ospfd", ospfdStack);
+        
+        // Lazy activation: the OSPF model routes the satellites outside the Quagga region
+        bool regionModel = runQuagga && quaggaRegion == "path";
+        if (islTopology != "chain" && islTopology != "grid") {
+            std::cerr << "Unknown ISL topology " << islTopology << " (chain or grid)" << std::endl;
+            return 1;
+        }
+        g_simTime = simTime;
+        
+        if (!resultsPrefix.empty() && rank == 0) {
+            GetResultsWriter().Open(resultsPrefix, resultsCompress);
+        }
+        
         g_rfpController = new SatnetOspfController();
+        g_rfpController->GetAnalyzer().SetOspfBaseline(ospfProfile + " profile, " + ospfTimers.Describe());
         g_satHelper = new SatelliteHelper();
         
-        uint32_t theoreticalSatellites = NUM_PLANES * SATS_PER_PLANE;
-        uint32_t numSatellites = std::min(theoreticalSatellites, (uint32_t)25);
+        if (!runQuagga) {
+            // No Quagga processes: route updates stay in simulation mode
+            GetVtyshState().checked = true;
+            GetVtyshState().available = false;
+        }
+        
+        if (useModel || regionModel) {
+            g_ospfModel = new OspfModel(ospfTimers);
+            g_rfpController->SetOspfModel(g_ospfModel);
+        }
+        
+        // Measured Tc is the monitor's T1-to-converged time
+        if (convergenceMonitor || tcMeasured) {
+            if (g_ospfModel || runQuagga) {
+                g_convergenceMonitor = new ConvergenceMonitor();
+                g_convergenceMonitor->SetPollInterval(convergencePoll);
+                g_rfpController->SetConvergenceMonitor(g_convergenceMonitor);
+            } else {
+                std::cerr << "--convergenceMonitor needs routing tables (OSPF model or Quagga), ignored" << std::endl;
+            }
+        }
+        
+        if (useCgr) {
+            g_topology = new TopologyModel();
+            g_cgr = new ContactGraphRouter(cgrBucket, Time(SATELLITE_DELAY).GetSeconds());
+            g_rfpController->SetRouteSource(g_cgr);
+        }
+        
+        ConstellationConfig& constellation = GetConstellation();
+        std::string constellationError;
+        if ((!constellationFile.empty() && !constellation.LoadFile(constellationFile, constellationError)) ||
+            !constellation.AddShells(shells, constellationError)) {
+            std::cerr << "Invalid constellation: " << constellationError << std::endl;
+            return 1;
+        }
+        if (timeScale > 0) {
+            constellation.SetTimeScale(timeScale);
+        }
+        
+        if (constellation.HasShells()) {
+            constellation.Build(0);
+            numSatellites = constellation.GetSatelliteCount();
+        } else {
+            uint32_t theoreticalSatellites = NUM_PLANES * SATS_PER_PLANE;
+            if (numSatellites > theoreticalSatellites) {
+                NS_LOG_WARN("numSatellites limited to the " << theoreticalSatellites << " constellation slots");
+            }
+            numSatellites = std::min(theoreticalSatellites, numSatellites);
+            constellation.Build(numSatellites);
+        }
+        constellation.Print();
+        g_numSatellites = numSatellites;
+        
+        std::vector<std::pair<uint32_t, uint32_t>>& islPairs = g_islPairs;
+        if (islTopology == "grid") {
+            constellation.GetGridLinks(islPairs);
+        } else {
+            for (uint32_t i = 0; i + 1 < numSatellites; i++) {
+                islPairs.push_back(std::make_pair(i, i + 1));
+            }
+        }
+        if (islPairs.size() > islLinks) {
+            islPairs.resize(islLinks);
+        }
+        
+        PlanePartition planePartition;
+        if (partition && !planePartition.Build(constellation, ranks)) {
+            std::cerr << ranks << " ranks for " << constellation.GetPlaneCount()
+                      << " planes: at most one rank per plane" << std::endl;
+            return 1;
+        }
+        planePartition.CountLinks(islPairs);
         
         NodeContainer satellites;
-        satellites.Create(numSatellites);
+        if (partition) {
+            planePartition.CreateSatellites(satellites);
+        } else {
+            satellites.Create(numSatellites);
+        }
         
         NodeContainer groundStations;
         groundStations.Create(GROUND_STATIONS.size());
@@ -138,21 +605,75 @@ int main(int argc, char *argv[]) {
         earthNodeContainer.Create(1);
         Ptr<Node> earthNode = earthNodeContainer.Get(0);
         
-        // DCE Manager enabled
-        
-        DceManagerHelper dceManager;
-        dceManager.SetTaskManagerAttribute("FiberManagerType", StringValue("UcontextFiberManager"));
-        dceManager.SetNetworkStack("ns3::Ns3SocketFdFactory");
-        dceManager.Install(satellites);
-        dceManager.Install(groundStations);
+        // Ground-to-satellite links follow the orbit model, handovers are predicted events
+        g_gslManager = new GroundStationLinkManager(g_satHelper, satellites, minElevation,
+            gslPolicy == "contact" ? GSL_LONGEST_CONTACT : GSL_MAX_ELEVATION);
+        g_gslManager->SetPredictedLinkDownCallback(
+            [](int linkId, int nodeA, int nodeB, double eventTime) {
+                g_rfpController->SchedulePredictableLinkDown(linkId, nodeA, nodeB, eventTime);
+            });
+        for (uint32_t i = 0; i < groundStations.GetN(); i++) {
+            g_gslManager->AddGroundStation(groundStations.Get(i), GROUND_STATIONS[i].first, GROUND_STATIONS[i].second);
+        }
+        g_gslManager->Start(0.0);
+        
+        // Satellites that get DCE and Quagga, and when their daemons start
+        QuaggaActivation activation;
+        if (runQuagga) {
+            if (quaggaRegion == "all") {
+                activation.SelectAll(numSatellites);
+            } else if (quaggaRegion == "path") {
+                std::vector<uint32_t> anchors = g_gslManager->PredictServingSatellites(0.0, simTime);
+                if (!activation.SelectRegion(numSatellites, islPairs, anchors, regionHops)) {
+                    NS_LOG_WARN("No satellite serves the ground stations: Quagga only on the ground stations");
+                }
+            } else {
+                activation.SelectFirst(numSatellites, quaggaNodes);
+            }
+            activation.ScheduleWaves(quaggaStart, quaggaWaveSize, quaggaWaveRate);
+            activation.Print(quaggaRegion, regionHops);
+        }
         
+        // DCE Manager enabled
         
         InternetStackHelper internet;
         Ipv4DceRoutingHelper ipv4DceRouting;
-        internet.SetRoutingHelper(ipv4DceRouting);
+        
+        if (runQuagga) {
+            DceManagerHelper dceManager;
+            dceManager.SetTaskManagerAttribute("FiberManagerType", StringValue("UcontextFiberManager"));
+            dceManager.SetNetworkStack("ns3::Ns3SocketFdFactory");
+            for (uint32_t sat : activation.GetOrder()) {
+                dceManager.Install(satellites.Get(sat));
+            }
+            dceManager.Install(groundStations);
+            
+            internet.SetRoutingHelper(ipv4DceRouting);
+        }
+        
         internet.Install(satellites);
         internet.Install(groundStations);
         
+        // Packets follow the RMM tables (ECMP by flow hash) ahead of the static / DCE kernel routes;
+        // Quagga satellites keep forwarding with the table zebra installs
+        g_forwarding = new SatnetForwarding();
+        g_forwarding->SetNextHopSelector([](uint32_t node, int destination, uint32_t flowHash) {
+            return g_rfpController->SelectNextHop(node, destination, flowHash);
+        });
+        g_forwarding->SetAttachmentResolver([](uint32_t node) {
+            return g_gslManager->GetServingNode(node);
+        });
+        for (uint32_t sat = 0; sat < satellites.GetN(); sat++) {
+            g_forwarding->SetTableRouted(satellites.Get(sat)->GetId(), !activation.IsActive(sat));
+            SatnetRouting::Install(satellites.Get(sat), g_forwarding);
+        }
+        for (uint32_t i = 0; i < groundStations.GetN(); i++) {
+            SatnetRouting::Install(groundStations.Get(i), g_forwarding);
+        }
+        g_rfpController->SetTableRoutedCallback([](uint32_t node) {
+            return g_forwarding->IsTableRouted(node);
+        });
+        
         MobilityHelper mobility;
         mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
         mobility.Install(satellites);
@@ -160,83 +681,281 @@ int main(int argc, char *argv[]) {
         mobility.Install(earthNodeContainer);
         
         g_satHelper->UpdatePositions(satellites, 0.0);
-        std::cout << "DEBUG: Positions updated" << std::endl;
-        
-        g_animHelper = new AnimationHelper(animFile);
-        g_animHelper->ConfigureEarth(earthNode);
-        g_animHelper->ConfigureSatellites(satellites);
-        g_animHelper->ConfigureGroundStations(groundStations);
         
-        // Enable packet tracing to visualize flows
-        g_animHelper->GetAnim()->EnablePacketMetadata(true);
+        if (!headless && rank == 0) {
+            g_animHelper = new AnimationHelper(animFile);
+            g_animHelper->ConfigureEarth(earthNode);
+            g_animHelper->ConfigureSatellites(satellites);
+            g_animHelper->ConfigureGroundStations(groundStations);
+            
+            // Enable packet tracing to visualize flows
+            g_animHelper->GetAnim()->EnablePacketMetadata(true);
+        }
         
         Ipv4AddressHelper ipv4;
         PointToPointHelper p2p;
         p2p.SetDeviceAttribute("DataRate", StringValue(P2P_RATE));
         p2p.SetChannelAttribute("Delay", StringValue(SATELLITE_DELAY));
         
-        uint32_t maxLinks = std::min(8U, numSatellites - 1);
+        if (rangeDelay) {
+            g_islHelper = new SatelliteLinkHelper(g_satHelper, numSatellites);
+        }
         
-        std::cout << "DEBUG: Creating links..." << std::endl;
-        if (numSatellites >= 2) {
-            for (uint32_t i = 0; i < maxLinks && (i + 1) < numSatellites; i++) {
-                if (i < satellites.GetN() && (i + 1) < satellites.GetN()) {
-                    NetDeviceContainer link = p2p.Install(satellites.Get(i), satellites.Get(i + 1));
-                    std::string subnet = "10.0." + std::to_string(i + 1) + ".0";
-                    ipv4.SetBase(subnet.c_str(), "255.255.255.0");
-                    ipv4.Assign(link);
+        if (partition) {
+            // Cross-rank GSLs keep their fixed delay, so it also bounds the lookahead
+            Time lookahead = Time(GROUND_TO_SAT_DELAY);
+            if (rangeDelay) {
+                lookahead = planePartition.ComputeLookahead(constellation, islPairs, lookahead);
+            } else {
+                lookahead = std::min(lookahead, Time(SATELLITE_DELAY));
+            }
+            if (g_islHelper) {
+                g_islHelper->SetRemoteDelay(lookahead);
+            }
+            planePartition.Print(rank, lookahead);
+        }
+        
+        if (loadAware) {
+            g_loadMonitor = new LinkLoadMonitor(LINK_UPDATE_INTERVAL);
+        }
+        
+        // Per-node Quagga configs; hello/dead shared with the OSPF model
+        QuaggaConfigWriter quaggaConfig(ospfTimers);
+        
+        if (g_convergenceMonitor && g_ospfModel) {
+            // RMM prefixes NodePrefix(sat), next hops of the model's last SPF
+            for (uint32_t sat = 0; sat < numSatellites; sat++) {
+                g_convergenceMonitor->AddPrefix(sat, sat);
+                g_convergenceMonitor->TrackNode(sat, false);
+            }
+            g_convergenceMonitor->SetRouteReader([](uint32_t node, uint32_t prefix) {
+                return g_ospfModel->GetNextHop(node, prefix);
+            });
+        } else if (g_convergenceMonitor) {
+            // ISL subnets, next hops of the forwarding tables zebra installs
+            g_kernelFib = new KernelFibReader();
+            for (uint32_t sat : activation.GetOrder()) {
+                g_convergenceMonitor->TrackNode(sat, true);
+            }
+            g_convergenceMonitor->SetRouteReader([](uint32_t node, uint32_t prefix) {
+                return g_kernelFib->NextHop(node, prefix);
+            });
+        }
+        
+        for (uint32_t l = 0; l < islPairs.size(); l++) {
+            uint32_t a = islPairs[l].first;
+            uint32_t b = islPairs[l].second;
+            NetDeviceContainer link = g_islHelper
+                ? g_islHelper->Install(satellites.Get(a), satellites.Get(b), a, b)
+                : p2p.Install(satellites.Get(a), satellites.Get(b));
+            
+            g_rfpController->AddLink(a, b);
+            g_islStates.push_back({link, true, std::numeric_limits<double>::infinity()});
+            if (g_loadMonitor) {
+                g_loadMonitor->AddLink(a, b, link);
+            }
+            
+            if (g_topology) {
+                int linkIndex = g_topology->AddLink(a, b);
+                g_topology->AddLinkInterval(linkIndex, 0.0, simTime);
+            }
+            std::string subnet = "10." + std::to_string((l + 1) / 256) + "." + std::to_string((l + 1) % 256) + ".0";
+            ipv4.SetBase(subnet.c_str(), "255.255.255.0");
+            Ipv4InterfaceContainer addresses = ipv4.Assign(link);
+            if (runQuagga) {
+                quaggaConfig.AddInterface(a, addresses.Get(0).second, addresses.GetAddress(0), 24, ospfCost);
+                quaggaConfig.AddInterface(b, addresses.Get(1).second, addresses.GetAddress(1), 24, ospfCost);
+            }
+            if (g_kernelFib) {
+                // The subnet is a prefix of its Quagga ends; the link only routes between two Quagga nodes
+                bool quaggaA = activation.IsActive(a);
+                bool quaggaB = activation.IsActive(b);
+                if (quaggaA && quaggaB) {
+                    g_convergenceMonitor->AddLink(a, b);
                 }
+                if (quaggaA || quaggaB) {
+                    g_kernelFib->AddAddress(addresses.GetAddress(0), a);
+                    g_kernelFib->AddAddress(addresses.GetAddress(1), b);
+                    g_kernelFib->AddPrefix(Ipv4Address(subnet.c_str()), 24);
+                    g_convergenceMonitor->AddPrefix(quaggaA ? a : b, quaggaB ? b : a);
+                }
+            } else if (g_convergenceMonitor) {
+                g_convergenceMonitor->AddLink(a, b);
             }
         }
-        std::cout << "DEBUG: Links created" << std::endl;
         
+        if (g_cgr) {
+            g_cgr->LoadContactPlan(*g_topology, 0.0, simTime);
+        }
+        
+        if (g_ospfModel) {
+            g_ospfModel->Start();
+        }
         
-        QuaggaHelper quagga;
-        std::cout << "DEBUG: QuaggaHelper created" << std::endl;
+        if (tcMeasured) {
+            // Until a convergence is measured: the timer bound across the ISL network
+            uint32_t diameter = IslHopDiameter(islPairs, numSatellites);
+            GetRfpTiming().tc = ospfTimers.ConvergenceBound(diameter);
+            std::cout << "RFP Tc from OSPF timers (" << ospfProfile << ", " << diameter << " hops): "
+                      << GetRfpTiming().tc << "s" << std::endl;
+        }
         
-        uint32_t maxQuaggaNodes = std::min(5U, numSatellites);
-        for (uint32_t i = 0; i < maxQuaggaNodes; i++) {
-            std::cout << "DEBUG: Installing Quagga on satellite " << i << std::endl;
-            quagga.EnableOspf(satellites.Get(i), "10.0.0.0/8");
-            quagga.Install(satellites.Get(i));
+        if (g_loadMonitor) {
+            g_loadMonitor->Start(SIM_START);
+            g_rfpController->EnableLoadAwareForwarding(g_loadMonitor, LINK_UPDATE_INTERVAL);
         }
         
-        for (uint32_t i = 0; i < groundStations.GetN(); i++) {
-            std::cout << "DEBUG: Installing Quagga on ground station " << i << std::endl;
-            quagga.EnableOspf(groundStations.Get(i), "192.168.0.0/16");
-            quagga.Install(groundStations.Get(i));
+        
+        if (runQuagga) {
+            QuaggaHelper quagga;
+            
+            // Ground stations (traffic endpoints) in the first wave, then the satellites in order
+            for (uint32_t i = 0; i < groundStations.GetN(); i++) {
+                quagga.EnableOspf(groundStations.Get(i), "192.168.0.0/16");
+                ApplicationContainer daemons = quagga.Install(groundStations.Get(i));
+                StartQuaggaDaemons(daemons, groundStations.Get(i), quaggaStart, quaggaWaveRate > 0.0);
+                quaggaConfig.AddNode(groundStations.Get(i)->GetId(), "gs-" + std::to_string(i), "192.168.0.0/16");
+            }
+            
+            for (uint32_t sat : activation.GetOrder()) {
+                quagga.EnableOspf(satellites.Get(sat), "10.0.0.0/8");
+                ApplicationContainer daemons = quagga.Install(satellites.Get(sat));
+                StartQuaggaDaemons(daemons, satellites.Get(sat), activation.GetStartTime(sat), quaggaWaveRate > 0.0);
+                quaggaConfig.AddNode(satellites.Get(sat)->GetId(), "sat-" + std::to_string(sat), "10.0.0.0/8");
+                if (g_ospfModel) {
+                    g_ospfModel->SetExternalRouter(satellites.Get(sat)->GetId());
+                }
+            }
+            SATNET_COUNT(COUNTER_DCE_PROCESSES, (activation.GetActiveCount() + groundStations.GetN()) * QUAGGA_DAEMONS_PER_NODE);
+            
+            // Replaces the helper's generic files: the daemons start fully configured
+            std::string configError;
+            if (!quaggaConfig.Render(configError)) {
+                std::cerr << "Quagga config generation failed: " << configError << std::endl;
+                return 1;
+            }
+            quaggaConfig.Print();
         }
-        std::cout << "DEBUG: Quagga installed" << std::endl;
         
         
         // Use standard static routing or OLSR as fallback if needed, but for now just basic stack
         // Ipv4GlobalRoutingHelper::PopulateRoutingTables();
         
-        TrafficGenerator::Install(groundStations, UDP_PORT, SIM_START, SIM_STOP);
-        
-        Simulator::Schedule(Seconds(2.0), &CreatePredictableLinkEvents);
+        // Applications only on the rank that owns the ground stations
+        if (rank == 0) {
+            // GS-0's stable address: its GSL addresses go down at each handover
+            Ipv4Address server = g_gslManager->GetStationAddress(0);
+            TrafficGenerator::Install(groundStations, server, UDP_PORT, SIM_START, SIM_STOP);
+            Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::UdpEchoClient/Tx",
+                                          MakeCallback(&OnTrafficTx));
+            Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::UdpEchoServer/Rx",
+                                          MakeCallback(&OnTrafficRx));
+        
+            ApplicationContainer probeClients, probeServers;
+            TrafficGenerator::InstallProbes(groundStations, server, UDP_PORT + 1, SIM_START, SIM_STOP, probeInterval,
+                                            probeClients, probeServers);
+            for (uint32_t i = 0; i < probeClients.GetN(); i++) {
+                uint32_t flowId = g_rfpController->GetAnalyzer().AddProbeFlow(probeInterval);
+                probeClients.Get(i)->TraceConnectWithoutContext("Tx", MakeBoundCallback(&OnProbeTx, flowId));
+                probeServers.Get(i)->TraceConnectWithoutContext("Rx", MakeBoundCallback(&OnProbeRx, flowId));
+            }
+        }
         
-        // Frequent update for smooth animation (0.1s)
-        for (double t = 0.0; t <= simTime; t += 0.1) {
-            Simulator::Schedule(Seconds(t), &GlobalSatPosUpdate, t);
+        // Link-downs are predicted one window ahead, from t=2s to the end of the run
+        if (g_islPairs.empty()) {
+            NS_LOG_ERROR("No ISL to schedule link events on");
         }
+        g_predictionHorizon = new PredictionHorizon(predictionHorizon, predictionMargin);
+        g_predictionHorizon->SetTransitionSource(&CollectPlannedLinkDowns);
+        g_predictionHorizon->SetPredictionCallback(&SchedulePredictedLinkDowns);
+        g_predictionHorizon->Start(2.0, simTime);
+        
+        if (useCgr) {
+            // Initial CGR routes, later changes are pushed by the controller at each T1
+            Simulator::Schedule(Seconds(SIM_START), &SatnetOspfController::RefreshRoutes, g_rfpController, SIM_START);
+        }
+        
+        // Frequent update for smooth animation, each update schedules the next
+        Simulator::Schedule(Seconds(0.0), &GlobalSatPosUpdate, 0u);
         
         Simulator::Stop(Seconds(simTime));
+        SATNET_PHASE_END(TIMER_PHASE_SETUP);
+        SATNET_PHASE_BEGIN(TIMER_PHASE_RUN);
         Simulator::Run();
-        
-        if (g_rfpController) {
+        SATNET_PHASE_END(TIMER_PHASE_RUN);
+        SATNET_COUNT(COUNTER_SIM_EVENTS, Simulator::GetEventCount());
+        SATNET_PHASE_BEGIN(TIMER_PHASE_REPORT);
+        
+        // Traffic and probes run on rank 0: the other ranks only report their ISLs
+        if (g_rfpController && rank == 0) {
+            if (!histogramIn.empty()) {
+                g_rfpController->GetAnalyzer().MergeHistograms(histogramIn);
+            }
             g_rfpController->PrintFinalStatistics();
+            if (!histogramOut.empty()) {
+                g_rfpController->GetAnalyzer().ExportHistograms(histogramOut);
+            }
+            g_rfpController->GetAnalyzer().WriteResults(GetResultsWriter());
+        }
+        GetResultsWriter().Close();
+        if (g_cgr) {
+            g_cgr->PrintStatistics();
+        }
+        if (g_ospfModel && rank == 0) {
+            g_ospfModel->PrintStatistics();
+        }
+        if (runQuagga) {
+            GetDceFiberPool().PrintStatistics();
+        }
+        if (g_convergenceMonitor && rank == 0) {
+            g_convergenceMonitor->PrintStatistics();
+        }
+        if (g_forwarding && rank == 0) {
+            g_forwarding->PrintStatistics();
+        }
+        if (rank == 0) {
+            g_predictionHorizon->PrintStatistics();
+        }
+        if (rank == 0) {
+            g_gslManager->PrintStatistics();
+        } else {
+            std::cout << "Rank " << rank << ": " << Simulator::GetEventCount() << " events" << std::endl;
+        }
+        if (g_islHelper) {
+            g_islHelper->PrintStatistics();
+        }
+        
+        SATNET_PHASE_END(TIMER_PHASE_REPORT);
+        if (!instrumentationOut.empty()) {
+            GetInstrumentation().ExportCsv(rank == 0 ? instrumentationOut
+                                                     : instrumentationOut + ".rank" + std::to_string(rank));
         }
         
         Simulator::Destroy();
+        GetLogger().Shutdown();
+#ifdef SATNET_MPI
+        if (partition) {
+            MpiInterface::Disable();
+        }
+#endif
         
         delete g_rfpController;
         delete g_satHelper;
         delete g_animHelper;
+        delete g_cgr;
+        delete g_ospfModel;
+        delete g_convergenceMonitor;
+        delete g_kernelFib;
+        delete g_predictionHorizon;
+        delete g_loadMonitor;
+        delete g_gslManager;
+        delete g_islHelper;
+        delete g_topology;
         
         return 0;
         
     } catch (const std::exception& e) {
+        GetLogger().Flush();
         std::cerr << "CRITICAL ERROR: " << e.what() << std::endl;
         return 1;
     }
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Scaling benchmark driver for the RFP scenario (satnet-rfp)
+ *
+ * Runs satnet-rfp once per (mode, constellation size, event density) in a child
+ * process and writes one CSV row per run: wall-clock, simulated seconds per
+ * second, scheduler events, peak RSS and DCE processes started.
+ *
+ *   ./waf --run "satnet-rfp-scaling --sizes=10,25,50,108 --densities=6,24,96 --csv=scaling.csv"
+ *
+ * Modes: headless (Quagga under DCE on every satellite, no NetAnim trace) and
+ * noquagga (no DCE processes, vtysh simulated). Events and DCE processes are read
+ * back from the instrumentation CSV of the child (satnet-rfp is built with
+ * SATNET_INSTRUMENTATION), peak RSS from its rusage.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "ns3/core-module.h"
+
+#include "helpers/child-process.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("SatnetRfpScaling");
+
+struct ScalingRun {
+    std::string mode;
+    uint32_t satellites;
+    uint32_t linkEvents;
+    double simTime;
+    int status;
+    double wallSeconds;
+    double runSeconds;          // Simulator::Run only
+    uint64_t events;
+    uint64_t peakRssKb;
+    uint64_t dceProcesses;
+    uint64_t vtyshSpawned;
+};
+
+static std::vector<std::string> SplitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+/**
+ * Reads the instrumentation CSV of a run (subsystem,name,kind,calls,total_ns,...)
+ */
+static void ReadInstrumentation(const std::string& filename, ScalingRun& run) {
+    std::ifstream in(filename);
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields = SplitList(line);
+        if (fields.size() < 5) continue;
+        std::string key = fields[0] + "." + fields[1];
+        uint64_t calls = std::stoull(fields[3]);
+        if (key == "Simulator.events") run.events = calls;
+        else if (key == "DCE.processes") run.dceProcesses = calls;
+        else if (key == "Quagga.vtysh_spawned") run.vtyshSpawned = calls;
+        else if (key == "Simulator.Run") run.runSeconds = std::stoull(fields[4]) / 1e9;
+    }
+}
+
+static ScalingRun RunScenario(const std::string& binary, const std::string& mode, uint32_t satellites,
+                              uint32_t linkEvents, double simTime, const std::string& logDir) {
+    ScalingRun run = {mode, satellites, linkEvents, simTime, 0, 0.0, 0.0, 0, 0, 0, 0};
+    std::string tag = mode + "-" + std::to_string(satellites) + "-" + std::to_string(linkEvents);
+    std::string instrumentationFile = "/tmp/satnet-scaling-" + std::to_string(getpid()) + "-" + tag + ".csv";
+
+    // Link events are spread between t=10s and simTime-15s (see CollectPlannedLinkDowns)
+    double eventInterval = linkEvents > 0 ? (simTime - 25.0) / (linkEvents + 1) : simTime;
+
+    std::vector<std::string> args = {
+        "--simTime=" + std::to_string(simTime),
+        "--numSatellites=" + std::to_string(satellites),
+        "--islLinks=" + std::to_string(satellites > 0 ? satellites - 1 : 0),
+        "--quaggaNodes=" + std::to_string(satellites),
+        "--linkEvents=" + std::to_string(linkEvents),
+        "--eventInterval=" + std::to_string(eventInterval),
+        "--quagga=" + std::string(mode == "noquagga" ? "false" : "true"),
+        "--headless=true",
+        "--logLevel=warn",
+        "--instrumentationOut=" + instrumentationFile
+    };
+
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    auto start = std::chrono::steady_clock::now();
+    run.status = RunChildProcess(binary, args, logDir.empty() ? "" : logDir + "/" + tag + ".log", usage);
+    run.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    run.peakRssKb = usage.ru_maxrss;        // kilobytes on Linux
+
+    ReadInstrumentation(instrumentationFile, run);
+    std::remove(instrumentationFile.c_str());
+    return run;
+}
+
+int main(int argc, char* argv[]) {
+    std::string binary = SiblingExecutable(argv[0], "satnet-rfp");
+    std::string sizes = "10,25,50,108";
+    std::string densities = "6,24,96";
+    std::string modes = "headless,noquagga";
+    double simTime = 60.0;
+    std::string csv = "satnet-scaling.csv";
+    std::string logDir = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("binary", "satnet-rfp executable", binary);
+    cmd.AddValue("sizes", "Comma-separated constellation sizes (satellites)", sizes);
+    cmd.AddValue("densities", "Comma-separated predicted link-down event counts", densities);
+    cmd.AddValue("modes", "Comma-separated modes: headless, noquagga", modes);
+    cmd.AddValue("simTime", "Simulated time per run (s)", simTime);
+    cmd.AddValue("csv", "Summary CSV", csv);
+    cmd.AddValue("logDir", "Keep the output of every run in <logDir>/<mode>-<size>-<events>.log", logDir);
+    cmd.Parse(argc, argv);
+
+    std::ofstream out(csv);
+    if (!out) {
+        std::cerr << "Error: cannot open " << csv << std::endl;
+        return 1;
+    }
+    out << "mode,satellites,link_events,sim_time,status,wall_s,run_s,sim_s_per_s,events,events_per_s,"
+        << "peak_rss_kb,dce_processes,vtysh_spawned" << std::endl;
+
+    int failures = 0;
+    for (const std::string& mode : SplitList(modes)) {
+        if (mode != "headless" && mode != "noquagga") {
+            std::cerr << "Unknown mode " << mode << ", skipped" << std::endl;
+            continue;
+        }
+        for (const std::string& size : SplitList(sizes)) {
+            for (const std::string& density : SplitList(densities)) {
+                ScalingRun run = RunScenario(binary, mode, std::stoul(size), std::stoul(density), simTime, logDir);
+                double runSeconds = run.runSeconds > 0.0 ? run.runSeconds : run.wallSeconds;
+                double simRate = simTime / runSeconds;
+                double eventRate = run.events / runSeconds;
+
+                out << run.mode << "," << run.satellites << "," << run.linkEvents << "," << run.simTime << ","
+                    << run.status << "," << run.wallSeconds << "," << run.runSeconds << "," << simRate << ","
+                    << run.events << "," << eventRate << "," << run.peakRssKb << ","
+                    << run.dceProcesses << "," << run.vtyshSpawned << std::endl;
+
+                std::cout << mode << " sats=" << run.satellites << " events=" << run.linkEvents
+                          << " wall=" << run.wallSeconds << "s sim/s=" << simRate
+                          << " sched=" << run.events << " rss=" << run.peakRssKb / 1024 << "MB"
+                          << " dce=" << run.dceProcesses
+                          << (run.status != 0 ? " FAILED (status " + std::to_string(run.status) + ")" : "")
+                          << std::endl;
+                if (run.status != 0) failures++;
+            }
+        }
+    }
+
+    std::cout << "Scaling summary written to " << csv << std::endl;
+    return failures > 0 ? 1 : 0;
+}
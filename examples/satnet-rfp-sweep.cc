@@ -0,0 +1,450 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Monte Carlo sweep of the RFP margins (Tc, dT) over satnet-rfp runs
+ *
+ * Every (Tc, dT, constellation size, event density, seed) is an independent
+ * satnet-rfp process (the seed is its --RngRun: with --randomEvents each replicate takes
+ * down other ISLs at jittered times); at most --jobs run at once. As runs finish their latency
+ * histograms are merged per (Tc, dT, size, density) and summary.csv is rewritten.
+ *
+ *   ./waf --run "satnet-rfp-sweep --tc=1,2,4 --dt=0.1,0.5,1 --seeds=1,2,3,4 --outDir=sweep"
+ *   ./waf --run "satnet-rfp-sweep --sampling=random --samples=200 --tc=0.5,4 --dt=0.05,1"
+ *
+ * Grid sampling takes the cartesian product of the lists. Random sampling draws
+ * Tc and dT uniformly between the min and max of their lists and the size,
+ * density and seed from their lists (reproducible from --sampleSeed).
+ *
+ * Resuming: finished runs are appended to <outDir>/runs.csv. Restarting skips the
+ * ones that are part of the current sweep and rebuilds their aggregates from their
+ * histograms (other runs of the manifest are ignored); failed or interrupted runs
+ * are run again.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+#include "ns3/core-module.h"
+
+#include "helpers/child-process.h"
+#include "modules/latency-histogram.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("SatnetRfpSweep");
+
+// Histograms exported by PerformanceAnalyzer::ExportHistograms, in summary column order
+const char* const SWEEP_HISTOGRAMS[] = {
+    "rfp_outage", "rfp_measured_outage", "rfp_detection", "t2_flush",
+    "ospf_outage", "ospf_measured_outage", "ospf_detection", "packet_delay", "probe_delay"
+};
+const uint32_t SWEEP_HISTOGRAM_COUNT = sizeof(SWEEP_HISTOGRAMS) / sizeof(SWEEP_HISTOGRAMS[0]);
+
+struct SweepJob {
+    double tc;
+    double dt;
+    uint32_t satellites;
+    uint32_t linkEvents;
+    uint32_t seed;
+
+    /**
+     * Configuration key: every parameter except the seed
+     */
+    std::string ConfigKey() const {
+        std::ostringstream key;
+        key << "tc" << tc << "_dt" << dt << "_n" << satellites << "_e" << linkEvents;
+        return key.str();
+    }
+
+    std::string Key() const {
+        return ConfigKey() + "_s" + std::to_string(seed);
+    }
+};
+
+struct SweepAggregate {
+    SweepJob config;
+    uint32_t runs;
+    uint32_t failed;
+    std::vector<std::unique_ptr<LatencyHistogram>> histograms;    // SWEEP_HISTOGRAMS order
+
+    explicit SweepAggregate(const SweepJob& job) : config(job), runs(0), failed(0) {
+        for (uint32_t i = 0; i < SWEEP_HISTOGRAM_COUNT; i++) {
+            histograms.emplace_back(new LatencyHistogram());
+        }
+    }
+};
+
+struct RunningJob {
+    SweepJob job;
+    std::chrono::steady_clock::time_point start;
+};
+
+static std::vector<std::string> SplitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static std::vector<double> ParseDoubles(const std::string& text) {
+    std::vector<double> values;
+    for (const std::string& item : SplitList(text)) values.push_back(std::stod(item));
+    return values;
+}
+
+static std::vector<uint32_t> ParseUints(const std::string& text) {
+    std::vector<uint32_t> values;
+    for (const std::string& item : SplitList(text)) values.push_back(std::stoul(item));
+    return values;
+}
+
+class SweepRunner {
+private:
+    std::string m_binary;
+    std::string m_outDir;
+    double m_simTime;
+    bool m_quagga;
+
+    std::map<std::string, std::unique_ptr<SweepAggregate>> m_aggregates;
+    std::ofstream m_manifest;
+    uint32_t m_completed;
+    uint32_t m_failed;
+
+    std::string RunPath(const SweepJob& job, const std::string& extension) const {
+        return m_outDir + "/runs/" + job.Key() + extension;
+    }
+
+    std::vector<std::string> Arguments(const SweepJob& job) const {
+        // Link events spread between t=10s and simTime-15s (see CollectPlannedLinkDowns)
+        double eventInterval = job.linkEvents > 0 ? (m_simTime - 25.0) / (job.linkEvents + 1) : m_simTime;
+        std::ostringstream tc, dt;
+        tc << job.tc;
+        dt << job.dt;
+        return {
+            "--tc=" + tc.str(),
+            "--dt=" + dt.str(),
+            "--simTime=" + std::to_string(m_simTime),
+            "--numSatellites=" + std::to_string(job.satellites),
+            "--islLinks=" + std::to_string(job.satellites > 0 ? job.satellites - 1 : 0),
+            "--quaggaNodes=" + std::to_string(job.satellites),
+            "--linkEvents=" + std::to_string(job.linkEvents),
+            "--eventInterval=" + std::to_string(eventInterval),
+            "--quagga=" + std::string(m_quagga ? "true" : "false"),
+            "--headless=true",
+            "--logLevel=warn",
+            "--randomEvents=true",
+            "--RngRun=" + std::to_string(job.seed),
+            "--histogramOut=" + RunPath(job, ".hist")
+        };
+    }
+
+    SweepAggregate& GetAggregate(const SweepJob& job) {
+        std::unique_ptr<SweepAggregate>& aggregate = m_aggregates[job.ConfigKey()];
+        if (!aggregate) aggregate.reset(new SweepAggregate(job));
+        return *aggregate;
+    }
+
+    /**
+     * Merges the histograms of a finished run into its configuration
+     */
+    bool MergeRun(const SweepJob& job) {
+        std::ifstream in(RunPath(job, ".hist"));
+        if (!in) return false;
+
+        SweepAggregate& aggregate = GetAggregate(job);
+        std::string name;
+        std::unique_ptr<LatencyHistogram> imported(new LatencyHistogram());
+        while (imported->Import(in, name)) {
+            for (uint32_t i = 0; i < SWEEP_HISTOGRAM_COUNT; i++) {
+                if (name == SWEEP_HISTOGRAMS[i]) aggregate.histograms[i]->Merge(*imported);
+            }
+            imported->Reset();
+        }
+        aggregate.runs++;
+        return true;
+    }
+
+    void WriteAggregate(const SweepAggregate& aggregate) const {
+        std::ofstream out(m_outDir + "/aggregate/" + aggregate.config.ConfigKey() + ".hist");
+        for (uint32_t i = 0; i < SWEEP_HISTOGRAM_COUNT; i++) {
+            aggregate.histograms[i]->Export(out, SWEEP_HISTOGRAMS[i]);
+        }
+    }
+
+    /**
+     * Rewrites summary.csv (written aside then renamed, readable while the sweep runs)
+     */
+    void WriteSummary() const {
+        std::string path = m_outDir + "/summary.csv";
+        std::ofstream out(path + ".tmp");
+        out << "tc,dt,satellites,link_events,runs,failed";
+        for (uint32_t i = 0; i < SWEEP_HISTOGRAM_COUNT; i++) {
+            std::string name = SWEEP_HISTOGRAMS[i];
+            out << "," << name << "_count," << name << "_mean_ms," << name << "_p50_ms,"
+                << name << "_p99_ms," << name << "_max_ms";
+        }
+        out << std::endl;
+
+        for (const auto& entry : m_aggregates) {
+            const SweepAggregate& aggregate = *entry.second;
+            out << aggregate.config.tc << "," << aggregate.config.dt << "," << aggregate.config.satellites << ","
+                << aggregate.config.linkEvents << "," << aggregate.runs << "," << aggregate.failed;
+            for (uint32_t i = 0; i < SWEEP_HISTOGRAM_COUNT; i++) {
+                const LatencyHistogram& histogram = *aggregate.histograms[i];
+                out << "," << histogram.GetTotalCount() << "," << histogram.GetMean() << ","
+                    << histogram.GetPercentile(50.0) << "," << histogram.GetPercentile(99.0) << ","
+                    << histogram.GetMax();
+            }
+            out << std::endl;
+        }
+        out.close();
+        std::rename((path + ".tmp").c_str(), path.c_str());
+    }
+
+    void Finish(const SweepJob& job, int status, double wallSeconds) {
+        if (status == 0 && !MergeRun(job)) {
+            std::cerr << "Run " << job.Key() << " exported no histograms" << std::endl;
+            status = -1;
+        }
+
+        if (status == 0) {
+            m_completed++;
+            WriteAggregate(GetAggregate(job));
+        } else {
+            m_failed++;
+            GetAggregate(job).failed++;
+        }
+
+        // Manifest line last: a run counts as done only once its histograms are merged
+        m_manifest << job.Key() << "," << job.tc << "," << job.dt << "," << job.satellites << ","
+                   << job.linkEvents << "," << job.seed << "," << status << "," << wallSeconds << std::endl;
+        WriteSummary();
+
+        std::cout << (status == 0 ? "done   " : "FAILED ") << job.Key() << " (" << wallSeconds << "s"
+                  << (status != 0 ? ", status " + std::to_string(status) + ", see " + RunPath(job, ".log") : "")
+                  << ")" << std::endl;
+    }
+
+public:
+    SweepRunner(const std::string& binary, const std::string& outDir, double simTime, bool quagga)
+        : m_binary(binary), m_outDir(outDir), m_simTime(simTime), m_quagga(quagga),
+          m_completed(0), m_failed(0) {}
+
+    /**
+     * Creates the output directories and reloads the runs of this sweep (keys) finished by
+     * a previous invocation. Returns the keys of the finished runs
+     */
+    std::set<std::string> Resume(const std::set<std::string>& keys) {
+        mkdir(m_outDir.c_str(), 0755);
+        mkdir((m_outDir + "/runs").c_str(), 0755);
+        mkdir((m_outDir + "/aggregate").c_str(), 0755);
+
+        std::set<std::string> finished;
+        std::string manifestPath = m_outDir + "/runs.csv";
+        std::ifstream in(manifestPath);
+        std::string line;
+        bool existing = static_cast<bool>(std::getline(in, line));
+        while (std::getline(in, line)) {
+            std::vector<std::string> fields = SplitList(line);
+            if (fields.size() != 8 || fields[6] != "0") continue;     // failed or torn line: run again
+
+            SweepJob job = {std::stod(fields[1]), std::stod(fields[2]), (uint32_t)std::stoul(fields[3]),
+                            (uint32_t)std::stoul(fields[4]), (uint32_t)std::stoul(fields[5])};
+            if (keys.count(job.Key()) && finished.count(job.Key()) == 0 && MergeRun(job)) {
+                finished.insert(job.Key());
+                m_completed++;
+            }
+        }
+        in.close();
+
+        m_manifest.open(manifestPath, std::ios::app);
+        if (!existing) {
+            m_manifest << "key,tc,dt,satellites,link_events,seed,status,wall_s" << std::endl;
+        }
+        if (!finished.empty()) {
+            std::cout << "Resuming: " << finished.size() << " runs already finished" << std::endl;
+        }
+        return finished;
+    }
+
+    bool IsOpen() const { return m_manifest.is_open(); }
+
+    /**
+     * Runs the jobs with at most maxJobs child processes at a time
+     */
+    void Run(std::deque<SweepJob>& pending, uint32_t maxJobs) {
+        std::map<pid_t, RunningJob> running;
+        uint32_t total = pending.size();
+
+        while (!pending.empty() || !running.empty()) {
+            while (!pending.empty() && running.size() < maxJobs) {
+                SweepJob job = pending.front();
+                pending.pop_front();
+                pid_t pid = StartChildProcess(m_binary, Arguments(job), RunPath(job, ".log"));
+                if (pid < 0) {
+                    Finish(job, -1, 0.0);
+                    continue;
+                }
+                running[pid] = RunningJob{job, std::chrono::steady_clock::now()};
+            }
+            if (running.empty()) break;
+
+            int status = 0;
+            struct rusage usage;
+            pid_t pid = wait4(-1, &status, 0, &usage);
+            if (pid < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Error: wait4 failed: " << strerror(errno) << std::endl;
+                break;
+            }
+            auto it = running.find(pid);
+            if (it == running.end()) continue;
+
+            double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - it->second.start).count();
+            SweepJob job = it->second.job;
+            running.erase(it);
+            Finish(job, ChildExitCode(status), wallSeconds);
+            std::cout << "   " << (total - pending.size() - running.size()) << "/" << total
+                      << " runs, " << running.size() << " running" << std::endl;
+        }
+
+        WriteSummary();
+        std::cout << "Sweep finished: " << m_completed << " runs completed, " << m_failed << " failed, "
+                  << m_aggregates.size() << " configurations in " << m_outDir << "/summary.csv" << std::endl;
+    }
+
+    uint32_t GetFailedCount() const { return m_failed; }
+};
+
+/**
+ * Grid sampling: cartesian product of the parameter lists
+ */
+static std::vector<SweepJob> GridJobs(const std::vector<double>& tcs, const std::vector<double>& dts,
+                                      const std::vector<uint32_t>& sizes, const std::vector<uint32_t>& densities,
+                                      const std::vector<uint32_t>& seeds) {
+    std::vector<SweepJob> jobs;
+    for (double tc : tcs)
+        for (double dt : dts)
+            for (uint32_t size : sizes)
+                for (uint32_t density : densities)
+                    for (uint32_t seed : seeds)
+                        jobs.push_back(SweepJob{tc, dt, size, density, seed});
+    return jobs;
+}
+
+/**
+ * Random sampling: Tc and dT uniform in [min, max] of their lists, the rest picked from the lists
+ * Tc and dT are rounded to the millisecond so the run keys stay stable across resumes
+ */
+static std::vector<SweepJob> RandomJobs(uint32_t samples, uint32_t sampleSeed,
+                                        const std::vector<double>& tcs, const std::vector<double>& dts,
+                                        const std::vector<uint32_t>& sizes, const std::vector<uint32_t>& densities,
+                                        const std::vector<uint32_t>& seeds) {
+    std::mt19937 rng(sampleSeed);
+    std::uniform_real_distribution<double> tc(*std::min_element(tcs.begin(), tcs.end()),
+                                              *std::max_element(tcs.begin(), tcs.end()));
+    std::uniform_real_distribution<double> dt(*std::min_element(dts.begin(), dts.end()),
+                                              *std::max_element(dts.begin(), dts.end()));
+    std::uniform_int_distribution<size_t> size(0, sizes.size() - 1);
+    std::uniform_int_distribution<size_t> density(0, densities.size() - 1);
+    std::uniform_int_distribution<size_t> seed(0, seeds.size() - 1);
+
+    std::vector<SweepJob> jobs;
+    for (uint32_t i = 0; i < samples; i++) {
+        jobs.push_back(SweepJob{std::round(tc(rng) * 1000.0) / 1000.0, std::round(dt(rng) * 1000.0) / 1000.0,
+                                sizes[size(rng)], densities[density(rng)], seeds[seed(rng)]});
+    }
+    return jobs;
+}
+
+int main(int argc, char* argv[]) {
+    std::string binary = SiblingExecutable(argv[0], "satnet-rfp");
+    std::string outDir = "satnet-sweep";
+    std::string sampling = "grid";
+    std::string tcList = "1,2,3";
+    std::string dtList = "0.25,0.5,1";
+    std::string sizeList = "25";
+    std::string densityList = "6";
+    std::string seedList = "1,2,3";
+    uint32_t samples = 100;
+    uint32_t sampleSeed = 1;
+    uint32_t maxJobs = std::max(1u, std::thread::hardware_concurrency());
+    double simTime = 60.0;
+    bool quagga = true;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("binary", "satnet-rfp executable", binary);
+    cmd.AddValue("outDir", "Output directory (runs/, aggregate/, runs.csv, summary.csv)", outDir);
+    cmd.AddValue("sampling", "grid (cartesian product) or random", sampling);
+    cmd.AddValue("tc", "Comma-separated Tc values (random: min and max)", tcList);
+    cmd.AddValue("dt", "Comma-separated dT values (random: min and max)", dtList);
+    cmd.AddValue("sizes", "Comma-separated constellation sizes (satellites)", sizeList);
+    cmd.AddValue("densities", "Comma-separated predicted link-down event counts", densityList);
+    cmd.AddValue("seeds", "Comma-separated ns-3 run numbers (RngRun)", seedList);
+    cmd.AddValue("samples", "Number of random samples", samples);
+    cmd.AddValue("sampleSeed", "Seed of the random sampling", sampleSeed);
+    cmd.AddValue("jobs", "Simulations running at once", maxJobs);
+    cmd.AddValue("simTime", "Simulated time per run (s)", simTime);
+    cmd.AddValue("quagga", "Run Quagga under DCE (false: vtysh simulated)", quagga);
+    cmd.Parse(argc, argv);
+
+    std::vector<double> tcs = ParseDoubles(tcList);
+    std::vector<double> dts = ParseDoubles(dtList);
+    std::vector<uint32_t> sizes = ParseUints(sizeList);
+    std::vector<uint32_t> densities = ParseUints(densityList);
+    std::vector<uint32_t> seeds = ParseUints(seedList);
+    if (tcs.empty() || dts.empty() || sizes.empty() || densities.empty() || seeds.empty()) {
+        std::cerr << "Error: every parameter list needs at least one value" << std::endl;
+        return 1;
+    }
+
+    std::vector<SweepJob> jobs;
+    if (sampling == "grid") {
+        jobs = GridJobs(tcs, dts, sizes, densities, seeds);
+    } else if (sampling == "random") {
+        jobs = RandomJobs(samples, sampleSeed, tcs, dts, sizes, densities, seeds);
+    } else {
+        std::cerr << "Error: unknown sampling " << sampling << " (grid or random)" << std::endl;
+        return 1;
+    }
+
+    std::set<std::string> keys;
+    for (const SweepJob& job : jobs) keys.insert(job.Key());
+
+    SweepRunner runner(binary, outDir, simTime, quagga);
+    std::set<std::string> finished = runner.Resume(keys);
+    if (!runner.IsOpen()) {
+        std::cerr << "Error: cannot write " << outDir << "/runs.csv" << std::endl;
+        return 1;
+    }
+
+    std::deque<SweepJob> pending;
+    std::set<std::string> queued;
+    for (const SweepJob& job : jobs) {
+        if (finished.count(job.Key()) || queued.count(job.Key())) continue;
+        queued.insert(job.Key());
+        pending.push_back(job);
+    }
+    std::cout << jobs.size() << " runs in the sweep, " << pending.size() << " to run on "
+              << maxJobs << " jobs" << std::endl;
+
+    runner.Run(pending, std::max(1u, maxJobs));
+    return runner.GetFailedCount() > 0 ? 1 : 0;
+}
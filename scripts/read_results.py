@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Load the columnar .scol result files written by ResultsWriter.
+
+    python3 scripts/read_results.py run1_link_events.scol [run2_link_events.scol ...]
+
+Returns/prints one dict of columns per file (numpy arrays when numpy is
+available). LZ4 columns use the `lz4` package when installed and fall back to
+a pure Python block decoder otherwise.
+"""
+import struct
+import sys
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+try:
+    import lz4.block as lz4block
+except ImportError:
+    lz4block = None
+
+COLUMN_FORMATS = {1: "B", 2: "i", 3: "I", 4: "Q", 5: "d"}
+COLUMN_STRING = 6
+CHUNK_MAGIC = 0x4B4E4843
+
+
+def lz4_decompress(data, raw_size):
+    if lz4block is not None:
+        return lz4block.decompress(data, uncompressed_size=raw_size)
+
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        length = token >> 4
+        if length == 15:
+            while True:
+                extra = data[pos]
+                pos += 1
+                length += extra
+                if extra != 255:
+                    break
+        out += data[pos:pos + length]
+        pos += length
+        if pos >= len(data):
+            break
+        offset = data[pos] | (data[pos + 1] << 8)
+        pos += 2
+        length = (token & 15) + 4
+        if (token & 15) == 15:
+            while True:
+                extra = data[pos]
+                pos += 1
+                length += extra
+                if extra != 255:
+                    break
+        start = len(out) - offset
+        for i in range(length):
+            out.append(out[start + i])
+    return bytes(out)
+
+
+def decode_column(column_type, raw, rows):
+    if column_type == COLUMN_STRING:
+        values, pos = [], 0
+        for _ in range(rows):
+            (length,) = struct.unpack_from("<I", raw, pos)
+            values.append(raw[pos + 4:pos + 4 + length].decode())
+            pos += 4 + length
+        return values
+    fmt = COLUMN_FORMATS[column_type]
+    if np is not None:
+        return np.frombuffer(raw, dtype=np.dtype("<" + fmt)).copy()
+    return list(struct.unpack("<%d%s" % (rows, fmt), raw))
+
+
+def read_table(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if data[:8] != b"SATCOL01":
+        raise ValueError("%s: not a SATCOL01 file" % path)
+    pos = 9
+    (name_length,) = struct.unpack_from("<H", data, pos)
+    table = data[pos + 2:pos + 2 + name_length].decode()
+    pos += 2 + name_length
+    (column_count,) = struct.unpack_from("<I", data, pos)
+    pos += 4
+
+    columns = []
+    for _ in range(column_count):
+        column_type, name_length = struct.unpack_from("<BH", data, pos)
+        columns.append((data[pos + 3:pos + 3 + name_length].decode(), column_type))
+        pos += 3 + name_length
+
+    parts = {name: [] for name, _ in columns}
+    while pos < len(data):
+        magic, rows = struct.unpack_from("<II", data, pos)
+        if magic != CHUNK_MAGIC:
+            raise ValueError("%s: corrupt chunk at offset %d" % (path, pos))
+        pos += 8
+        for name, column_type in columns:
+            compressed, raw_size, stored_size = struct.unpack_from("<BII", data, pos)
+            pos += 9
+            stored = data[pos:pos + stored_size]
+            pos += stored_size
+            raw = lz4_decompress(stored, raw_size) if compressed else stored
+            parts[name].append(decode_column(column_type, raw, rows))
+
+    result = {}
+    for name, column_type in columns:
+        chunks = parts[name]
+        if np is not None and column_type != COLUMN_STRING:
+            result[name] = np.concatenate(chunks) if chunks else np.array([])
+        else:
+            result[name] = [v for chunk in chunks for v in chunk]
+    return table, result
+
+
+def main(paths):
+    for path in paths:
+        table, columns = read_table(path)
+        rows = len(next(iter(columns.values()))) if columns else 0
+        print("%s: table %s, %d rows" % (path, table, rows))
+        for name, values in columns.items():
+            print("   %-20s %s" % (name, list(values[:5])))
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,37 @@
+#!/bin/bash
+# Partitioned run of satnet-rfp on one machine: orbital planes split over MPI ranks
+#
+#   scripts/run_partitioned.sh [ranks] [satnet-rfp options...]
+#   scripts/run_partitioned.sh 3 --numSatellites=108 --islTopology=grid --islLinks=1000 --headless=true
+#
+# Needs ns-3 configured with --enable-mpi and an Open MPI / MPICH mpirun. Rebuilds
+# satnet-rfp with SATNET_MPI, then starts one process per rank through waf.
+# Ranks default to the number of CPUs, at most the 6 planes of the default layout.
+set -e
+
+DCE_DIR="${DCE_DIR:-/workspace/source/ns-3-dce}"
+
+RANKS="$1"
+if [[ "$RANKS" =~ ^[0-9]+$ ]]; then
+    shift
+else
+    RANKS=$(nproc)
+    [ "$RANKS" -gt 6 ] && RANKS=6
+fi
+
+if ! command -v mpirun > /dev/null; then
+    echo "mpirun not found (apt-get install openmpi-bin libopenmpi-dev)"
+    exit 1
+fi
+
+# Open MPI refuses more ranks than cores and running as root unless told otherwise
+MPIRUN="mpirun -np $RANKS"
+if mpirun --version 2>&1 | grep -q "Open MPI"; then
+    MPIRUN="$MPIRUN --oversubscribe --allow-run-as-root"
+fi
+
+cd "$DCE_DIR"
+SATNET_MPI=1 ./waf build
+
+echo "🛰️  satnet-rfp on $RANKS ranks: $*"
+./waf --run satnet-rfp --command-template="$MPIRUN %s --partition=true $*"
@@ -2,10 +2,16 @@
 #define SATNET_CONTROLLER_H
 
 #include <iostream>
+#include <chrono>
 #include "ns3/core-module.h"
 #include "../modules/topology-mgmt.h"
+#include "../modules/rfp-timeline.h"
 #include "../modules/link-detection.h"
 #include "../modules/route-mgmt.h"
+#include "../modules/contact-graph-routing.h"
+#include "../modules/backup-paths.h"
+#include "../modules/ospf-model.h"
+#include "../modules/convergence-monitor.h"
 #include "../modules/performance-analyzer.h"
 
 using namespace ns3;
@@ -17,107 +23,227 @@ using namespace ns3;
 class SatnetOspfController {
 private:
     TopologyManagementModule m_tmm;
+    RfpTimeline m_timeline;                           // T1/T2/T0/T3 of the TMM events, one armed entry
     LinkDetectionModule m_ldm;
     RouteManagementModule m_rmm;
     PerformanceAnalyzer m_analyzer;
+    RouteSource* m_routeSource;                       // Optional route source replacing OSPF (e.g. CGR)
+    BackupPathTable m_backups;                        // Precomputed alternates for unpredicted failures
+    OspfModel* m_ospfModel;                           // Optional in-simulator OSPF replacing Quagga
+    ConvergenceMonitor* m_monitor;                    // Optional: flush the BFU once the tables converged
     
     uint32_t m_eventCounter;
     double m_lastEventTime;
-    uint32_t m_totalQuaggaModifications;
     
 public:
-    SatnetOspfController() : m_eventCounter(0), m_lastEventTime(0.0), m_totalQuaggaModifications(0) {}
+    SatnetOspfController() : m_timeline(m_tmm), m_routeSource(nullptr), m_ospfModel(nullptr), m_monitor(nullptr), m_eventCounter(0), m_lastEventTime(0.0) {
+        m_timeline.SetDispatchCallback([this](uint32_t index, const PredictableLinkDownEvent& event, RfpPhase phase, double time) {
+            ExecutePhase(event.nodeA, event.nodeB, phase, time);
+            if (phase == RFP_PHASE_T3) m_tmm.Retire(index);
+        });
+    }
+    
+    // Use a route source (CGR) instead of OSPF-generated route updates
+    void SetRouteSource(RouteSource* source) {
+        m_routeSource = source;
+    }
+    
+    // Use the OSPF model instead of Quagga: LDM reports feed it, its SPF results go to RMM
+    void SetOspfModel(OspfModel* model) {
+        m_ospfModel = model;
+        m_ldm.SetObserver(model);
+        model->SetRouteUpdateCallback([this](Ptr<Node> node, const std::string& update, double currentTime) {
+            m_rmm.OnNewRoutingTable(node, update, currentTime);
+        });
+        model->SetRouteTableCallback([this](uint32_t node, const std::vector<int16_t>& nextHops, const std::vector<uint16_t>& hops) {
+            m_rmm.SeedForwardingTable(node, nextHops, hops);
+        });
+        model->SetNextHopCallback([this](uint32_t node, uint32_t destination) {
+            if (m_monitor) m_monitor->OnRouteChange(node, destination);
+        });
+        // Unpredicted failures: detected at the dead-interval expiry, closed once every router ran SPF
+        model->SetDetectionCallback([this](int nodeA, int nodeB, bool up) {
+            if (!up) m_analyzer.RecordOspfDetection(nodeA, nodeB);
+        });
+        model->SetConvergenceCallback([this](int nodeA, int nodeB, bool up, double convergence) {
+            if (!up) m_analyzer.RecordReconvergence(nodeA, nodeB);
+        });
+    }
+    
+    // Watch the routing tables between T1 and T2: T2 flushes at convergence, or reports Tc as too short
+    void SetConvergenceMonitor(ConvergenceMonitor* monitor) {
+        m_monitor = monitor;
+        monitor->SetConvergedCallback([this](int nodeA, int nodeB, double convergence) {
+            OnConvergenceReached(nodeA, nodeB, convergence);
+        });
+    }
+    
+    // Register a physical link (feeds the backup path table and the OSPF model)
+    void AddLink(int nodeA, int nodeB) {
+        m_backups.SetLinkState(nodeA, nodeB, true);
+        if (m_ospfModel) {
+            m_ospfModel->AddLink(nodeA, nodeB);
+        }
+    }
+    
+    // Pull routes from the route source and hand them to RMM
+    void RefreshRoutes(double currentTime) {
+        if (!m_routeSource) return;
+        m_rmm.ApplyRouteSource(*m_routeSource, currentTime);
+    }
     
     // Schedule a predictable link down event
     void SchedulePredictableLinkDown(int linkId, int nodeA, int nodeB, double eventTime) {
         try {
             // Validate node indices
             if (!ValidateNodeIndices(nodeA, nodeB)) {
-                std::cerr << "Invalid node indices for link " << linkId << ": " << nodeA << "<->" << nodeB << std::endl;
+                SATLOG_ERROR(SATLOG_RFP, "Invalid node indices for link {}: {}<->{}", linkId, nodeA, nodeB);
                 return;
             }
             
-            // Add event to TMM
-            m_tmm.AddPredictableLinkDown(linkId, nodeA, nodeB, eventTime);
-            
             // Schedule RFP actions
             PredictableLinkDownEvent event(linkId, nodeA, nodeB, eventTime);
+            Time now = Simulator::Now();
             
-            if (event.T1 > 0) {
-                // T1: Start BLD and BFU, force link DOWN in OSPF
-                Simulator::Schedule(Seconds(event.T1), &SatnetOspfController::ExecuteT1Actions, 
-                                  this, nodeA, nodeB, event.T1);
-                
-                // T2: Stop BFU, synchronize forwarding tables
-                Simulator::Schedule(Seconds(event.T2), &SatnetOspfController::ExecuteT2Actions, 
-                                  this, nodeA, nodeB, event.T2);
-                
-                // T0: Physical failure occurs
-                Simulator::Schedule(Seconds(event.T0), &SatnetOspfController::ExecuteT0Actions, 
-                                  this, nodeA, nodeB, event.T0);
-                
-                // T3: Stop BLD, resume normal detection
-                Simulator::Schedule(Seconds(event.T3), &SatnetOspfController::ExecuteT3Actions, 
-                                  this, nodeA, nodeB, event.T3);
-                                  
+            if (Seconds(event.T1) < now) {
+                SATLOG_ERROR(SATLOG_RFP, "Prediction too late for link {}: T1={}s already passed", linkId, event.T1);
+                return;
+            }
+            
+            // Add event to TMM, the timeline dispatches T1, T2, T0 and T3 from it
+            uint32_t index = m_tmm.AddPredictableLinkDown(event);
+            
+            if (m_timeline.Add(index)) {
                 m_eventCounter++;
+            } else {
+                m_tmm.Retire(index);
             }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error scheduling predictable link down: " << e.what() << std::endl;
+            SATLOG_ERROR(SATLOG_RFP, "Error scheduling predictable link down: {}", e.what());
         }
     }
     
     // Handle link state change
     void OnLinkStateChange(int nodeA, int nodeB, bool isUp, double currentTime) {
+        SATNET_TIMER(TIMER_LINK_STATE_CHANGE);
         try {
+            // Analyze performance if link down (the event is charged the Quagga modifications below)
+            bool unpredicted = !m_tmm.IsInBldPeriod(nodeA, nodeB, currentTime);
+            if (!isUp) {
+                AnalyzeLinkDownPerformance(nodeA, nodeB, currentTime);
+            }
+            
+            // Unpredicted failure: switch to the precomputed alternates before OSPF reacts
+            if (!isUp && unpredicted) {
+                m_analyzer.CountQuaggaModifications(ApplyFastFailover(nodeA, nodeB));
+            }
+            // Routes of nodeA that go through the link, taken while it is up (before a failure)
+            bool generateRoutes = !m_ospfModel || m_ospfModel->IsExternal(nodeA);
+            std::vector<int> destinations;
+            if (generateRoutes && !isUp && unpredicted) {
+                destinations = DestinationsVia(nodeA, nodeB);
+            }
+            m_backups.SetLinkState(nodeA, nodeB, isUp);
+            GetResultsWriter().RecordLinkEvent(currentTime, nodeA, nodeB, isUp, !unpredicted);
+            
             // Update state via LDM (handles BLD periods)
+            bool reported = m_ldm.GetReportedState(nodeA, nodeB);
             m_ldm.UpdateRealLinkState(nodeA, nodeB, isUp, currentTime, &m_tmm);
             
             // Get state reported to OSPF (may differ due to RFP)
             bool ospfState = m_ldm.GetReportedState(nodeA, nodeB);
+            if (ospfState != reported) {
+                m_analyzer.CountQuaggaModifications(2); // nodeA and nodeB interfaces
+            }
+            if (m_monitor) {
+                m_monitor->SetLinkState(nodeA, nodeB, ospfState);
+            }
+            
+            // Quagga routers see the interface go down at once; the model reports its own
+            // detection, at the dead-interval expiry
+            if (!isUp && unpredicted && !ospfState && !m_ospfModel) {
+                m_analyzer.RecordOspfDetection(nodeA, nodeB);
+                WatchReconvergence(nodeA, nodeB, currentTime);
+            }
+            if (isUp && unpredicted && m_monitor && m_monitor->IsTracking(nodeA, nodeB)) {
+                uint32_t pendingRoutes = 0;
+                m_monitor->End(nodeA, nodeB, pendingRoutes);
+            }
             
-            // Generate real route update for Quagga
+            // Generate real route updates for Quagga once OSPF sees the change (the OSPF model
+            // emits its own at SPF time, except for the routers it leaves to Quagga)
             Ptr<Node> nodeAPtr = NodeList::GetNode(nodeA);
-            Ptr<Node> nodeBPtr = NodeList::GetNode(nodeB);
             
-            if (nodeAPtr && nodeBPtr) {
-                std::string routeUpdate = GenerateOspfRouteUpdate(nodeA, nodeB, ospfState);
-                m_rmm.OnNewRoutingTable(nodeAPtr, routeUpdate, currentTime);
-                m_totalQuaggaModifications++;
+            if (nodeAPtr && generateRoutes && ospfState != reported) {
+                if (isUp) {
+                    destinations = DestinationsVia(nodeA, nodeB);
+                }
+                for (const std::string& routeUpdate : GenerateOspfRouteUpdates(nodeA, nodeB, isUp, destinations)) {
+                    m_rmm.OnNewRoutingTable(nodeAPtr, routeUpdate, currentTime);
+                    m_analyzer.CountQuaggaModifications(1);
+                }
             }
             
-            // Analyze performance if link down
-            if (!isUp) {
-                AnalyzeLinkDownPerformance(nodeA, nodeB, currentTime);
-            }
+            SATLOG_INFO(SATLOG_RFP, "RFP: Physical={}, OSPF={} for link {}<->{}",
+                        isUp ? "UP" : "DOWN", ospfState ? "UP" : "DOWN", nodeA, nodeB);
             
-            std::cout << "RFP: Physical=" << (isUp?"UP":"DOWN") 
-                      << ", OSPF=" << (ospfState?"UP":"DOWN") 
-                      << " for link " << nodeA << "<->" << nodeB << std::endl;
-                       
         } catch (const std::exception& e) {
-            std::cerr << "Error on link state change: " << e.what() << std::endl;
+            SATLOG_ERROR(SATLOG_RFP, "Error on link state change: {}", e.what());
         }
     }
     
+    // Forwarding path: per-flow ECMP next hop of a node towards a destination node
+    int SelectNextHop(uint32_t nodeId, int destination, uint32_t flowHash) const {
+        return m_rmm.SelectNextHop(nodeId, destination, flowHash);
+    }
+    
+    // Nodes whose packets follow the RMM tables (the T2 swap switches their forwarding)
+    void SetTableRoutedCallback(RouteManagementModule::TableRoutedCallback tableRouted) {
+        m_rmm.SetTableRoutedCallback(tableRouted);
+    }
+    
+    // Weight ECMP next hops by the sampled queue occupancy of each link
+    void EnableLoadAwareForwarding(LinkLoadMonitor* monitor, double refreshInterval) {
+        m_rmm.EnableLoadAwareWeights(monitor, refreshInterval);
+    }
+    
     // Get link state reported to OSPF
     bool GetOspfLinkState(int nodeA, int nodeB) {
         return m_ldm.GetReportedState(nodeA, nodeB);
     }
     
+    PerformanceAnalyzer& GetAnalyzer() {
+        return m_analyzer;
+    }
+    
     // Print final statistics
     void PrintFinalStatistics() {
         try {
+            GetLogger().Flush();
             std::cout << "========== SATNET-OSPF RFP STATISTICS ==========" << std::endl;
             std::cout << "Events scheduled: " << m_eventCounter << std::endl;
             std::cout << "Route updates blocked during BFU: " << m_rmm.GetBlockedUpdatesCount() << std::endl;
             std::cout << "Route updates applied: " << m_rmm.GetAppliedUpdatesCount() << std::endl;
+            std::cout << "Forwarding tables switched at T2: " << m_rmm.GetTablesSwapped()
+                      << " (" << m_rmm.GetSwapCount() << " flushes";
+            if (m_rmm.GetMirrorsSwapped() > 0) {
+                std::cout << ", " << m_rmm.GetMirrorsSwapped() << " more on Quagga nodes, which forward with zebra's table";
+            }
+            std::cout << ")" << std::endl;
+            m_timeline.PrintStatistics();
             std::cout << "Active events: " << m_tmm.GetActiveEvents(Simulator::Now().GetSeconds()).size() << std::endl;
-            std::cout << "Total Quagga modifications: " << m_totalQuaggaModifications << std::endl;
+            std::cout << "Predicted events held: " << m_tmm.GetPredictedEvents().size() << " of " << m_tmm.GetEventCount()
+                      << " (peak " << m_tmm.GetPeakEvents() << ")" << std::endl;
+            std::cout << "Total Quagga modifications: " << m_analyzer.GetQuaggaModifications() << std::endl;
+            std::cout << "Backup path failovers: " << m_backups.GetFailoverCount()
+                      << " (table rows recomputed: " << m_backups.GetTableRowsComputed() << ")" << std::endl;
             std::cout << "vtysh availability: " << (GetVtyshState().available ? "YES" : "NO (simulated)") << std::endl;
             
             m_analyzer.PrintFinalResults();
+#ifdef SATNET_INSTRUMENTATION
+            GetInstrumentation().PrintTable();
+#endif
             
         } catch (const std::exception& e) {
             std::cerr << "Error printing final statistics: " << e.what() << std::endl;
@@ -126,163 +252,278 @@ public:
     
 private:
     // RFP actions according to timeline
+    void ExecutePhase(int nodeA, int nodeB, RfpPhase phase, double currentTime) {
+        switch (phase) {
+            case RFP_PHASE_T1: ExecuteT1Actions(nodeA, nodeB, currentTime); break;   // Start BLD and BFU, force link DOWN in OSPF
+            case RFP_PHASE_T2: ExecuteT2Actions(nodeA, nodeB, currentTime); break;   // Stop BFU, synchronize forwarding tables
+            case RFP_PHASE_T0: ExecuteT0Actions(nodeA, nodeB, currentTime); break;   // Physical failure occurs
+            case RFP_PHASE_T3: ExecuteT3Actions(nodeA, nodeB, currentTime); break;   // Stop BLD, resume normal detection
+            default: break;
+        }
+    }
+    
     void ExecuteT1Actions(int nodeA, int nodeB, double currentTime) {
         try {
-            std::cout << "" << std::endl;
-            std::cout << "===== RFP T1 ACTIONS =====" << std::endl;
-            std::cout << "Time: " << currentTime << "s" << std::endl;
-            std::cout << "Link: " << nodeA << "<->" << nodeB << std::endl;
-            std::cout << "Action: Starting predictive link avoidance" << std::endl;
+            SATLOG_INFO(SATLOG_RFP, "");
+            SATLOG_INFO(SATLOG_RFP, "===== RFP T1 ACTIONS =====");
+            SATLOG_INFO(SATLOG_RFP, "Time: {}s", currentTime);
+            SATLOG_INFO(SATLOG_RFP, "Link: {}<->{}", nodeA, nodeB);
+            GetResultsWriter().RecordMarker(currentTime, nodeA, nodeB, 1);
+            SATLOG_INFO(SATLOG_RFP, "Action: Starting predictive link avoidance");
             
             // Start tracking this RFP event
             m_analyzer.StartLinkDownEvent(nodeA, nodeB, true); // true = RFP
             
             // 1. Start BLD for this link
             m_ldm.ForceLinkDown(nodeA, nodeB, currentTime);
-            m_totalQuaggaModifications += 2; // nodeA and nodeB modified
+            m_analyzer.CountQuaggaModifications(2); // nodeA and nodeB modified
             
             // 2. Start global BFU
             m_rmm.StartBfuPeriod(currentTime);
             
-            std::cout << "OSPF will now avoid this link and recalculate routes" << std::endl;
-            std::cout << "Route updates will be synchronized at T2" << std::endl;
-            std::cout << "=============================" << std::endl;
+            // 3. Route source: compute post-failure routes now, RMM holds them until T2
+            if (m_routeSource) {
+                double failureTime = currentTime + GetRfpTiming().Lead();
+                m_rmm.ApplyRouteSource(*m_routeSource, failureTime);
+            }
+            
+            SATLOG_INFO(SATLOG_RFP, "OSPF will now avoid this link and recalculate routes");
+            SATLOG_INFO(SATLOG_RFP, "Route updates will be synchronized at T2");
+            
+            // 4. Watch the tables: the BFU may end as soon as they match the post-failure SPF
+            if (m_monitor && m_monitor->HasLink(nodeA, nodeB)) {
+                m_monitor->SetLinkState(nodeA, nodeB, false);
+                m_monitor->Begin(nodeA, nodeB, currentTime);
+            }
+            SATLOG_INFO(SATLOG_RFP, "=============================");
             
         } catch (const std::exception& e) {
-            std::cerr << "Error executing T1 actions: " << e.what() << std::endl;
+            SATLOG_ERROR(SATLOG_RFP, "Error executing T1 actions: {}", e.what());
         }
     }
     
     void ExecuteT2Actions(int nodeA, int nodeB, double currentTime) {
         try {
-            std::cout << "" << std::endl;
-            std::cout << "===== RFP T2 ACTIONS =====" << std::endl;
-            std::cout << "Time: " << currentTime << "s" << std::endl;
-            std::cout << "Link: " << nodeA << "<->" << nodeB << std::endl;
-            std::cout << "Action: Synchronizing forwarding tables" << std::endl;
+            SATLOG_INFO(SATLOG_RFP, "");
+            SATLOG_INFO(SATLOG_RFP, "===== RFP T2 ACTIONS =====");
+            SATLOG_INFO(SATLOG_RFP, "Time: {}s", currentTime);
+            SATLOG_INFO(SATLOG_RFP, "Link: {}<->{}", nodeA, nodeB);
+            GetResultsWriter().RecordMarker(currentTime, nodeA, nodeB, 2);
+            SATLOG_INFO(SATLOG_RFP, "Action: Synchronizing forwarding tables");
             
-            // Stop BFU - apply all new routes synchronously
-            m_rmm.EndBfuPeriod(currentTime);
-            m_totalQuaggaModifications += m_rmm.GetBlockedUpdatesCount();
+            if (m_monitor && m_monitor->IsTracking(nodeA, nodeB)) {
+                uint32_t pendingRoutes = 0;
+                bool converged = m_monitor->End(nodeA, nodeB, pendingRoutes);
+                m_analyzer.RecordConvergenceCheck(converged);
+                if (!converged) {
+                    SATLOG_WARN(SATLOG_RFP, "Tc insufficient: link {}<->{} not converged at T2 ({} routes pending), flushing anyway",
+                                nodeA, nodeB, pendingRoutes);
+                }
+            }
+            
+            // Stop BFU - apply all new routes synchronously (unless flushed at convergence)
+            if (m_rmm.IsBfuActive()) {
+                FlushBfu(currentTime);
+            } else {
+                SATLOG_INFO(SATLOG_RFP, "BFU already flushed at convergence");
+            }
+            
+            SATLOG_INFO(SATLOG_RFP, "All nodes now have consistent routing tables");
+            SATLOG_INFO(SATLOG_RFP, "Traffic flows via alternate paths");
+            SATLOG_INFO(SATLOG_RFP, "=============================");
+            
+        } catch (const std::exception& e) {
+            SATLOG_ERROR(SATLOG_RFP, "Error executing T2 actions: {}", e.what());
+        }
+    }
+    
+    void FlushBfu(double currentTime) {
+        auto flushStart = std::chrono::steady_clock::now();
+        m_rmm.EndBfuPeriod(currentTime);
+        m_analyzer.RecordFlushDuration(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - flushStart).count());
+        m_analyzer.CountQuaggaModifications(m_rmm.GetBlockedUpdatesCount());
+    }
+    
+    // Quagga routing: the monitor tells when the tables routed around an unpredicted failure
+    void WatchReconvergence(int nodeA, int nodeB, double currentTime) {
+        if (m_monitor && m_monitor->HasLink(nodeA, nodeB)) {
+            m_monitor->Begin(nodeA, nodeB, currentTime);
+        }
+    }
+    
+    // The tables match the post-failure SPF: measured Tc, and the BFU ends once no event is left pending
+    void OnConvergenceReached(int nodeA, int nodeB, double convergence) {
+        try {
+            double now = Simulator::Now().GetSeconds();
+            if (!m_tmm.IsInBldPeriod(nodeA, nodeB, now)) {
+                // Unpredicted failure: closes its event, no Tc to measure. The monitor is
+                // still reporting, the event ends right after.
+                SATLOG_INFO(SATLOG_RFP, "OSPF: link {}<->{} reconverged {}ms after the failure",
+                            nodeA, nodeB, convergence * 1000.0);
+                m_analyzer.RecordReconvergence(nodeA, nodeB);
+                Simulator::ScheduleNow(&SatnetOspfController::EndWatch, this, nodeA, nodeB);
+                return;
+            }
+            SATLOG_INFO(SATLOG_RFP, "RFP: link {}<->{} converged {}ms after T1", nodeA, nodeB, convergence * 1000.0);
+            m_analyzer.RecordMeasuredConvergence(convergence * 1000.0);
+            GetRfpTiming().OnConvergenceMeasured(convergence);
             
-            std::cout << "All nodes now have consistent routing tables" << std::endl;
-            std::cout << "Traffic flows via alternate paths" << std::endl;
-            std::cout << "=============================" << std::endl;
+            if (m_rmm.IsBfuActive() && !m_monitor->HasPending()) {
+                FlushBfu(now);
+                SATLOG_INFO(SATLOG_RFP, "RFP: BFU flushed at convergence");
+            }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error executing T2 actions: " << e.what() << std::endl;
+            SATLOG_ERROR(SATLOG_RFP, "Error on convergence: {}", e.what());
         }
     }
     
+    void EndWatch(int nodeA, int nodeB) {
+        uint32_t pendingRoutes = 0;
+        if (m_monitor->IsTracking(nodeA, nodeB)) m_monitor->End(nodeA, nodeB, pendingRoutes);
+    }
+    
     void ExecuteT0Actions(int nodeA, int nodeB, double currentTime) {
         try {
-            std::cout << "" << std::endl;
-            std::cout << "===== RFP T0 ACTIONS =====" << std::endl;
-            std::cout << "Time: " << currentTime << "s" << std::endl;
-            std::cout << "Link: " << nodeA << "<->" << nodeB << std::endl;
-            std::cout << "Action: Physical link failure occurs (already prepared)" << std::endl;
+            SATLOG_INFO(SATLOG_RFP, "");
+            SATLOG_INFO(SATLOG_RFP, "===== RFP T0 ACTIONS =====");
+            SATLOG_INFO(SATLOG_RFP, "Time: {}s", currentTime);
+            SATLOG_INFO(SATLOG_RFP, "Link: {}<->{}", nodeA, nodeB);
+            GetResultsWriter().RecordMarker(currentTime, nodeA, nodeB, 0);
+            SATLOG_INFO(SATLOG_RFP, "Action: Physical link failure occurs (already prepared)");
+            
+            SATLOG_INFO(SATLOG_RFP, "CRITICAL: Routes already updated proactively!");
             
-            std::cout << "CRITICAL: Routes already updated proactively!" << std::endl;
-            std::cout << "Traffic already flowing via alternate paths" << std::endl;
+            // Contact plan moves forward: only the affected backup rows get recomputed
+            m_backups.SetLinkState(nodeA, nodeB, false);
+            SATLOG_INFO(SATLOG_RFP, "Traffic already flowing via alternate paths");
             
             // Record convergence
             m_analyzer.RecordRouteConvergence(nodeA, nodeB);
-            m_analyzer.CompleteLinkEvent(nodeA, nodeB, m_totalQuaggaModifications);
+            m_analyzer.CompleteLinkEvent(nodeA, nodeB);
             
-            std::cout << "=============================" << std::endl;
+            SATLOG_INFO(SATLOG_RFP, "=============================");
             
         } catch (const std::exception& e) {
-            std::cerr << "Error executing T0 actions: " << e.what() << std::endl;
+            SATLOG_ERROR(SATLOG_RFP, "Error executing T0 actions: {}", e.what());
         }
     }
     
     void ExecuteT3Actions(int nodeA, int nodeB, double currentTime) {
         try {
-            std::cout << "" << std::endl;
-            std::cout << "===== RFP T3 ACTIONS =====" << std::endl;
-            std::cout << "Time: " << currentTime << "s" << std::endl;
-            std::cout << "Link: " << nodeA << "<->" << nodeB << std::endl;
-            std::cout << "Action: Resuming normal link detection" << std::endl;
+            SATLOG_INFO(SATLOG_RFP, "");
+            SATLOG_INFO(SATLOG_RFP, "===== RFP T3 ACTIONS =====");
+            SATLOG_INFO(SATLOG_RFP, "Time: {}s", currentTime);
+            SATLOG_INFO(SATLOG_RFP, "Link: {}<->{}", nodeA, nodeB);
+            GetResultsWriter().RecordMarker(currentTime, nodeA, nodeB, 3);
+            SATLOG_INFO(SATLOG_RFP, "Action: Resuming normal link detection");
             
             // Stop BLD - resume normal detection
             m_ldm.RestoreNormalDetection(nodeA, nodeB, currentTime);
-            m_totalQuaggaModifications += 2; // restore on nodeA and nodeB
+            if (m_monitor) {
+                m_monitor->SetLinkState(nodeA, nodeB, m_ldm.GetReportedState(nodeA, nodeB));
+            }
+            m_analyzer.CountQuaggaModifications(2); // restore on nodeA and nodeB
             
-            std::cout << "RFP sequence completed successfully" << std::endl;
-            std::cout << "Normal OSPF operation resumed" << std::endl;
-            std::cout << "=============================" << std::endl;
-            std::cout << "" << std::endl;
+            SATLOG_INFO(SATLOG_RFP, "RFP sequence completed successfully");
+            SATLOG_INFO(SATLOG_RFP, "Normal OSPF operation resumed");
+            SATLOG_INFO(SATLOG_RFP, "=============================");
+            SATLOG_INFO(SATLOG_RFP, "");
             
         } catch (const std::exception& e) {
-            std::cerr << "Error executing T3 actions: " << e.what() << std::endl;
+            SATLOG_ERROR(SATLOG_RFP, "Error executing T3 actions: {}", e.what());
         }
     }
     
-    void AnalyzeLinkDownPerformance(int nodeA, int nodeB, double currentTime) {
+    // Install backup next hops on both ends of a failed link, returns the number of repaired routes
+    uint32_t ApplyFastFailover(int nodeA, int nodeB) {
+        uint32_t repaired = 0;
+        
         try {
-            // Check if unpredicted event (standard OSPF)
-            if (!m_tmm.IsInBldPeriod(nodeA, nodeB, currentTime)) {
-                std::cout << "OSPF standard link-down (unpredicted)" << std::endl;
-                
-                // For standard OSPF: Dead interval = 40s, convergence = ~100ms
-                double detectionTime = 40000.0;  // 40s Dead interval in ms
-                double convergenceTime = 100.0;   // ~100ms for SPF
-                double totalOutage = detectionTime + convergenceTime;
+            m_backups.Refresh();
+            
+            int ends[2][2] = {{nodeA, nodeB}, {nodeB, nodeA}};
+            for (const auto& end : ends) {
+                Ptr<Node> node = NodeList::GetNode(end[0]);
+                if (!node) continue;
                 
-                // Record with realistic OSPF values
-                m_analyzer.RecordLinkDownEvent(false, totalOutage, 15, detectionTime, 1);
+                for (const auto& repair : m_backups.Failover(end[0], end[1])) {
+                    std::ostringstream update;
+                    update << "ADD " << NodePrefix(repair.first) << " " << NodeNextHop(repair.second) << " 1";
+                    m_rmm.ApplyFailoverUpdate(node, update.str());
+                    repaired++;
+                }
             }
             
+            SATLOG_INFO(SATLOG_RFP, "FAILOVER: {} routes switched to backup next hops for link {}<->{}",
+                        repaired, nodeA, nodeB);
+            
         } catch (const std::exception& e) {
-            std::cerr << "Error analyzing link down performance: " << e.what() << std::endl;
+            SATLOG_ERROR(SATLOG_RFP, "Error applying fast failover: {}", e.what());
         }
+        
+        return repaired;
     }
     
-    // Generate realistic OSPF route update
-    std::string GenerateOspfRouteUpdate(int nodeA, int nodeB, bool isUp) {
-        std::ostringstream update;
-        
+    void AnalyzeLinkDownPerformance(int nodeA, int nodeB, double currentTime) {
         try {
-            if (isUp) {
-                // New path available
-                update << "ADD 10." << nodeB << ".0.0/16 10.0." << nodeA << ".1 1";
-            } else {
-                // Path removed, find alternative
-                update << "DEL 10." << nodeB << ".0.0/16 10.0." << nodeA << ".1";
+            // Check if unpredicted event (standard OSPF)
+            if (!m_tmm.IsInBldPeriod(nodeA, nodeB, currentTime)) {
+                SATLOG_INFO(SATLOG_RFP, "OSPF standard link-down (unpredicted)");
                 
-                // Add alternative route if available
-                int alternativeNode = FindAlternativePath(nodeA, nodeB);
-                if (alternativeNode >= 0) {
-                    update << " ADD 10." << nodeB << ".0.0/16 10.0." << alternativeNode << ".1 5";
-                }
+                // Outage and loss are measured on the probe flows, detection and reconvergence
+                // come from OSPF (model or monitored Quagga tables)
+                m_analyzer.StartLinkDownEvent(nodeA, nodeB, false);
             }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error generating OSPF route update: " << e.what() << std::endl;
-            update << "ERROR";
+            SATLOG_ERROR(SATLOG_RFP, "Error analyzing link down performance: {}", e.what());
         }
-        
-        return update.str();
     }
     
-    // Find alternative path to bypass a link
-    int FindAlternativePath(int nodeA, int nodeB) {
+    // Destinations nodeA reaches through nodeB on an equal-cost path
+    std::vector<int> DestinationsVia(int nodeA, int nodeB) {
+        std::vector<int> destinations;
+        m_backups.Refresh();
+        for (uint32_t d = 0; d < m_backups.GetNodeCount(); d++) {
+            std::vector<int> nextHops = m_backups.GetEqualCostNextHops(nodeA, d);
+            if (std::find(nextHops.begin(), nextHops.end(), nodeB) != nextHops.end()) {
+                destinations.push_back(d);
+            }
+        }
+        return destinations;
+    }
+    
+    // Generate realistic OSPF route updates: nodeA's new equal-cost set (ECMP) towards each
+    // destination routed through the link, after a failure without nodeB
+    std::vector<std::string> GenerateOspfRouteUpdates(int nodeA, int nodeB, bool isUp, const std::vector<int>& destinations) {
+        std::vector<std::string> updates;
+        
         try {
-            // Simple search for alternative node (limited to avoid errors)
-            uint32_t maxNodes = std::min(NodeList::GetNNodes(), (uint32_t)10);
-            
-            for (uint32_t i = 0; i < maxNodes; i++) {
-                if ((int)i != nodeA && (int)i != nodeB) {
-                    // Check if this node can serve as relay
-                    return (int)i;
+            m_backups.Refresh();
+            for (int destination : destinations) {
+                if (!isUp) {
+                    updates.push_back("DEL " + NodePrefix(destination) + " " + NodeNextHop(nodeB));
+                }
+                
+                std::vector<int> nextHops = m_backups.GetEqualCostNextHops(nodeA, destination);
+                if (nextHops.empty()) continue;
+                
+                std::ostringstream update;
+                update << "ADD " << NodePrefix(destination) << " ";
+                for (size_t i = 0; i < nextHops.size(); i++) {
+                    update << (i > 0 ? "," : "") << NodeNextHop(nextHops[i]);
                 }
+                update << " " << m_backups.GetHopCount(nodeA, destination);
+                updates.push_back(update.str());
             }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error finding alternative path: " << e.what() << std::endl;
+            SATLOG_ERROR(SATLOG_RFP, "Error generating OSPF route update: {}", e.what());
         }
         
-        return -1; // No alternative found
+        return updates;
     }
 };
 
@@ -11,7 +11,10 @@ using namespace ns3;
 
 class TrafficGenerator {
 public:
-    static void Install(NodeContainer nodes, uint16_t port, double startTime, double stopTime) {
+    /**
+     * Echo server on node 0 at its stable address, client on node 1
+     */
+    static void Install(NodeContainer nodes, Ipv4Address server, uint16_t port, double startTime, double stopTime) {
         if (nodes.GetN() < 2) return;
         
         UdpEchoServerHelper echoServer(port);
@@ -19,7 +22,7 @@ public:
         serverApps.Start(Seconds(startTime));
         serverApps.Stop(Seconds(stopTime));
         
-        UdpEchoClientHelper echoClient(Ipv4Address("192.168.1.1"), port);
+        UdpEchoClientHelper echoClient(server, port);
         echoClient.SetAttribute("MaxPackets", UintegerValue(10));
         echoClient.SetAttribute("Interval", TimeValue(Seconds(2.0)));
         echoClient.SetAttribute("PacketSize", UintegerValue(1024));
@@ -28,6 +31,33 @@ public:
         clientApps.Start(Seconds(startTime + 5.0));
         clientApps.Stop(Seconds(stopTime));
     }
+    
+    /**
+     * Sequence-numbered probe flows (UdpClient/UdpServer, SeqTsHeader) from every node to node 0 (server address)
+     * One server port per flow so that the receive trace identifies the flow
+     */
+    static void InstallProbes(NodeContainer nodes, Ipv4Address server, uint16_t basePort, double startTime, double stopTime,
+                              double interval, ApplicationContainer& clients, ApplicationContainer& servers) {
+        for (uint32_t i = 1; i < nodes.GetN(); i++) {
+            uint16_t port = basePort + i - 1;
+            
+            UdpServerHelper probeServer(port);
+            ApplicationContainer serverApp = probeServer.Install(nodes.Get(0));
+            serverApp.Start(Seconds(startTime));
+            serverApp.Stop(Seconds(stopTime));
+            servers.Add(serverApp);
+            
+            UdpClientHelper probeClient(server, port);
+            probeClient.SetAttribute("MaxPackets", UintegerValue(0xFFFFFFFF));
+            probeClient.SetAttribute("Interval", TimeValue(Seconds(interval)));
+            probeClient.SetAttribute("PacketSize", UintegerValue(64));
+            
+            ApplicationContainer clientApp = probeClient.Install(nodes.Get(i));
+            clientApp.Start(Seconds(startTime + 5.0));
+            clientApp.Stop(Seconds(stopTime));
+            clients.Add(clientApp);
+        }
+    }
 };
 
 #endif 
@@ -0,0 +1,432 @@
+#ifndef CONSTELLATION_CONFIG_H
+#define CONSTELLATION_CONFIG_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include "constellation-params.h"
+#include "orbit-propagation.h"
+
+const double EARTH_MU = 398600.4418;        // km^3/s^2
+
+/**
+ * Walker pattern of a shell: delta spreads the planes over 360 deg of RAAN, star over 180 deg
+ */
+enum WalkerPattern {
+    WALKER_DELTA,
+    WALKER_STAR
+};
+
+/**
+ * Shell i:t/p/f at one altitude and inclination
+ */
+struct ShellConfig {
+    std::string name;
+    WalkerPattern pattern;
+    uint32_t planes;
+    uint32_t satsPerPlane;
+    uint32_t phasing;           // Walker f: plane j starts f * j * 360 / t deg ahead
+    double altitudeKm;
+    double inclinationDeg;
+    double periodS;             // 0: Keplerian period of the altitude
+    double raanOffsetDeg;
+
+    ShellConfig() : name(""), pattern(WALKER_DELTA), planes(NUM_PLANES), satsPerPlane(SATS_PER_PLANE), phasing(1),
+                    altitudeKm(ALTITUDE), inclinationDeg(55.0), periodS(0.0), raanOffsetDeg(0.0) {}
+};
+
+/**
+ * Per-plane parameters overriding the shell ones (NaN / 0: keep the shell value)
+ */
+struct PlaneOverride {
+    uint32_t shell;
+    uint32_t plane;
+    double inclinationDeg;
+    double raanDeg;
+    double altitudeKm;
+    double phaseDeg;
+    uint32_t satellites;
+
+    PlaneOverride() : shell(0), plane(0), inclinationDeg(NAN), raanDeg(NAN), altitudeKm(NAN),
+                      phaseDeg(NAN), satellites(0) {}
+};
+
+/**
+ * Runtime constellation description
+ * Without shells it reproduces the default layout (constellation-params.h); shells
+ * and plane overrides come from a config file or the command line:
+ *
+ *   # comment
+ *   timeScale = 1
+ *   shell name=starlink pattern=delta planes=72 sats=22 phasing=39 altitude=550 inclination=53
+ *   shell pattern=star planes=6 sats=11 altitude=780 inclination=86.4
+ *   plane shell=1 index=2 raan=65 inclination=86 sats=10
+ *
+ * Build() expands the shells into PlaneElements; satellites are numbered shell by
+ * shell, plane by plane. Propagation runs per plane (orbit-propagation.h).
+ */
+class ConstellationConfig {
+private:
+    std::vector<ShellConfig> m_shells;
+    std::vector<PlaneOverride> m_overrides;
+    double m_timeScale;         // < 0: ANIMATION_SPEED_FACTOR for the default layout, 1 for shells
+
+    std::vector<PlaneElements> m_planes;
+    std::vector<uint32_t> m_planeOf;
+    std::vector<uint32_t> m_slotOf;
+    std::vector<uint32_t> m_shellOfPlane;
+    uint32_t m_builtSatellites;
+    bool m_built;
+
+    static bool ParseKeyValues(const std::string& spec, std::map<std::string, std::string>& values, std::string& error) {
+        std::istringstream in(spec);
+        std::string token;
+        while (in >> token) {
+            size_t eq = token.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                error = "expected key=value, got '" + token + "'";
+                return false;
+            }
+            values[token.substr(0, eq)] = token.substr(eq + 1);
+        }
+        return true;
+    }
+
+    void AddPlane(double altitudeKm, double inclinationDeg, double raanDeg, double phaseDeg, double periodS,
+                  uint32_t satellites, uint32_t firstIndex, uint32_t stride) {
+        PlaneElements plane;
+        double radius = EARTH_RADIUS + altitudeKm;
+        double period = periodS > 0 ? periodS : 2 * PI * std::sqrt(radius * radius * radius / EARTH_MU);
+        plane.radiusKm = radius;
+        plane.cosRaan = std::cos(raanDeg * PI / 180.0);
+        plane.sinRaan = std::sin(raanDeg * PI / 180.0);
+        plane.cosInc = std::cos(inclinationDeg * PI / 180.0);
+        plane.sinInc = std::sin(inclinationDeg * PI / 180.0);
+        plane.phase0 = phaseDeg * PI / 180.0;
+        plane.meanMotion = 2 * PI * GetTimeScale() / period;
+        plane.satellites = satellites;
+        plane.firstIndex = firstIndex;
+        plane.stride = stride;
+
+        uint32_t planeIndex = m_planes.size();
+        m_planes.push_back(plane);
+        for (uint32_t k = 0; k < satellites; k++) {
+            uint32_t sat = firstIndex + k * stride;
+            if (sat >= m_planeOf.size()) {
+                m_planeOf.resize(sat + 1);
+                m_slotOf.resize(sat + 1);
+            }
+            m_planeOf[sat] = planeIndex;
+            m_slotOf[sat] = k;
+        }
+    }
+
+    /**
+     * Default layout: min(NUM_PLANES, n) planes, satellite i in plane i % planes
+     */
+    void BuildRoundRobin(uint32_t numSatellites) {
+        uint32_t planes = std::min((uint32_t)NUM_PLANES, numSatellites);
+        for (uint32_t p = 0; p < planes; p++) {
+            uint32_t satsInPlane = numSatellites / planes + (p < numSatellites % planes ? 1 : 0);
+            AddPlane(ALTITUDE, INCLINATION_DEG[p % 6], p * 180.0 / planes, 0.0, ORBIT_PERIOD,
+                     satsInPlane, p, planes);
+            m_shellOfPlane.push_back(0);
+        }
+    }
+
+    const PlaneOverride* FindOverride(uint32_t shell, uint32_t plane) const {
+        for (const PlaneOverride& o : m_overrides) {
+            if (o.shell == shell && o.plane == plane) return &o;
+        }
+        return nullptr;
+    }
+
+    void BuildShells() {
+        uint32_t next = 0;
+        for (uint32_t s = 0; s < m_shells.size(); s++) {
+            const ShellConfig& shell = m_shells[s];
+            uint32_t total = 0;
+            for (uint32_t p = 0; p < shell.planes; p++) {
+                const PlaneOverride* o = FindOverride(s, p);
+                total += (o && o->satellites) ? o->satellites : shell.satsPerPlane;
+            }
+            double spread = shell.pattern == WALKER_STAR ? 180.0 : 360.0;
+
+            for (uint32_t p = 0; p < shell.planes; p++) {
+                const PlaneOverride* o = FindOverride(s, p);
+                uint32_t sats = (o && o->satellites) ? o->satellites : shell.satsPerPlane;
+                double raan = (o && !std::isnan(o->raanDeg)) ? o->raanDeg : shell.raanOffsetDeg + p * spread / shell.planes;
+                double phase = (o && !std::isnan(o->phaseDeg)) ? o->phaseDeg
+                                                                : (total ? shell.phasing * p * 360.0 / total : 0.0);
+                double inclination = (o && !std::isnan(o->inclinationDeg)) ? o->inclinationDeg : shell.inclinationDeg;
+                double altitude = (o && !std::isnan(o->altitudeKm)) ? o->altitudeKm : shell.altitudeKm;
+                AddPlane(altitude, inclination, raan, phase, shell.periodS, sats, next, 1);
+                m_shellOfPlane.push_back(s);
+                next += sats;
+            }
+        }
+    }
+
+public:
+    ConstellationConfig() : m_timeScale(-1.0), m_builtSatellites(0), m_built(false) {}
+
+    /**
+     * Shell from "key=value ..." (name, pattern=delta|star, planes, sats, phasing,
+     * altitude, inclination, period, raan)
+     */
+    bool AddShell(const std::string& spec, std::string& error) {
+        std::map<std::string, std::string> values;
+        if (!ParseKeyValues(spec, values, error)) return false;
+
+        ShellConfig shell;
+        try {
+            for (const auto& kv : values) {
+                const std::string& key = kv.first;
+                const std::string& value = kv.second;
+                if (key == "name") shell.name = value;
+                else if (key == "pattern") {
+                    if (value == "delta") shell.pattern = WALKER_DELTA;
+                    else if (value == "star") shell.pattern = WALKER_STAR;
+                    else { error = "unknown pattern '" + value + "' (delta or star)"; return false; }
+                }
+                else if (key == "planes") shell.planes = std::stoul(value);
+                else if (key == "sats") shell.satsPerPlane = std::stoul(value);
+                else if (key == "phasing") shell.phasing = std::stoul(value);
+                else if (key == "altitude") shell.altitudeKm = std::stod(value);
+                else if (key == "inclination") shell.inclinationDeg = std::stod(value);
+                else if (key == "period") shell.periodS = std::stod(value);
+                else if (key == "raan") shell.raanOffsetDeg = std::stod(value);
+                else { error = "unknown shell key '" + key + "'"; return false; }
+            }
+        } catch (const std::exception& e) {
+            error = "invalid shell value: " + std::string(e.what());
+            return false;
+        }
+
+        if (shell.planes == 0 || shell.satsPerPlane == 0) {
+            error = "shell needs planes > 0 and sats > 0";
+            return false;
+        }
+        if (shell.name.empty()) shell.name = "shell" + std::to_string(m_shells.size());
+        m_shells.push_back(shell);
+        m_built = false;
+        return true;
+    }
+
+    /**
+     * Plane override from "key=value ..." (shell, index, inclination, raan, altitude, phase, sats)
+     */
+    bool AddPlaneOverride(const std::string& spec, std::string& error) {
+        std::map<std::string, std::string> values;
+        if (!ParseKeyValues(spec, values, error)) return false;
+
+        PlaneOverride o;
+        try {
+            for (const auto& kv : values) {
+                const std::string& key = kv.first;
+                const std::string& value = kv.second;
+                if (key == "shell") o.shell = std::stoul(value);
+                else if (key == "index") o.plane = std::stoul(value);
+                else if (key == "inclination") o.inclinationDeg = std::stod(value);
+                else if (key == "raan") o.raanDeg = std::stod(value);
+                else if (key == "altitude") o.altitudeKm = std::stod(value);
+                else if (key == "phase") o.phaseDeg = std::stod(value);
+                else if (key == "sats") o.satellites = std::stoul(value);
+                else { error = "unknown plane key '" + key + "'"; return false; }
+            }
+        } catch (const std::exception& e) {
+            error = "invalid plane value: " + std::string(e.what());
+            return false;
+        }
+        m_overrides.push_back(o);
+        m_built = false;
+        return true;
+    }
+
+    /**
+     * Shells separated by ';' (command line form of the shell lines)
+     */
+    bool AddShells(const std::string& specs, std::string& error) {
+        std::istringstream in(specs);
+        std::string spec;
+        while (std::getline(in, spec, ';')) {
+            if (spec.find_first_not_of(" \t") == std::string::npos) continue;
+            if (!AddShell(spec, error)) return false;
+        }
+        return true;
+    }
+
+    bool LoadFile(const std::string& filename, std::string& error) {
+        std::ifstream in(filename);
+        if (!in) {
+            error = "cannot open " + filename;
+            return false;
+        }
+
+        std::string line;
+        uint32_t lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            size_t hash = line.find('#');
+            if (hash != std::string::npos) line.erase(hash);
+
+            std::istringstream words(line);
+            std::string keyword;
+            if (!(words >> keyword)) continue;
+            std::string rest;
+            std::getline(words, rest);
+
+            bool ok = true;
+            if (keyword == "shell") {
+                ok = AddShell(rest, error);
+            } else if (keyword == "plane") {
+                ok = AddPlaneOverride(rest, error);
+            } else if (keyword.compare(0, 9, "timeScale") == 0) {
+                try {
+                    m_timeScale = std::stod(line.substr(line.find('=') + 1));
+                } catch (const std::exception&) {
+                    error = "invalid timeScale";
+                    ok = false;
+                }
+            } else {
+                error = "unknown keyword '" + keyword + "'";
+                ok = false;
+            }
+            if (!ok) {
+                error = filename + ":" + std::to_string(lineNumber) + ": " + error;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void SetTimeScale(double timeScale) {
+        m_timeScale = timeScale;
+        m_built = false;
+    }
+
+    double GetTimeScale() const {
+        if (m_timeScale > 0) return m_timeScale;
+        return m_shells.empty() ? ANIMATION_SPEED_FACTOR : 1.0;
+    }
+
+    bool HasShells() const { return !m_shells.empty(); }
+
+    /**
+     * Expands shells and overrides into planes; numSatellites sizes the default layout only
+     */
+    void Build(uint32_t numSatellites) {
+        m_planes.clear();
+        m_planeOf.clear();
+        m_slotOf.clear();
+        m_shellOfPlane.clear();
+        if (m_shells.empty()) {
+            BuildRoundRobin(numSatellites);
+        } else {
+            BuildShells();
+        }
+        m_builtSatellites = numSatellites;
+        m_built = true;
+    }
+
+    /**
+     * Builds on first use, and again when the default layout is asked for another size
+     */
+    void EnsureBuilt(uint32_t numSatellites) {
+        if (!m_built || (m_shells.empty() && numSatellites != m_builtSatellites)) {
+            Build(numSatellites);
+        }
+    }
+
+    uint32_t GetSatelliteCount() const { return m_planeOf.size(); }
+    uint32_t GetPlaneCount() const { return m_planes.size(); }
+    const PlaneElements& GetPlane(uint32_t plane) const { return m_planes[plane]; }
+    uint32_t PlaneOf(uint32_t sat) const { return m_planeOf[sat]; }
+
+    /**
+     * Grid ISLs: a ring inside every plane, plus slot k to slot k of the next plane of
+     * the same shell. Delta shells close the grid (last plane to first); star shells and
+     * the default layout leave the counter-rotating seam open.
+     */
+    void GetGridLinks(std::vector<std::pair<uint32_t, uint32_t>>& links) const {
+        for (uint32_t p = 0; p < m_planes.size(); p++) {
+            const PlaneElements& plane = m_planes[p];
+            uint32_t ring = plane.satellites > 2 ? plane.satellites : (plane.satellites == 2 ? 1 : 0);
+            for (uint32_t k = 0; k < ring; k++) {
+                links.push_back(std::make_pair(plane.firstIndex + k * plane.stride,
+                                               plane.firstIndex + ((k + 1) % plane.satellites) * plane.stride));
+            }
+        }
+        for (uint32_t p = 0; p < m_planes.size(); p++) {
+            uint32_t shell = m_shellOfPlane[p];
+            uint32_t next = p + 1;
+            if (next >= m_planes.size() || m_shellOfPlane[next] != shell) {
+                // Last plane of its shell: wrap to the first one for delta shells only
+                if (m_shells.empty() || m_shells[shell].pattern != WALKER_DELTA) continue;
+                next = p;
+                while (next > 0 && m_shellOfPlane[next - 1] == shell) next--;
+                if (p - next < 2) continue;            // fewer than 3 planes: no wrap
+            }
+            const PlaneElements& a = m_planes[p];
+            const PlaneElements& b = m_planes[next];
+            for (uint32_t k = 0; k < std::min(a.satellites, b.satellites); k++) {
+                links.push_back(std::make_pair(a.firstIndex + k * a.stride, b.firstIndex + k * b.stride));
+            }
+        }
+    }
+
+    /**
+     * Simulated seconds for one orbit of the satellite's plane
+     */
+    double GetOrbitTime(uint32_t sat) const {
+        return 2 * PI / m_planes[m_planeOf[sat]].meanMotion;
+    }
+
+    double GetMaxAltitude() const {
+        double radius = EARTH_RADIUS + ALTITUDE;
+        if (!m_planes.empty()) {
+            radius = 0.0;
+            for (const PlaneElements& plane : m_planes) radius = std::max(radius, plane.radiusKm);
+        }
+        return radius - EARTH_RADIUS;
+    }
+
+    /**
+     * Every satellite at the given time, out is resized to the satellite count
+     */
+    void Propagate(double time, std::vector<OrbitalState>& out) const {
+        out.resize(m_planeOf.size());
+        for (const PlaneElements& plane : m_planes) {
+            PropagatePlane(plane, time, out.data());
+        }
+    }
+
+    OrbitalState PropagateSatellite(uint32_t sat, double time) const {
+        return PropagateSlot(m_planes[m_planeOf[sat]], m_slotOf[sat], time);
+    }
+
+    void Print() const {
+        std::cout << "Constellation: " << GetSatelliteCount() << " satellites in " << GetPlaneCount()
+                  << " planes, time scale " << GetTimeScale() << std::endl;
+        if (m_shells.empty()) {
+            std::cout << "   Default layout (" << NUM_PLANES << " planes, round-robin)" << std::endl;
+        }
+        for (const ShellConfig& shell : m_shells) {
+            std::cout << "   " << shell.name << ": " << (shell.pattern == WALKER_STAR ? "star " : "delta ")
+                      << shell.planes * shell.satsPerPlane << "/" << shell.planes << "/" << shell.phasing
+                      << " at " << shell.altitudeKm << " km, " << shell.inclinationDeg << " deg" << std::endl;
+        }
+    }
+};
+
+inline ConstellationConfig& GetConstellation() {
+    static ConstellationConfig constellation;
+    return constellation;
+}
+
+#endif // CONSTELLATION_CONFIG_H
@@ -0,0 +1,121 @@
+#ifndef CONSTELLATION_H
+#define CONSTELLATION_H
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * Topological model of the constellation
+ * Every link carries the time intervals during which it is up (contacts)
+ */
+class TopologyModel {
+public:
+    struct TimeInterval {
+        double startTime;
+        double endTime;
+
+        TimeInterval(double start, double end) : startTime(start), endTime(end) {}
+    };
+
+    struct Link {
+        int nodeA;
+        int nodeB;
+        bool isPeriodic;
+        double period;
+        std::vector<TimeInterval> intervals;
+
+        Link(int a, int b) : nodeA(a), nodeB(b), isPeriodic(false), period(0.0) {}
+    };
+
+    TopologyModel() {}
+
+    int AddLink(int nodeA, int nodeB) {
+        try {
+            Link link(nodeA, nodeB);
+            links.push_back(link);
+            return links.size() - 1;
+
+        } catch (const std::exception& e) {
+            std::cerr << "Error add link: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    void SetLinkPeriodic(int linkIndex, double period) {
+        if (linkIndex >= 0 && linkIndex < (int)links.size()) {
+            links[linkIndex].isPeriodic = true;
+            links[linkIndex].period = period;
+        }
+    }
+
+    void AddLinkInterval(int linkIndex, double startTime, double endTime) {
+        try {
+            if (linkIndex >= 0 && linkIndex < (int)links.size()) {
+                TimeInterval interval(startTime, endTime);
+                links[linkIndex].intervals.push_back(interval);
+            }
+
+        } catch (const std::exception& e) {
+            std::cerr << "Error add link interval: " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * Cuts every contact of a link at the given time (predicted link-down)
+     */
+    void EndLinkAt(int linkIndex, double time) {
+        if (linkIndex < 0 || linkIndex >= (int)links.size()) return;
+
+        std::vector<TimeInterval>& intervals = links[linkIndex].intervals;
+        std::vector<TimeInterval> kept;
+        for (const auto& interval : intervals) {
+            if (interval.startTime >= time) continue;
+            kept.push_back(TimeInterval(interval.startTime, std::min(interval.endTime, time)));
+        }
+        intervals.swap(kept);
+        links[linkIndex].isPeriodic = false;
+    }
+
+    bool IsLinkUp(int linkIndex, double time) const {
+        if (linkIndex < 0 || linkIndex >= (int)links.size()) return false;
+
+        const Link& link = links[linkIndex];
+
+        if (link.isPeriodic && link.period > 0) {
+            time = fmod(time, link.period);
+        }
+
+        for (const auto& interval : link.intervals) {
+            if (time >= interval.startTime && time < interval.endTime) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    int FindLink(int nodeA, int nodeB) const {
+        for (size_t i = 0; i < links.size(); i++) {
+            if ((links[i].nodeA == nodeA && links[i].nodeB == nodeB) ||
+                (links[i].nodeA == nodeB && links[i].nodeB == nodeA)) {
+                return (int)i;
+            }
+        }
+        return -1;
+    }
+
+    const Link& GetLink(int linkIndex) const {
+        return links[linkIndex];
+    }
+
+    size_t GetLinkCount() const {
+        return links.size();
+    }
+
+private:
+    std::vector<Link> links;
+};
+
+#endif // CONSTELLATION_H
@@ -0,0 +1,238 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Hot-path instrumentation: named counters and scoped timers per subsystem
+ * Enabled with -DSATNET_INSTRUMENTATION (see wscript); without it every
+ * SATNET_TIMER/SATNET_COUNT/SATNET_PHASE_* expands to nothing.
+ * Timers read the TSC on x86 (calibrated against steady_clock when reported),
+ * steady_clock elsewhere. The simulation is single-threaded, stats are plain integers.
+ */
+enum InstrumentTimer : uint8_t {
+    TIMER_UPDATE_POSITIONS,
+    TIMER_SATELLITE_VISIBLE,
+    TIMER_BLD_QUERY,
+    TIMER_LINK_STATE_CHANGE,
+    TIMER_BFU_FLUSH,
+    TIMER_VTYSH_COMMAND,
+    TIMER_OSPF_MODEL_SPF,
+    TIMER_PHASE_SETUP,
+    TIMER_PHASE_RUN,
+    TIMER_PHASE_REPORT,
+    TIMER_COUNT
+};
+
+enum InstrumentCounter : uint8_t {
+    COUNTER_VISIBLE_LINKS,
+    COUNTER_BLD_HITS,
+    COUNTER_BFU_UPDATES_FLUSHED,
+    COUNTER_VTYSH_SPAWNED,
+    COUNTER_VTYSH_SIMULATED,
+    COUNTER_SIM_EVENTS,
+    COUNTER_DCE_PROCESSES,
+    COUNTER_FIB_SWAPS,
+    COUNTER_COUNT
+};
+
+struct InstrumentName {
+    const char* subsystem;
+    const char* name;
+};
+
+const InstrumentName TIMER_NAMES[TIMER_COUNT] = {
+    {"SatelliteHelper", "UpdatePositions"},
+    {"SatelliteHelper", "IsSatelliteVisible"},
+    {"TMM", "IsInBldPeriod"},
+    {"Controller", "OnLinkStateChange"},
+    {"RMM", "EndBfuPeriod"},
+    {"Quagga", "ExecuteVtyshCommand"},
+    {"OspfModel", "RunSpf"},
+    {"Simulator", "setup"},
+    {"Simulator", "Run"},
+    {"Simulator", "report"}
+};
+
+const InstrumentName COUNTER_NAMES[COUNTER_COUNT] = {
+    {"SatelliteHelper", "visible_links"},
+    {"TMM", "bld_hits"},
+    {"RMM", "updates_flushed"},
+    {"Quagga", "vtysh_spawned"},
+    {"Quagga", "vtysh_simulated"},
+    {"Simulator", "events"},
+    {"DCE", "processes"},
+    {"RMM", "fib_swaps"}
+};
+
+inline uint64_t InstrumentTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+class Instrumentation {
+private:
+    struct TimerStats {
+        uint64_t calls;
+        uint64_t ticks;
+        uint64_t maxTicks;
+    };
+
+    TimerStats m_timers[TIMER_COUNT];
+    uint64_t m_counters[COUNTER_COUNT];
+    uint64_t m_phaseStart[TIMER_COUNT];
+
+    uint64_t m_calibrationTicks;
+    std::chrono::steady_clock::time_point m_calibrationTime;
+
+    /**
+     * Nanoseconds per tick, from the ticks and the steady_clock time elapsed since construction
+     */
+    double NsPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+        double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - m_calibrationTime).count();
+        uint64_t ticks = InstrumentTicks() - m_calibrationTicks;
+        return ticks > 0 ? ns / ticks : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+
+public:
+    Instrumentation() : m_calibrationTicks(InstrumentTicks()),
+                        m_calibrationTime(std::chrono::steady_clock::now()) {
+        Reset();
+    }
+
+    void Reset() {
+        std::fill(m_timers, m_timers + TIMER_COUNT, TimerStats{0, 0, 0});
+        std::fill(m_counters, m_counters + COUNTER_COUNT, 0);
+        std::fill(m_phaseStart, m_phaseStart + TIMER_COUNT, 0);
+    }
+
+    void AddSample(uint8_t timer, uint64_t ticks) {
+        TimerStats& stats = m_timers[timer];
+        stats.calls++;
+        stats.ticks += ticks;
+        stats.maxTicks = std::max(stats.maxTicks, ticks);
+    }
+
+    void Count(uint8_t counter, uint64_t amount) {
+        m_counters[counter] += amount;
+    }
+
+    void BeginPhase(uint8_t timer) {
+        m_phaseStart[timer] = InstrumentTicks();
+    }
+
+    void EndPhase(uint8_t timer) {
+        AddSample(timer, InstrumentTicks() - m_phaseStart[timer]);
+    }
+
+    uint64_t GetCalls(uint8_t timer) const { return m_timers[timer].calls; }
+    uint64_t GetCounter(uint8_t counter) const { return m_counters[counter]; }
+
+    void PrintTable() const {
+        double nsPerTick = NsPerTick();
+        std::cout << "========== INSTRUMENTATION ==========" << std::endl;
+        std::cout << std::left << std::setw(18) << "Subsystem" << std::setw(22) << "Timer"
+                  << std::right << std::setw(12) << "calls" << std::setw(14) << "total ms"
+                  << std::setw(12) << "mean us" << std::setw(12) << "max us" << std::endl;
+        for (uint8_t t = 0; t < TIMER_COUNT; t++) {
+            const TimerStats& stats = m_timers[t];
+            if (stats.calls == 0) continue;
+            std::cout << std::left << std::setw(18) << TIMER_NAMES[t].subsystem << std::setw(22) << TIMER_NAMES[t].name
+                      << std::right << std::setw(12) << stats.calls
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(14) << stats.ticks * nsPerTick / 1e6
+                      << std::setw(12) << stats.ticks * nsPerTick / stats.calls / 1e3
+                      << std::setw(12) << stats.maxTicks * nsPerTick / 1e3 << std::endl;
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6) << std::left;
+        for (uint8_t c = 0; c < COUNTER_COUNT; c++) {
+            std::cout << std::setw(18) << COUNTER_NAMES[c].subsystem << std::setw(22) << COUNTER_NAMES[c].name
+                      << std::right << std::setw(12) << m_counters[c] << std::left << std::endl;
+        }
+        std::cout << std::right;
+    }
+
+    /**
+     * CSV: subsystem,name,kind,calls,total_ns,mean_ns,max_ns (counters: value in calls)
+     */
+    bool ExportCsv(const std::string& filename) const {
+        std::ofstream out(filename);
+        if (!out) {
+            std::cerr << "Error exporting instrumentation: cannot open " << filename << std::endl;
+            return false;
+        }
+
+        double nsPerTick = NsPerTick();
+        out << "subsystem,name,kind,calls,total_ns,mean_ns,max_ns" << std::endl;
+        for (uint8_t t = 0; t < TIMER_COUNT; t++) {
+            const TimerStats& stats = m_timers[t];
+            out << TIMER_NAMES[t].subsystem << "," << TIMER_NAMES[t].name << ",timer," << stats.calls << ","
+                << (uint64_t)(stats.ticks * nsPerTick) << ","
+                << (uint64_t)(stats.calls ? stats.ticks * nsPerTick / stats.calls : 0) << ","
+                << (uint64_t)(stats.maxTicks * nsPerTick) << std::endl;
+        }
+        for (uint8_t c = 0; c < COUNTER_COUNT; c++) {
+            out << COUNTER_NAMES[c].subsystem << "," << COUNTER_NAMES[c].name << ",counter,"
+                << m_counters[c] << ",0,0,0" << std::endl;
+        }
+        return true;
+    }
+};
+
+inline Instrumentation& GetInstrumentation() {
+    static Instrumentation instrumentation;
+    return instrumentation;
+}
+
+/**
+ * Adds the time spent in the enclosing scope to a timer
+ */
+class ScopedTimer {
+private:
+    uint8_t m_timer;
+    uint64_t m_start;
+
+public:
+    explicit ScopedTimer(uint8_t timer) : m_timer(timer), m_start(InstrumentTicks()) {}
+
+    ~ScopedTimer() {
+        GetInstrumentation().AddSample(m_timer, InstrumentTicks() - m_start);
+    }
+};
+
+#define SATNET_CONCAT_INNER(a, b) a##b
+#define SATNET_CONCAT(a, b) SATNET_CONCAT_INNER(a, b)
+
+#ifdef SATNET_INSTRUMENTATION
+#define SATNET_TIMER(timer) ScopedTimer SATNET_CONCAT(satnetTimer, __LINE__)(timer)
+#define SATNET_COUNT(counter, amount) GetInstrumentation().Count(counter, amount)
+#define SATNET_PHASE_BEGIN(timer) GetInstrumentation().BeginPhase(timer)
+#define SATNET_PHASE_END(timer) GetInstrumentation().EndPhase(timer)
+#else
+#define SATNET_TIMER(timer) do {} while (0)
+#define SATNET_COUNT(counter, amount) do {} while (0)
+#define SATNET_PHASE_BEGIN(timer) do {} while (0)
+#define SATNET_PHASE_END(timer) do {} while (0)
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,135 @@
+#ifndef LINK_KEY_H
+#define LINK_KEY_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+const uint64_t NO_LINK_KEY = UINT64_MAX;
+
+/**
+ * Undirected link key: (min node, max node) packed in 64 bits
+ */
+inline uint64_t MakeLinkKey(int nodeA, int nodeB) {
+    if (nodeA > nodeB) std::swap(nodeA, nodeB);
+    return ((uint64_t)(uint32_t)nodeA << 32) | (uint32_t)nodeB;
+}
+
+inline int LinkKeyNodeA(uint64_t key) { return (int)(uint32_t)(key >> 32); }
+inline int LinkKeyNodeB(uint64_t key) { return (int)(uint32_t)key; }
+
+/**
+ * Open-addressing hash map keyed by packed link keys
+ * Linear probing over flat arrays, backward-shift erase (no tombstones)
+ */
+template <typename Value>
+class FlatLinkMap {
+private:
+    std::vector<uint64_t> m_keys;
+    std::vector<Value> m_values;
+    size_t m_size;
+    size_t m_mask;
+
+    static uint64_t Hash(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return key;
+    }
+
+    size_t Slot(uint64_t key) const {
+        size_t slot = Hash(key) & m_mask;
+        while (m_keys[slot] != NO_LINK_KEY && m_keys[slot] != key) {
+            slot = (slot + 1) & m_mask;
+        }
+        return slot;
+    }
+
+    void Grow() {
+        std::vector<uint64_t> keys(m_keys.size() * 2, NO_LINK_KEY);
+        std::vector<Value> values(m_values.size() * 2);
+        keys.swap(m_keys);
+        values.swap(m_values);
+        m_mask = m_keys.size() - 1;
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] == NO_LINK_KEY) continue;
+            size_t slot = Slot(keys[i]);
+            m_keys[slot] = keys[i];
+            m_values[slot] = values[i];
+        }
+    }
+
+public:
+    FlatLinkMap(size_t capacity = 64) : m_size(0) {
+        size_t slots = 16;
+        while (slots < capacity * 2) slots <<= 1;
+        m_keys.assign(slots, NO_LINK_KEY);
+        m_values.resize(slots);
+        m_mask = slots - 1;
+    }
+
+    Value* Find(uint64_t key) {
+        size_t slot = Slot(key);
+        return (m_keys[slot] == key) ? &m_values[slot] : nullptr;
+    }
+
+    const Value* Find(uint64_t key) const {
+        size_t slot = Slot(key);
+        return (m_keys[slot] == key) ? &m_values[slot] : nullptr;
+    }
+
+    /**
+     * Inserts or overwrites
+     */
+    Value& Insert(uint64_t key, const Value& value) {
+        if ((m_size + 1) * 2 > m_keys.size()) Grow();
+
+        size_t slot = Slot(key);
+        if (m_keys[slot] != key) {
+            m_keys[slot] = key;
+            m_size++;
+        }
+        m_values[slot] = value;
+        return m_values[slot];
+    }
+
+    bool Erase(uint64_t key) {
+        size_t slot = Slot(key);
+        if (m_keys[slot] != key) return false;
+
+        // Shift back the following entries of the probe chain
+        size_t hole = slot;
+        size_t next = (hole + 1) & m_mask;
+        while (m_keys[next] != NO_LINK_KEY) {
+            size_t home = Hash(m_keys[next]) & m_mask;
+            if (((next - home) & m_mask) >= ((next - hole) & m_mask)) {
+                m_keys[hole] = m_keys[next];
+                m_values[hole] = m_values[next];
+                hole = next;
+            }
+            next = (next + 1) & m_mask;
+        }
+        m_keys[hole] = NO_LINK_KEY;
+        m_values[hole] = Value();
+        m_size--;
+        return true;
+    }
+
+    template <typename Function>
+    void ForEach(Function function) {
+        for (size_t i = 0; i < m_keys.size(); i++) {
+            if (m_keys[i] != NO_LINK_KEY) function(m_keys[i], m_values[i]);
+        }
+    }
+
+    void Clear() {
+        std::fill(m_keys.begin(), m_keys.end(), NO_LINK_KEY);
+        std::fill(m_values.begin(), m_values.end(), Value());
+        m_size = 0;
+    }
+
+    size_t Size() const { return m_size; }
+};
+
+#endif // LINK_KEY_H
@@ -0,0 +1,114 @@
+#ifndef ORBIT_PROPAGATION_H
+#define ORBIT_PROPAGATION_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include "ns3/core-module.h"
+#include "constellation-params.h"
+
+using namespace ns3;
+
+/**
+ * Circular orbital plane, satellites evenly spaced in argument of latitude
+ * Satellite k of the plane is at index firstIndex + k * stride
+ * (stride 1 for Walker shells, the plane count for the round-robin default layout).
+ */
+struct PlaneElements {
+    double radiusKm;
+    double cosRaan, sinRaan;
+    double cosInc, sinInc;
+    double phase0;          // Argument of latitude of satellite 0 at t = 0 (rad)
+    double meanMotion;      // rad per simulated second (time scale included)
+    uint32_t satellites;
+    uint32_t firstIndex;
+    uint32_t stride;
+};
+
+struct OrbitalState {
+    Vector unit;            // Earth-centered direction (Earth rotation ignored)
+    double theta;           // Argument of latitude (rad, not wrapped)
+    double radiusKm;
+};
+
+/**
+ * Rotates the in-plane position (cos theta, sin theta) by inclination and RAAN
+ */
+inline Vector PlaneToEarthCentered(const PlaneElements& plane, double c, double s) {
+    return Vector(c * plane.cosRaan - s * plane.cosInc * plane.sinRaan,
+                  c * plane.sinRaan + s * plane.cosInc * plane.cosRaan,
+                  s * plane.sinInc);
+}
+
+/**
+ * One plane, Sats known at compile time: one sincos per plane, the in-plane
+ * spacing is a fixed rotation applied Sats times (unrolled loop)
+ */
+template <uint32_t Sats>
+inline void PropagatePlaneFixed(const PlaneElements& plane, double time, OrbitalState* out) {
+    const double step = 2 * PI / Sats;
+    const double cosStep = std::cos(step);
+    const double sinStep = std::sin(step);
+    double theta0 = plane.phase0 + plane.meanMotion * time;
+    double c = std::cos(theta0);
+    double s = std::sin(theta0);
+    for (uint32_t k = 0; k < Sats; k++) {
+        OrbitalState& state = out[plane.firstIndex + k * plane.stride];
+        state.unit = PlaneToEarthCentered(plane, c, s);
+        state.theta = theta0 + k * step;
+        state.radiusKm = plane.radiusKm;
+        double next = c * cosStep - s * sinStep;
+        s = s * cosStep + c * sinStep;
+        c = next;
+    }
+}
+
+/**
+ * Any plane size, same rotation recurrence with a runtime trip count
+ */
+inline void PropagatePlaneGeneric(const PlaneElements& plane, double time, OrbitalState* out) {
+    if (plane.satellites == 0) return;
+    const double step = 2 * PI / plane.satellites;
+    const double cosStep = std::cos(step);
+    const double sinStep = std::sin(step);
+    double theta0 = plane.phase0 + plane.meanMotion * time;
+    double c = std::cos(theta0);
+    double s = std::sin(theta0);
+    for (uint32_t k = 0; k < plane.satellites; k++) {
+        OrbitalState& state = out[plane.firstIndex + k * plane.stride];
+        state.unit = PlaneToEarthCentered(plane, c, s);
+        state.theta = theta0 + k * step;
+        state.radiusKm = plane.radiusKm;
+        double next = c * cosStep - s * sinStep;
+        s = s * cosStep + c * sinStep;
+        c = next;
+    }
+}
+
+/**
+ * Dispatches the common plane sizes to the fixed kernels
+ * 11 (Iridium), 18 (default shell), 22 (Starlink shell 1), 34 (Kuiper), 40 (OneWeb-like)
+ */
+inline void PropagatePlane(const PlaneElements& plane, double time, OrbitalState* out) {
+    switch (plane.satellites) {
+        case 11: PropagatePlaneFixed<11>(plane, time, out); break;
+        case 18: PropagatePlaneFixed<18>(plane, time, out); break;
+        case 22: PropagatePlaneFixed<22>(plane, time, out); break;
+        case 34: PropagatePlaneFixed<34>(plane, time, out); break;
+        case 40: PropagatePlaneFixed<40>(plane, time, out); break;
+        default: PropagatePlaneGeneric(plane, time, out); break;
+    }
+}
+
+/**
+ * Single satellite (slot k of the plane), for look-ahead queries at arbitrary times
+ */
+inline OrbitalState PropagateSlot(const PlaneElements& plane, uint32_t slot, double time) {
+    OrbitalState state;
+    state.theta = plane.phase0 + slot * (2 * PI / plane.satellites) + plane.meanMotion * time;
+    state.unit = PlaneToEarthCentered(plane, std::cos(state.theta), std::sin(state.theta));
+    state.radiusKm = plane.radiusKm;
+    return state;
+}
+
+#endif // ORBIT_PROPAGATION_H
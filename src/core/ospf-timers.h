@@ -0,0 +1,79 @@
+#ifndef OSPF_TIMERS_H
+#define OSPF_TIMERS_H
+
+#include <string>
+#include <sstream>
+#include <cstdint>
+
+/**
+ * OSPF timers shared by the OSPF model and the generated Quagga configs
+ * Defaults are Quagga 0.99's; fields < 0 in an override set mean "keep".
+ */
+struct OspfTimers {
+    double helloInterval;   // s (< 1: fast hellos, dead interval 1 s)
+    double deadInterval;    // s
+    double floodDelay;      // s per hop: ISL propagation + LSA processing
+    double lsaInterval;     // s, MinLSInterval between two LSAs of the same router
+    double spfDelay;        // s, from the LSA arrival to the SPF run
+    double spfHold;         // s, initial hold between two SPF runs of a router
+    double spfMaxHold;      // s, the hold doubles up to this while SPF requests keep coming
+
+    OspfTimers() : helloInterval(10.0), deadInterval(40.0), floodDelay(0.025), lsaInterval(5.0),
+                   spfDelay(0.2), spfHold(1.0), spfMaxHold(10.0) {}
+
+    /**
+     * default: Quagga 0.99 defaults
+     * fast: 250 ms hellos (1 s dead), 50 ms LSA pacing, SPF throttle 50/100/1000 ms
+     * (LSA pacing is the OSPF model's only: Quagga 0.99 keeps its fixed 5 s)
+     */
+    static bool ForProfile(const std::string& name, OspfTimers& timers) {
+        timers = OspfTimers();
+        if (name == "default") return true;
+        if (name == "fast") {
+            timers.helloInterval = 0.25;
+            timers.deadInterval = 1.0;
+            timers.lsaInterval = 0.05;
+            timers.spfDelay = 0.05;
+            timers.spfHold = 0.1;
+            timers.spfMaxHold = 1.0;
+            return true;
+        }
+        return false;
+    }
+
+    static OspfTimers Unset() {
+        OspfTimers timers;
+        timers.helloInterval = timers.deadInterval = timers.floodDelay = -1.0;
+        timers.lsaInterval = timers.spfDelay = timers.spfHold = timers.spfMaxHold = -1.0;
+        return timers;
+    }
+
+    void Override(const OspfTimers& other) {
+        if (other.helloInterval >= 0) helloInterval = other.helloInterval;
+        if (other.deadInterval >= 0) deadInterval = other.deadInterval;
+        if (other.floodDelay >= 0) floodDelay = other.floodDelay;
+        if (other.lsaInterval >= 0) lsaInterval = other.lsaInterval;
+        if (other.spfDelay >= 0) spfDelay = other.spfDelay;
+        if (other.spfHold >= 0) spfHold = other.spfHold;
+        if (other.spfMaxHold >= 0) spfMaxHold = other.spfMaxHold;
+        if (helloInterval < 1.0) deadInterval = 1.0;
+        if (spfMaxHold < spfHold) spfMaxHold = spfHold;
+    }
+
+    /**
+     * Worst case from an administrative shutdown (RFP T1) to the last SPF, for an
+     * isolated event: LSA pacing wait, flooding across the network, SPF delay and hold
+     */
+    double ConvergenceBound(uint32_t diameterHops) const {
+        return lsaInterval + diameterHops * floodDelay + spfDelay + spfHold;
+    }
+
+    std::string Describe() const {
+        std::ostringstream out;
+        out << "hello " << helloInterval << "s, dead " << deadInterval << "s, LSA interval " << lsaInterval
+            << "s, SPF " << spfDelay * 1000.0 << "/" << spfHold * 1000.0 << "/" << spfMaxHold * 1000.0 << " ms";
+        return out.str();
+    }
+};
+
+#endif // OSPF_TIMERS_H
@@ -0,0 +1,45 @@
+#ifndef RFP_TIMING_H
+#define RFP_TIMING_H
+
+#include <algorithm>
+#include <cstdint>
+#include "../core/constellation-params.h"
+
+const double RFP_TC_MEASURED_MARGIN = 1.5;     // Measured Tc = slowest convergence seen x margin
+
+/**
+ * RFP margins used at run time (Tc, dT)
+ * Default to RFP_CONVERGENCE_TIME_TC / RFP_SAFETY_MARGIN_DT, set from the
+ * command line (--tc, --dt) before the first predicted event is scheduled.
+ * With measuredTc, Tc starts from the OSPF timer bound and then follows the slowest
+ * convergence the convergence monitor measured so far (T1 to converged tables); events
+ * predicted afterwards use the new value.
+ */
+struct RfpTiming {
+    double tc;      // OSPF convergence time (Tc)
+    double dt;      // Safety margin (dT)
+    bool measuredTc;
+    double measuredMax;
+    uint32_t measuredSamples;
+
+    RfpTiming() : tc(RFP_CONVERGENCE_TIME_TC), dt(RFP_SAFETY_MARGIN_DT), measuredTc(false),
+                  measuredMax(0.0), measuredSamples(0) {}
+
+    void OnConvergenceMeasured(double seconds) {
+        measuredSamples++;
+        measuredMax = std::max(measuredMax, seconds);
+        if (measuredTc && measuredMax > 0.0) {
+            tc = measuredMax * RFP_TC_MEASURED_MARGIN;
+        }
+    }
+
+    // T0 - T1: BLD/BFU starts this long before the physical failure
+    double Lead() const { return tc + 2 * dt; }
+};
+
+inline RfpTiming& GetRfpTiming() {
+    static RfpTiming timing;
+    return timing;
+}
+
+#endif // RFP_TIMING_H
@@ -0,0 +1,474 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <type_traits>
+#include <algorithm>
+
+// <charconv> needs GCC 8 / libstdc++ 8; older toolchains (ubuntu:16.04 image) format with snprintf
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define SATLOG_HAS_CHARCONV 1
+#endif
+#endif
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/**
+ * Severities, in NS_LOG order (level_error ... level_logic)
+ * SATLOG_MAX_LEVEL is the compile-time ceiling: calls above it compile to nothing,
+ * e.g. -DSATLOG_MAX_LEVEL=SATLOG_LEVEL_INFO drops the per-route and per-command traces
+ */
+#define SATLOG_LEVEL_ERROR 1
+#define SATLOG_LEVEL_WARN 2
+#define SATLOG_LEVEL_DEBUG 3
+#define SATLOG_LEVEL_INFO 4
+#define SATLOG_LEVEL_LOGIC 5
+
+#ifndef SATLOG_MAX_LEVEL
+#define SATLOG_MAX_LEVEL SATLOG_LEVEL_LOGIC
+#endif
+
+#define SATLOG(level, mask, component, ...)                                          \
+    do {                                                                             \
+        if (SATLOG_MAX_LEVEL >= level && GetLogger().IsEnabled(component, mask)) {   \
+            GetLogger().Log(mask, component, __VA_ARGS__);                           \
+        }                                                                            \
+    } while (0)
+
+#define SATLOG_ERROR(component, ...) SATLOG(SATLOG_LEVEL_ERROR, LOG_ERROR, component, __VA_ARGS__)
+#define SATLOG_WARN(component, ...) SATLOG(SATLOG_LEVEL_WARN, LOG_WARN, component, __VA_ARGS__)
+#define SATLOG_DEBUG(component, ...) SATLOG(SATLOG_LEVEL_DEBUG, LOG_DEBUG, component, __VA_ARGS__)
+#define SATLOG_INFO(component, ...) SATLOG(SATLOG_LEVEL_INFO, LOG_INFO, component, __VA_ARGS__)
+#define SATLOG_LOGIC(component, ...) SATLOG(SATLOG_LEVEL_LOGIC, LOG_LOGIC, component, __VA_ARGS__)
+
+/**
+ * Log components, registered as ns-3 LogComponents so NS_LOG and LogComponentEnable apply
+ */
+enum SatLogComponent : uint8_t {
+    SATLOG_TMM,
+    SATLOG_LDM,
+    SATLOG_RMM,
+    SATLOG_RFP,
+    SATLOG_QUAGGA,
+    SATLOG_COMPONENTS
+};
+
+const char* const SATLOG_COMPONENT_NAMES[SATLOG_COMPONENTS] = {
+    "SatnetTmm", "SatnetLdm", "SatnetRmm", "SatnetRfp", "SatnetQuagga"
+};
+
+const uint32_t LOG_RING_RECORDS = 8192;     // per producer thread (power of 2), 2 MB
+const uint32_t LOG_MAX_ARGS = 8;
+const uint32_t LOG_PAYLOAD_BYTES = 224;
+
+enum LogArgType : uint8_t {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING
+};
+
+/**
+ * Binary log record: the format string is a literal, only the arguments are copied
+ * Strings are stored inline (u16 length + bytes) and truncated to the payload size
+ */
+struct LogRecord {
+    double time;
+    const char* format;
+    uint32_t mask;
+    uint8_t component;
+    uint8_t argCount;
+    uint16_t payloadSize;
+    uint8_t argTypes[LOG_MAX_ARGS];
+    uint8_t payload[LOG_PAYLOAD_BYTES];
+
+    void Put(const void* data, size_t size) {
+        memcpy(payload + payloadSize, data, size);
+        payloadSize += size;
+    }
+
+    bool Begin(LogArgType type, size_t size) {
+        if (argCount >= LOG_MAX_ARGS || payloadSize + size > LOG_PAYLOAD_BYTES) return false;
+        argTypes[argCount++] = type;
+        return true;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type Encode(T value) {
+        if (std::is_signed<T>::value) {
+            int64_t v = (int64_t)value;
+            if (Begin(LOG_ARG_INT, sizeof(v))) Put(&v, sizeof(v));
+        } else {
+            uint64_t v = (uint64_t)value;
+            if (Begin(LOG_ARG_UINT, sizeof(v))) Put(&v, sizeof(v));
+        }
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type Encode(T value) {
+        double v = (double)value;
+        if (Begin(LOG_ARG_DOUBLE, sizeof(v))) Put(&v, sizeof(v));
+    }
+
+    void Encode(const char* value) {
+        EncodeString(value, value ? strlen(value) : 0);
+    }
+
+    void Encode(const std::string& value) {
+        EncodeString(value.data(), value.size());
+    }
+
+    void EncodeString(const char* data, size_t length) {
+        if (argCount >= LOG_MAX_ARGS || payloadSize + sizeof(uint16_t) > LOG_PAYLOAD_BYTES) return;
+        uint16_t stored = (uint16_t)std::min(length, LOG_PAYLOAD_BYTES - payloadSize - sizeof(uint16_t));
+        Begin(LOG_ARG_STRING, sizeof(uint16_t) + stored);
+        Put(&stored, sizeof(stored));
+        Put(data, stored);
+    }
+};
+
+/**
+ * Single-producer single-consumer ring, one per logging thread
+ */
+struct LogRing {
+    alignas(64) std::atomic<uint64_t> head;     // written by the producer
+    alignas(64) std::atomic<uint64_t> tail;     // written by the writer thread
+    std::vector<LogRecord> records;
+
+    LogRing() : head(0), tail(0), records(LOG_RING_RECORDS) {}
+};
+
+/**
+ * Asynchronous logger
+ * Log() encodes the arguments into the calling thread's ring (no lock, no allocation,
+ * no formatting); a background thread formats the records with "{}" placeholders
+ * and writes them in batches. ERROR records wait until written, so they are not
+ * lost if the process aborts right after. Output goes to std::cout (std::cerr for
+ * ERROR/WARN) or to a single file. SetAsync(false) formats in the caller.
+ */
+class AsyncLogger {
+private:
+    LogComponent* m_components[SATLOG_COMPONENTS];
+    bool m_fromEnvironment[SATLOG_COMPONENTS];
+
+    std::mutex m_ringsMutex;
+    std::vector<std::unique_ptr<LogRing>> m_rings;
+    std::mutex m_writeMutex;
+    std::thread m_writer;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_running;
+    std::atomic<uint64_t> m_written;
+    std::atomic<uint64_t> m_stalls;
+    bool m_async;
+
+    std::ofstream m_file;
+    std::string m_outLine;
+    std::string m_errLine;
+
+    LogRing* ThreadRing() {
+        thread_local LogRing* ring = nullptr;
+        if (!ring) {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            m_rings.emplace_back(new LogRing());
+            ring = m_rings.back().get();
+            if (!m_writer.joinable()) {
+                m_running.store(true);
+                m_writer = std::thread(&AsyncLogger::WriterLoop, this);
+            }
+        }
+        return ring;
+    }
+
+    static void AppendArg(const LogRecord& record, uint8_t arg, size_t& offset, std::string& out) {
+        char buffer[32];
+        switch (record.argTypes[arg]) {
+            case LOG_ARG_INT: {
+                int64_t v;
+                memcpy(&v, record.payload + offset, sizeof(v));
+                offset += sizeof(v);
+#if defined(SATLOG_HAS_CHARCONV)
+                out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v).ptr - buffer);
+#else
+                out.append(buffer, snprintf(buffer, sizeof(buffer), "%lld", (long long)v));
+#endif
+                break;
+            }
+            case LOG_ARG_UINT: {
+                uint64_t v;
+                memcpy(&v, record.payload + offset, sizeof(v));
+                offset += sizeof(v);
+#if defined(SATLOG_HAS_CHARCONV)
+                out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v).ptr - buffer);
+#else
+                out.append(buffer, snprintf(buffer, sizeof(buffer), "%llu", (unsigned long long)v));
+#endif
+                break;
+            }
+            case LOG_ARG_DOUBLE: {
+                double v;
+                memcpy(&v, record.payload + offset, sizeof(v));
+                offset += sizeof(v);
+                // Same digits as std::ostream (%g); to_chars is several times faster than snprintf
+#if defined(__cpp_lib_to_chars)
+                out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v,
+                                                 std::chars_format::general, 6).ptr - buffer);
+#else
+                out.append(buffer, snprintf(buffer, sizeof(buffer), "%g", v));
+#endif
+                break;
+            }
+            case LOG_ARG_STRING: {
+                uint16_t length;
+                memcpy(&length, record.payload + offset, sizeof(length));
+                offset += sizeof(length);
+                out.append((const char*)record.payload + offset, length);
+                offset += length;
+                break;
+            }
+        }
+    }
+
+    void Format(const LogRecord& record, std::string& out) const {
+        const LogComponent* component = m_components[record.component];
+        char buffer[48];
+        if (component->IsEnabled(LOG_PREFIX_TIME)) {
+            out.append(buffer, snprintf(buffer, sizeof(buffer), "+%.9fs ", record.time));
+        }
+        if (component->IsEnabled(LOG_PREFIX_FUNC)) {
+            out.append("[").append(component->Name()).append("] ");
+        }
+        if (component->IsEnabled(LOG_PREFIX_LEVEL)) {
+            const char* level = record.mask == LOG_ERROR ? "[ERROR] " : record.mask == LOG_WARN ? "[WARN ] " :
+                                record.mask == LOG_DEBUG ? "[DEBUG] " : record.mask == LOG_INFO ? "[INFO ] " : "[LOGIC] ";
+            out.append(level);
+        }
+
+        uint8_t arg = 0;
+        size_t offset = 0;
+        const char* span = record.format;
+        for (const char* c = strchr(span, '{'); c; c = strchr(c + 1, '{')) {
+            if (c[1] != '}' || arg >= record.argCount) continue;
+            out.append(span, c - span);
+            AppendArg(record, arg++, offset, out);
+            span = c + 2;
+            c++;
+        }
+        out.append(span);
+        out.push_back('\n');
+    }
+
+    void Write(const LogRecord& record) {
+        bool toErr = !m_file.is_open() && (record.mask & (LOG_ERROR | LOG_WARN));
+        Format(record, toErr ? m_errLine : m_outLine);
+    }
+
+    /**
+     * Writes the formatted lines; caller holds m_writeMutex
+     */
+    void Emit() {
+        if (m_file.is_open()) {
+            m_file << m_outLine;
+            m_file.flush();
+        } else {
+            if (!m_errLine.empty()) std::cerr << m_errLine << std::flush;
+            if (!m_outLine.empty()) std::cout << m_outLine << std::flush;
+        }
+        m_errLine.clear();
+        m_outLine.clear();
+    }
+
+    size_t Drain() {
+        std::vector<LogRing*> rings;
+        {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            for (auto& ring : m_rings) rings.push_back(ring.get());
+        }
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        size_t count = 0;
+        for (LogRing* ring : rings) {
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail < head; tail++) {
+                Write(ring->records[tail & (LOG_RING_RECORDS - 1)]);
+                count++;
+            }
+            ring->tail.store(tail, std::memory_order_release);
+        }
+        if (count > 0) {
+            Emit();
+            m_written.fetch_add(count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    void WriterLoop() {
+        while (true) {
+            bool running = m_running.load(std::memory_order_acquire);
+            if (Drain() == 0) {
+                if (!running) break;
+                std::unique_lock<std::mutex> lock(m_wakeMutex);
+                m_wake.wait_for(lock, std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    uint64_t Produced() {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        uint64_t produced = 0;
+        for (auto& ring : m_rings) produced += ring->head.load(std::memory_order_acquire);
+        return produced;
+    }
+
+    void StopWriter() {
+        if (!m_writer.joinable()) return;
+        m_running.store(false, std::memory_order_release);
+        m_wake.notify_one();
+        m_writer.join();
+    }
+
+public:
+    AsyncLogger() : m_running(false), m_written(0), m_stalls(0), m_async(true) {
+        for (uint8_t c = 0; c < SATLOG_COMPONENTS; c++) {
+            // The LogComponent constructor applies NS_LOG; components it leaves off use the default level
+            m_components[c] = new LogComponent(SATLOG_COMPONENT_NAMES[c], __FILE__);
+            m_fromEnvironment[c] = !m_components[c]->IsNoneEnabled();
+            if (!m_fromEnvironment[c]) m_components[c]->Enable(LOG_LEVEL_INFO);
+        }
+    }
+
+    ~AsyncLogger() {
+        Shutdown();
+    }
+
+    bool IsEnabled(uint8_t component, uint32_t mask) const {
+        return m_components[component]->IsEnabled((LogLevel)mask);
+    }
+
+    template <typename... Args>
+    void Log(uint32_t mask, uint8_t component, const char* format, const Args&... args) {
+        if (!m_async) {
+            LogRecord record;
+            Fill(record, mask, component, format, args...);
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            Write(record);
+            Emit();
+            return;
+        }
+
+        LogRing* ring = ThreadRing();
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        while (head - ring->tail.load(std::memory_order_acquire) >= LOG_RING_RECORDS) {
+            m_stalls.fetch_add(1, std::memory_order_relaxed);
+            m_wake.notify_one();
+            std::this_thread::yield();
+        }
+        Fill(ring->records[head & (LOG_RING_RECORDS - 1)], mask, component, format, args...);
+        ring->head.store(head + 1, std::memory_order_release);
+        if (head - ring->tail.load(std::memory_order_relaxed) == LOG_RING_RECORDS / 2) {
+            m_wake.notify_one();     // half full: do not wait for the writer's next poll
+        }
+
+        if (mask == LOG_ERROR) Flush();
+    }
+
+    template <typename... Args>
+    static void Fill(LogRecord& record, uint32_t mask, uint8_t component, const char* format, const Args&... args) {
+        record.time = Simulator::Now().GetSeconds();
+        record.format = format;
+        record.mask = mask;
+        record.component = component;
+        record.argCount = 0;
+        record.payloadSize = 0;
+        int expand[] = {0, (record.Encode(args), 0)...};
+        (void)expand;
+    }
+
+    /**
+     * Blocks until every record logged so far is written
+     */
+    void Flush() {
+        if (!m_writer.joinable()) return;
+        uint64_t target = Produced();
+        m_wake.notify_one();
+        while (m_written.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Default level mask for the components NS_LOG does not mention (e.g. LOG_LEVEL_INFO)
+     */
+    void SetDefaultLevel(LogLevel level) {
+        for (uint8_t c = 0; c < SATLOG_COMPONENTS; c++) {
+            if (m_fromEnvironment[c]) continue;
+            m_components[c]->Disable(LOG_LEVEL_ALL);
+            m_components[c]->Enable(level);
+        }
+    }
+
+    void SetAsync(bool async) {
+        Flush();
+        m_async = async;
+    }
+
+    bool SetOutputFile(const std::string& filename) {
+        Flush();
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        m_file.open(filename, std::ios::out | std::ios::trunc);
+        if (!m_file) {
+            std::cerr << "Error opening log file " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Drains and stops the writer thread; later records are written synchronously
+     */
+    void Shutdown() {
+        StopWriter();
+        m_async = false;
+        if (m_file.is_open()) m_file.close();
+    }
+
+    uint64_t GetWrittenCount() const { return m_written.load(); }
+    uint64_t GetStallCount() const { return m_stalls.load(); }
+};
+
+inline AsyncLogger& GetLogger() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+/**
+ * Parses a --logLevel value: error, warn, debug, info or logic
+ */
+inline bool ParseLogLevel(const std::string& name, LogLevel& level) {
+    if (name == "error") level = LOG_LEVEL_ERROR;
+    else if (name == "warn") level = LOG_LEVEL_WARN;
+    else if (name == "debug") level = LOG_LEVEL_DEBUG;
+    else if (name == "info") level = LOG_LEVEL_INFO;
+    else if (name == "logic" || name == "all") level = LOG_LEVEL_LOGIC;
+    else return false;
+    return true;
+}
+
+#endif // ASYNC_LOGGER_H
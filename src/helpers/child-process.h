@@ -0,0 +1,82 @@
+#ifndef CHILD_PROCESS_H
+#define CHILD_PROCESS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/**
+ * Child processes for the drivers that run satnet-rfp (scaling, sweep)
+ * One simulation per process: ns-3 cannot reset NodeList or DCE between runs.
+ */
+
+/**
+ * Path of an executable built next to the running one (waf puts them all in build/bin)
+ */
+inline std::string SiblingExecutable(const char* argv0, const std::string& name) {
+    std::string self = argv0;
+    size_t slash = self.rfind('/');
+    return (slash == std::string::npos ? std::string(".") : self.substr(0, slash)) + "/" + name;
+}
+
+/**
+ * Forks and execs binary with args, stdout/stderr to logFile (/dev/null when empty)
+ * Returns the child pid, -1 when fork fails
+ */
+inline pid_t StartChildProcess(const std::string& binary, const std::vector<std::string>& args,
+                               const std::string& logFile) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "Error: fork failed: " << strerror(errno) << std::endl;
+        return -1;
+    }
+
+    if (pid == 0) {
+        int fd = open(logFile.empty() ? "/dev/null" : logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0) {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(binary.c_str()));
+        for (const std::string& arg : args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        execv(binary.c_str(), argv.data());
+        _exit(127);
+    }
+    return pid;
+}
+
+/**
+ * Exit code of a wait status, 128 + signal when the child was killed
+ */
+inline int ChildExitCode(int status) {
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+/**
+ * Runs the child to completion, usage receives its rusage (ru_maxrss = peak RSS)
+ */
+inline int RunChildProcess(const std::string& binary, const std::vector<std::string>& args,
+                           const std::string& logFile, struct rusage& usage) {
+    pid_t pid = StartChildProcess(binary, args, logFile);
+    if (pid < 0) return -1;
+
+    int status = 0;
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        std::cerr << "Error: wait4 failed: " << strerror(errno) << std::endl;
+        return -1;
+    }
+    return ChildExitCode(status);
+}
+
+#endif // CHILD_PROCESS_H
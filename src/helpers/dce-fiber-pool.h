@@ -0,0 +1,259 @@
+#ifndef DCE_FIBER_POOL_H
+#define DCE_FIBER_POOL_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "async-logger.h"
+#include "../core/instrumentation.h"
+
+using namespace ns3;
+
+const uint32_t DCE_STACK_VTYSH = 1 << 16;       // Previous fixed vtysh stack
+const double DCE_STACK_HEADROOM = 1.25;         // Over the measured high-water mark
+const uint32_t DCE_STACK_ALIGN = 4096;
+const uint32_t VTYSH_SLOTS_PER_NODE = 1;        // vtysh processes alive at once on a node
+const uint32_t VTYSH_MAX_BATCH = 16;            // -c commands per vtysh process
+const double VTYSH_START_DELAY = 0.1;           // s from the spawn to the process start
+const double VTYSH_SLOT_TIMEOUT = 5.0;          // s before a slot whose process never exits is reclaimed
+
+/**
+ * Stack budget of the DCE processes launched for Quagga (zebra, ospfd, vtysh)
+ *
+ * - Stack size per binary: a profile file of measured high-water marks
+ *   ("binary bytes" lines, DCE_STACK_HEADROOM added, page aligned) or explicit sizes;
+ *   0 keeps the size DCE or the Quagga helper would use.
+ * - vtysh slots: commands for a node are queued and run as one vtysh process with
+ *   several -c arguments; at most VTYSH_SLOTS_PER_NODE run at once per node and the
+ *   next batch takes the slot when the previous process exits. DCE frees a fiber stack
+ *   when its process ends, so the stacks reserved for vtysh stay bounded by the slots
+ *   instead of growing with the command rate.
+ * - Sequences: a caller's commands ("configure terminal" then "ip route ...") are queued
+ *   as one unit; batches are cut between units only, so a sequence never runs split
+ *   over two vtysh processes (a unit longer than VTYSH_MAX_BATCH runs alone).
+ * - A process still alive after VTYSH_SLOT_TIMEOUT gives its slot back, but its stack
+ *   stays counted as reserved until DCE reports the exit.
+ * - Accounting: fibers alive and stack bytes reserved, current and peak.
+ *
+ * Guard pages are set by the DCE fiber manager itself; nothing here adds any.
+ */
+class DceFiberPool {
+public:
+    typedef std::function<bool(Ptr<Node>, const std::vector<std::string>&, uint32_t, uint64_t)> SpawnFunction;
+
+private:
+    struct NodeQueue {
+        std::deque<std::vector<std::string>> units;
+        uint32_t busySlots;
+        bool flushPending;
+
+        NodeQueue() : busySlots(0), flushPending(false) {}
+    };
+
+    std::map<std::string, uint32_t> m_stackSizes;
+    std::map<uint32_t, NodeQueue> m_queues;
+    struct Process {
+        uint32_t node;
+        uint32_t stackSize;
+        bool holdsSlot;     // false once the slot was reclaimed on timeout
+    };
+
+    std::map<uint64_t, Process> m_running;      // By process token
+    SpawnFunction m_spawn;
+    uint64_t m_nextToken;
+
+    uint32_t m_alive;
+    uint32_t m_peakAlive;
+    uint64_t m_reservedBytes;
+    uint64_t m_peakReservedBytes;
+    uint64_t m_processes;
+    uint64_t m_commands;
+    uint64_t m_timedOut;
+
+    void Reserve(uint32_t stackSize) {
+        m_alive++;
+        m_reservedBytes += stackSize;
+        m_peakAlive = std::max(m_peakAlive, m_alive);
+        m_peakReservedBytes = std::max(m_peakReservedBytes, m_reservedBytes);
+    }
+
+    void Release(uint32_t stackSize) {
+        m_alive--;
+        m_reservedBytes -= stackSize;
+    }
+
+    void ScheduleFlush(uint32_t nodeId, NodeQueue& queue) {
+        if (queue.flushPending) return;
+        queue.flushPending = true;
+        Simulator::ScheduleNow(&DceFiberPool::Flush, this, nodeId);
+    }
+
+    /**
+     * Commands queued during one simulation instant share a vtysh process
+     */
+    void Flush(uint32_t nodeId) {
+        NodeQueue& queue = m_queues[nodeId];
+        queue.flushPending = false;
+
+        while (!queue.units.empty() && queue.busySlots < VTYSH_SLOTS_PER_NODE) {
+            // Whole units only: the first one always goes, the next ones while they fit
+            std::vector<std::string> batch;
+            do {
+                const std::vector<std::string>& unit = queue.units.front();
+                batch.insert(batch.end(), unit.begin(), unit.end());
+                queue.units.pop_front();
+            } while (!queue.units.empty() && batch.size() + queue.units.front().size() <= VTYSH_MAX_BATCH);
+
+            uint32_t stackSize = GetStackSize("vtysh", DCE_STACK_VTYSH);
+            uint64_t token = m_nextToken++;
+            if (!m_spawn || !m_spawn(NodeList::GetNode(nodeId), batch, stackSize, token)) {
+                SATNET_COUNT(COUNTER_VTYSH_SIMULATED, batch.size());
+                continue;
+            }
+
+            queue.busySlots++;
+            m_running[token] = {nodeId, stackSize, true};
+            Reserve(stackSize);
+            m_processes++;
+            Simulator::Schedule(Seconds(VTYSH_START_DELAY + VTYSH_SLOT_TIMEOUT), &DceFiberPool::OnTimeout, this, token);
+        }
+    }
+
+    void FreeSlot(uint32_t nodeId) {
+        NodeQueue& queue = m_queues[nodeId];
+        queue.busySlots--;
+        if (!queue.units.empty()) {
+            ScheduleFlush(nodeId, queue);
+        }
+    }
+
+    /**
+     * The fiber may still be alive: only the slot is freed, the stack waits for the exit
+     */
+    void OnTimeout(uint64_t token) {
+        auto it = m_running.find(token);
+        if (it == m_running.end() || !it->second.holdsSlot) return;
+        m_timedOut++;
+        SATLOG_WARN(SATLOG_QUAGGA, "vtysh process {} still running after {}s, slot reclaimed", token, VTYSH_SLOT_TIMEOUT);
+        it->second.holdsSlot = false;
+        FreeSlot(it->second.node);
+    }
+
+public:
+    DceFiberPool()
+        : m_nextToken(1), m_alive(0), m_peakAlive(0), m_reservedBytes(0), m_peakReservedBytes(0),
+          m_processes(0), m_commands(0), m_timedOut(0) {}
+
+    /**
+     * Launches one vtysh process for a batch; returns false when it could not be started
+     */
+    void SetSpawnFunction(SpawnFunction spawn) {
+        m_spawn = spawn;
+    }
+
+    void SetStackSize(const std::string& binary, uint32_t bytes) {
+        if (bytes > 0) m_stackSizes[binary] = bytes;
+    }
+
+    uint32_t GetStackSize(const std::string& binary, uint32_t fallback = 0) const {
+        auto it = m_stackSizes.find(binary);
+        return it != m_stackSizes.end() ? it->second : fallback;
+    }
+
+    /**
+     * Profile lines: "<binary> <high-water mark in bytes>", '#' comments
+     */
+    bool LoadProfile(const std::string& path, std::string& error) {
+        std::ifstream in(path);
+        if (!in.is_open()) {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::string line;
+        uint32_t lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+            std::istringstream fields(line);
+            std::string binary;
+            uint64_t highWater = 0;
+            if (!(fields >> binary)) continue;
+            if (!(fields >> highWater) || highWater == 0) {
+                error = path + ":" + std::to_string(lineNumber) + ": expected \"<binary> <bytes>\"";
+                return false;
+            }
+            uint64_t size = (uint64_t)(highWater * DCE_STACK_HEADROOM);
+            size = (size + DCE_STACK_ALIGN - 1) / DCE_STACK_ALIGN * DCE_STACK_ALIGN;
+            m_stackSizes[binary] = (uint32_t)size;
+        }
+        return true;
+    }
+
+    /**
+     * A long-running daemon fiber (zebra, ospfd) from startTime to the end of the run
+     */
+    void AddDaemon(uint32_t stackSize, double startTime) {
+        Simulator::Schedule(Seconds(startTime), &DceFiberPool::Reserve, this, stackSize);
+    }
+
+    /**
+     * Queues a command sequence that must run in order in the same vtysh process
+     */
+    void QueueVtysh(Ptr<Node> node, const std::vector<std::string>& commands) {
+        if (commands.empty()) return;
+        NodeQueue& queue = m_queues[node->GetId()];
+        queue.units.push_back(commands);
+        m_commands += commands.size();
+        ScheduleFlush(node->GetId(), queue);
+    }
+
+    /**
+     * The vtysh process of this token exited: its stack is freed, its slot (unless
+     * already reclaimed on timeout) takes the next batch
+     */
+    void OnProcessExit(uint64_t token) {
+        auto it = m_running.find(token);
+        if (it == m_running.end()) return;
+        Process process = it->second;
+        Release(process.stackSize);
+        m_running.erase(it);
+
+        if (process.holdsSlot) {
+            FreeSlot(process.node);
+        }
+    }
+
+    uint32_t GetPeakAlive() const { return m_peakAlive; }
+    uint64_t GetPeakReservedBytes() const { return m_peakReservedBytes; }
+    uint64_t GetProcesses() const { return m_processes; }
+
+    void PrintStatistics() const {
+        std::cout << "DCE fiber statistics:" << std::endl;
+        std::cout << "   Peak fibers alive: " << m_peakAlive << std::endl;
+        std::cout << "   Peak stack reserved: " << m_peakReservedBytes / 1024 << " KiB" << std::endl;
+        std::cout << "   vtysh processes: " << m_processes << " for " << m_commands << " commands";
+        if (m_timedOut > 0) {
+            std::cout << " (" << m_timedOut << " slots reclaimed)";
+        }
+        std::cout << std::endl;
+        for (const auto& entry : m_stackSizes) {
+            std::cout << "   Stack " << entry.first << ": " << entry.second / 1024 << " KiB" << std::endl;
+        }
+    }
+};
+
+inline DceFiberPool& GetDceFiberPool() {
+    static DceFiberPool pool;
+    return pool;
+}
+
+#endif // DCE_FIBER_POOL_H
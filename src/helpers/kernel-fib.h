@@ -0,0 +1,101 @@
+#ifndef KERNEL_FIB_H
+#define KERNEL_FIB_H
+
+#include <vector>
+#include <map>
+#include <cstdint>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+using namespace ns3;
+
+const int KERNEL_FIB_NO_ROUTE = -1;
+
+/**
+ * Reads the forwarding table zebra installs in a DCE node (Ipv4DceRouting, an
+ * Ipv4StaticRouting under the node's Ipv4ListRouting), for a fixed set of prefixes
+ *
+ * Gateways are mapped back to node ids through the interface addresses registered at
+ * setup. A node's table is scanned at most once per simulation instant; later reads at
+ * the same time use the cached next hops.
+ */
+class KernelFibReader {
+private:
+    std::map<uint32_t, int> m_nodeOfAddress;
+    std::map<std::pair<uint32_t, uint16_t>, uint32_t> m_prefixIndex;     // (network, length) -> prefix
+    std::vector<std::vector<int>> m_nextHops;                          // Per node, per prefix
+    std::vector<int64_t> m_readAt;                                     // Per node, time step of the cache
+    uint64_t m_scans;
+
+    void Scan(uint32_t node, std::vector<int>& nextHops) {
+        m_scans++;
+        nextHops.assign(m_prefixIndex.size(), KERNEL_FIB_NO_ROUTE);
+
+        Ptr<Node> ptr = NodeList::GetNode(node);
+        Ptr<Ipv4> ipv4 = ptr ? ptr->GetObject<Ipv4>() : Ptr<Ipv4>();
+        if (!ipv4) return;
+
+        std::vector<Ptr<Ipv4StaticRouting>> tables;
+        Ptr<Ipv4RoutingProtocol> protocol = ipv4->GetRoutingProtocol();
+        Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting>(protocol);
+        if (list) {
+            for (uint32_t i = 0; i < list->GetNRoutingProtocols(); i++) {
+                int16_t priority = 0;
+                Ptr<Ipv4StaticRouting> table = DynamicCast<Ipv4StaticRouting>(list->GetRoutingProtocol(i, priority));
+                if (table) tables.push_back(table);
+            }
+        } else if (Ptr<Ipv4StaticRouting> table = DynamicCast<Ipv4StaticRouting>(protocol)) {
+            tables.push_back(table);
+        }
+
+        // First gateway route per prefix, as the lookup of Ipv4StaticRouting picks it
+        for (const Ptr<Ipv4StaticRouting>& table : tables) {
+            for (uint32_t i = 0; i < table->GetNRoutes(); i++) {
+                Ipv4RoutingTableEntry route = table->GetRoute(i);
+                if (!route.IsGateway()) continue;
+                auto prefix = m_prefixIndex.find(std::make_pair(route.GetDestNetwork().Get(),
+                                                                route.GetDestNetworkMask().GetPrefixLength()));
+                if (prefix == m_prefixIndex.end() || nextHops[prefix->second] != KERNEL_FIB_NO_ROUTE) continue;
+                auto gateway = m_nodeOfAddress.find(route.GetGateway().Get());
+                if (gateway != m_nodeOfAddress.end()) nextHops[prefix->second] = gateway->second;
+            }
+        }
+    }
+
+public:
+    KernelFibReader() : m_scans(0) {}
+
+    void AddAddress(Ipv4Address address, uint32_t node) {
+        m_nodeOfAddress[address.Get()] = node;
+    }
+
+    /**
+     * Prefixes are numbered in registration order
+     */
+    uint32_t AddPrefix(Ipv4Address network, uint16_t prefixLength) {
+        uint32_t index = m_prefixIndex.size();
+        m_prefixIndex.insert(std::make_pair(std::make_pair(network.Get(), prefixLength), index));
+        return index;
+    }
+
+    /**
+     * Next hop (node id) of a node towards a prefix, KERNEL_FIB_NO_ROUTE without a route
+     */
+    int NextHop(uint32_t node, uint32_t prefix) {
+        if (node >= m_nextHops.size()) {
+            m_nextHops.resize(node + 1);
+            m_readAt.resize(node + 1, -1);
+        }
+        int64_t now = Simulator::Now().GetTimeStep();
+        if (m_readAt[node] != now) {
+            Scan(node, m_nextHops[node]);
+            m_readAt[node] = now;
+        }
+        return prefix < m_nextHops[node].size() ? m_nextHops[node][prefix] : KERNEL_FIB_NO_ROUTE;
+    }
+
+    uint64_t GetScans() const { return m_scans; }
+};
+
+#endif // KERNEL_FIB_H
@@ -0,0 +1,129 @@
+#ifndef PLANE_PARTITION_H
+#define PLANE_PARTITION_H
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "../core/constellation-params.h"
+#include "../core/constellation-config.h"
+#include "satellite-channel.h"
+
+using namespace ns3;
+
+const uint32_t LOOKAHEAD_SAMPLES_PER_ORBIT = 720;
+const double LOOKAHEAD_SAFETY_FACTOR = 0.9;     // Margin for the range minimum between two samples
+
+/**
+ * Orbital planes to distributed simulator ranks (ns-3 system ids)
+ * Rank r owns a contiguous block of planes, so intra-plane ISLs stay on one rank and
+ * only inter-plane ISLs (and GSLs to satellites off rank 0) cross ranks. Ground
+ * stations and the Earth node live on rank 0. Every rank builds the whole topology;
+ * a node only runs events on the rank that owns it.
+ */
+class PlanePartition {
+private:
+    uint32_t m_ranks;
+    std::vector<uint32_t> m_rankOf;         // Per satellite
+    std::vector<uint32_t> m_planesOf;       // Per rank
+    uint32_t m_localLinks;
+    uint32_t m_crossLinks;
+
+public:
+    PlanePartition() : m_ranks(1), m_localLinks(0), m_crossLinks(0) {}
+
+    /**
+     * Returns false when there are more ranks than planes
+     */
+    bool Build(const ConstellationConfig& constellation, uint32_t ranks) {
+        uint32_t planes = constellation.GetPlaneCount();
+        if (ranks == 0 || ranks > planes) return false;
+
+        m_ranks = ranks;
+        m_rankOf.assign(constellation.GetSatelliteCount(), 0);
+        m_planesOf.assign(ranks, 0);
+        for (uint32_t sat = 0; sat < m_rankOf.size(); sat++) {
+            m_rankOf[sat] = RankOfPlane(constellation.PlaneOf(sat), planes);
+        }
+        for (uint32_t p = 0; p < planes; p++) {
+            m_planesOf[RankOfPlane(p, planes)]++;
+        }
+        return true;
+    }
+
+    uint32_t RankOfPlane(uint32_t plane, uint32_t planes) const {
+        return (uint64_t)plane * m_ranks / planes;
+    }
+
+    uint32_t RankOf(uint32_t sat) const { return sat < m_rankOf.size() ? m_rankOf[sat] : 0; }
+    uint32_t GetRanks() const { return m_ranks; }
+
+    bool IsCrossRank(uint32_t satA, uint32_t satB) const {
+        return RankOf(satA) != RankOf(satB);
+    }
+
+    /**
+     * Satellite nodes in index order (node id = satellite index), each created on its rank
+     */
+    void CreateSatellites(NodeContainer& satellites) const {
+        for (uint32_t sat = 0; sat < m_rankOf.size(); sat++) {
+            satellites.Create(1, m_rankOf[sat]);
+        }
+    }
+
+    void CountLinks(const std::vector<std::pair<uint32_t, uint32_t>>& links) {
+        m_localLinks = 0;
+        m_crossLinks = 0;
+        for (const auto& link : links) {
+            if (IsCrossRank(link.first, link.second)) m_crossLinks++;
+            else m_localLinks++;
+        }
+    }
+
+    /**
+     * Conservative lookahead: smallest range delay of a cross-rank ISL over one orbit of
+     * the slowest plane (sampled, then LOOKAHEAD_SAFETY_FACTOR), capped by maxDelay.
+     * SatelliteIslRemoteChannel clamps any shorter delay to this value.
+     */
+    Time ComputeLookahead(const ConstellationConfig& constellation,
+                          const std::vector<std::pair<uint32_t, uint32_t>>& links, Time maxDelay) const {
+        std::vector<std::pair<uint32_t, uint32_t>> cross;
+        for (const auto& link : links) {
+            if (IsCrossRank(link.first, link.second)) cross.push_back(link);
+        }
+        if (cross.empty()) return maxDelay;
+
+        double orbit = 0.0;
+        for (uint32_t p = 0; p < constellation.GetPlaneCount(); p++) {
+            orbit = std::max(orbit, 2 * PI / constellation.GetPlane(p).meanMotion);
+        }
+
+        std::vector<OrbitalState> states;
+        double minRange = 1e12;
+        for (uint32_t i = 0; i < LOOKAHEAD_SAMPLES_PER_ORBIT; i++) {
+            constellation.Propagate(orbit * i / LOOKAHEAD_SAMPLES_PER_ORBIT, states);
+            for (const auto& link : cross) {
+                const OrbitalState& a = states[link.first];
+                const OrbitalState& b = states[link.second];
+                double dx = a.unit.x * a.radiusKm - b.unit.x * b.radiusKm;
+                double dy = a.unit.y * a.radiusKm - b.unit.y * b.radiusKm;
+                double dz = a.unit.z * a.radiusKm - b.unit.z * b.radiusKm;
+                minRange = std::min(minRange, std::sqrt(dx * dx + dy * dy + dz * dz));
+            }
+        }
+
+        Time lookahead = Seconds(minRange * LOOKAHEAD_SAFETY_FACTOR / SPEED_OF_LIGHT_KM_S);
+        return std::min(lookahead, maxDelay);
+    }
+
+    void Print(uint32_t rank, Time lookahead) const {
+        std::cout << "Partition: rank " << rank << " of " << m_ranks << ", " << m_planesOf[rank]
+                  << " planes, " << std::count(m_rankOf.begin(), m_rankOf.end(), rank) << " satellites" << std::endl;
+        std::cout << "   ISLs: " << m_localLinks << " rank-local, " << m_crossLinks << " cross-rank" << std::endl;
+        std::cout << "   Lookahead: " << lookahead.GetMicroSeconds() << " us" << std::endl;
+    }
+};
+
+#endif // PLANE_PARTITION_H
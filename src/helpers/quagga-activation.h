@@ -0,0 +1,170 @@
+#ifndef QUAGGA_ACTIVATION_H
+#define QUAGGA_ACTIVATION_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+const uint32_t QUAGGA_REGION_NOT_ACTIVE = UINT32_MAX;
+const double QUAGGA_OSPFD_DELAY = 1.0;      // s from zebra to ospfd on a node (ospfd connects to zebra)
+
+/**
+ * Which satellites run Quagga under DCE, and when their daemons start
+ *
+ * Region selection:
+ * - first: satellites 0..count-1 (the historical quaggaNodes behaviour)
+ * - all: every satellite
+ * - path: region of interest, i.e. the shortest ISL paths between the satellites that
+ *   serve the ground stations during the run, plus every satellite within k hops
+ *
+ * Active satellites are ordered by hop distance from the paths (ground station side
+ * first) and started in waves of waveSize nodes at rate nodes per second, so the DCE
+ * fibers and daemon memory build up gradually. Satellites outside the region keep no
+ * DCE state at all; the OSPF model computes their routes.
+ */
+class QuaggaActivation {
+private:
+    uint32_t m_numSatellites;
+    std::vector<uint32_t> m_distance;       // Per satellite, hops from the paths (NOT_ACTIVE outside)
+    std::vector<uint32_t> m_order;          // Active satellites, start order
+    std::vector<double> m_startTime;        // Per satellite, start of its zebra (< 0 outside)
+    uint32_t m_coreSize;
+    uint32_t m_waves;
+    double m_lastWave;
+
+    void Activate(uint32_t sat, uint32_t distance) {
+        m_distance[sat] = distance;
+        m_order.push_back(sat);
+    }
+
+    void Reset(uint32_t numSatellites) {
+        m_numSatellites = numSatellites;
+        m_distance.assign(numSatellites, QUAGGA_REGION_NOT_ACTIVE);
+        m_startTime.assign(numSatellites, -1.0);
+        m_order.clear();
+        m_coreSize = 0;
+        m_waves = 0;
+        m_lastWave = 0.0;
+    }
+
+public:
+    QuaggaActivation() : m_numSatellites(0), m_coreSize(0), m_waves(0), m_lastWave(0.0) {}
+
+    void SelectFirst(uint32_t numSatellites, uint32_t count) {
+        Reset(numSatellites);
+        for (uint32_t sat = 0; sat < std::min(count, numSatellites); sat++) {
+            Activate(sat, 0);
+        }
+        m_coreSize = m_order.size();
+    }
+
+    void SelectAll(uint32_t numSatellites) {
+        SelectFirst(numSatellites, numSatellites);
+    }
+
+    /**
+     * anchors: satellites serving the traffic endpoints (sorted, unique)
+     * Returns false when no anchor is a valid satellite
+     */
+    bool SelectRegion(uint32_t numSatellites, const std::vector<std::pair<uint32_t, uint32_t>>& links,
+                      const std::vector<uint32_t>& anchors, uint32_t hops) {
+        Reset(numSatellites);
+
+        std::vector<std::vector<uint32_t>> adjacency(numSatellites);
+        for (const auto& link : links) {
+            if (link.first >= numSatellites || link.second >= numSatellites) continue;
+            adjacency[link.first].push_back(link.second);
+            adjacency[link.second].push_back(link.first);
+        }
+
+        // Core: the anchors and a shortest path between every pair of them
+        std::vector<bool> core(numSatellites, false);
+        std::vector<uint32_t> parent(numSatellites);
+        std::vector<uint32_t> queue;
+        queue.reserve(numSatellites);
+        for (uint32_t i = 0; i < anchors.size(); i++) {
+            uint32_t source = anchors[i];
+            if (source >= numSatellites) continue;
+            core[source] = true;
+
+            std::fill(parent.begin(), parent.end(), QUAGGA_REGION_NOT_ACTIVE);
+            parent[source] = source;
+            queue.assign(1, source);
+            for (size_t head = 0; head < queue.size(); head++) {
+                for (uint32_t next : adjacency[queue[head]]) {
+                    if (parent[next] != QUAGGA_REGION_NOT_ACTIVE) continue;
+                    parent[next] = queue[head];
+                    queue.push_back(next);
+                }
+            }
+            for (uint32_t j = i + 1; j < anchors.size(); j++) {
+                uint32_t node = anchors[j];
+                if (node >= numSatellites || parent[node] == QUAGGA_REGION_NOT_ACTIVE) continue;
+                for (; node != source; node = parent[node]) {
+                    core[node] = true;
+                }
+            }
+        }
+
+        // Core first, then the k-hop neighbourhood in BFS order
+        for (uint32_t sat = 0; sat < numSatellites; sat++) {
+            if (core[sat]) Activate(sat, 0);
+        }
+        m_coreSize = m_order.size();
+        for (size_t head = 0; head < m_order.size(); head++) {
+            uint32_t node = m_order[head];
+            if (m_distance[node] >= hops) continue;
+            for (uint32_t next : adjacency[node]) {
+                if (m_distance[next] == QUAGGA_REGION_NOT_ACTIVE) {
+                    Activate(next, m_distance[node] + 1);
+                }
+            }
+        }
+        return m_coreSize > 0;
+    }
+
+    /**
+     * Start times in the selection order. rate <= 0: every node at firstWave.
+     */
+    void ScheduleWaves(double firstWave, uint32_t waveSize, double rate) {
+        waveSize = std::max(waveSize, 1u);
+        double waveInterval = rate > 0.0 ? waveSize / rate : 0.0;
+        m_waves = 0;
+        m_lastWave = firstWave;
+        for (uint32_t i = 0; i < m_order.size(); i++) {
+            uint32_t wave = i / waveSize;
+            m_startTime[m_order[i]] = firstWave + wave * waveInterval;
+            m_waves = wave + 1;
+            m_lastWave = m_startTime[m_order[i]];
+        }
+    }
+
+    bool IsActive(uint32_t sat) const {
+        return sat < m_numSatellites && m_distance[sat] != QUAGGA_REGION_NOT_ACTIVE;
+    }
+
+    double GetStartTime(uint32_t sat) const { return sat < m_numSatellites ? m_startTime[sat] : -1.0; }
+    const std::vector<uint32_t>& GetOrder() const { return m_order; }
+    uint32_t GetActiveCount() const { return m_order.size(); }
+    uint32_t GetWaveCount() const { return m_waves; }
+    double GetLastWave() const { return m_lastWave; }
+
+    void Print(const std::string& region, uint32_t hops) const {
+        std::cout << "Quagga activation: " << region << ", " << m_order.size() << "/" << m_numSatellites
+                  << " satellites";
+        if (region == "path") {
+            std::cout << " (" << m_coreSize << " on the paths, +" << hops << " hops)";
+        }
+        std::cout << std::endl;
+        if (m_waves > 1) {
+            std::cout << "   " << m_waves << " waves, last at t=" << m_lastWave << "s" << std::endl;
+        }
+    }
+};
+
+#endif // QUAGGA_ACTIVATION_H
@@ -0,0 +1,293 @@
+#ifndef QUAGGA_CONFIG_H
+#define QUAGGA_CONFIG_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cerrno>
+#include <sys/stat.h>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "../core/ospf-timers.h"
+
+using namespace ns3;
+
+const char* const DCE_NODE_DIR_PREFIX = "files-";           // DCE per-node root, files-<node id>
+const char* const QUAGGA_CONF_DIR = "/usr/local/etc";       // Where QuaggaHelper points zebra/ospfd
+const char* const DCE_IFNAME_PREFIX = "ns3-device";         // DCE name of Ipv4 interface i (ns-3 stack)
+const uint32_t QUAGGA_DEFAULT_COST = 10;
+const uint32_t QUAGGA_RENDER_MAX_THREADS = 8;
+const uint32_t QUAGGA_HELLO_MULTIPLIER_MAX = 10;            // "hello-multiplier <1-10>": hellos down to 100 ms
+
+/**
+ * mkdir -p without a shell
+ */
+inline bool MakeDirectories(const std::string& path) {
+    for (size_t pos = 1; pos <= path.size(); pos++) {
+        if (pos < path.size() && path[pos] != '/') continue;
+        std::string prefix = path.substr(0, pos);
+        if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline std::string FormatIpv4(uint32_t address) {
+    std::ostringstream out;
+    out << (address >> 24) << "." << ((address >> 16) & 0xff) << "." << ((address >> 8) & 0xff) << "." << (address & 0xff);
+    return out.str();
+}
+
+/**
+ * Config templates: {name} placeholders, {interfaces} expands one block per interface
+ */
+const char* const QUAGGA_ZEBRA_TEMPLATE =
+    "hostname {hostname}\n"
+    "password zebra\n"
+    "enable password zebra\n"
+    "log stdout\n"
+    "!\n"
+    "interface lo\n"
+    "!\n"
+    "{interfaces}"
+    "line vty\n"
+    " exec-timeout 0 0\n"
+    "!\n";
+
+const char* const QUAGGA_ZEBRA_INTERFACE_TEMPLATE =
+    "interface {ifname}\n"
+    " description {address}/{prefix}\n"
+    " link-detect\n"
+    "!\n";
+
+const char* const QUAGGA_OSPFD_TEMPLATE =
+    "hostname {hostname}\n"
+    "password zebra\n"
+    "enable password zebra\n"
+    "log stdout\n"
+    "!\n"
+    "{interfaces}"
+    "router ospf\n"
+    " ospf router-id {router_id}\n"
+    "{router_timers}"
+    " network {network} area 0.0.0.0\n"
+    "!\n"
+    "line vty\n"
+    " exec-timeout 0 0\n"
+    "!\n";
+
+const char* const QUAGGA_OSPFD_INTERFACE_TEMPLATE =
+    "interface {ifname}\n"
+    " ip ospf cost {cost}\n"
+    "{timers}"
+    "!\n";
+
+/**
+ * Replaces every {key} of the template with its value
+ */
+inline std::string RenderTemplate(const std::string& text, const std::map<std::string, std::string>& values) {
+    std::string out;
+    out.reserve(text.size() * 2);
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t open = text.find('{', pos);
+        size_t close = open == std::string::npos ? std::string::npos : text.find('}', open);
+        if (close == std::string::npos) {
+            out.append(text, pos, std::string::npos);
+            break;
+        }
+        out.append(text, pos, open - pos);
+        auto it = values.find(text.substr(open + 1, close - open - 1));
+        if (it != values.end()) {
+            out += it->second;
+        } else {
+            out.append(text, open, close - open + 1);
+        }
+        pos = close + 1;
+    }
+    return out;
+}
+
+/**
+ * Per-node zebra.conf / ospfd.conf, written into each DCE node's files-<id> tree
+ *
+ * Every node gets a unique router-id (its node id + 1, dotted), the SPF throttle of the
+ * OSPF profile and, for each interface known at setup (ISLs), its OSPF cost
+ * and hello/dead timers, so ospfd starts with the final configuration and nothing is
+ * pushed through vtysh at startup. Interfaces created at run time (GSL handovers) are
+ * covered by the network statement with Quagga's default timers on both ends.
+ * Sub-second hellos use Quagga's fast hello form (dead interval 1 s, hello multiplier).
+ * LSA pacing stays at Quagga 0.99's fixed 5 s: "timers throttle lsa" is Quagga 1.x only,
+ * and 0.99's ospfd refuses to start on a line it does not know.
+ *
+ * Call Render() after QuaggaHelper::Install, which writes its own generic files there.
+ */
+class QuaggaConfigWriter {
+private:
+    struct Interface {
+        uint32_t ifIndex;
+        uint32_t address;
+        uint16_t prefixLength;
+        uint32_t cost;
+    };
+
+    struct NodeConfig {
+        std::string hostname;
+        std::string network;
+        std::vector<Interface> interfaces;
+    };
+
+    std::string m_root;
+    OspfTimers m_timers;
+    std::map<uint32_t, NodeConfig> m_nodes;
+    uint32_t m_rendered;
+    uint64_t m_bytes;
+
+    std::string TimersBlock() const {
+        std::ostringstream out;
+        if (m_timers.helloInterval < 1.0) {
+            long multiplier = std::lround(1.0 / m_timers.helloInterval);
+            multiplier = std::min<long>(std::max<long>(multiplier, 1), QUAGGA_HELLO_MULTIPLIER_MAX);
+            out << " ip ospf dead-interval minimal hello-multiplier " << multiplier << "\n";
+        } else {
+            out << " ip ospf hello-interval " << std::lround(m_timers.helloInterval) << "\n";
+            out << " ip ospf dead-interval " << std::lround(m_timers.deadInterval) << "\n";
+        }
+        return out.str();
+    }
+
+    /**
+     * SPF throttle (ms), which Quagga 0.99 accepts
+     */
+    std::string RouterTimersBlock() const {
+        std::ostringstream out;
+        out << " timers throttle spf " << std::lround(m_timers.spfDelay * 1000.0) << " "
+            << std::lround(m_timers.spfHold * 1000.0) << " " << std::lround(m_timers.spfMaxHold * 1000.0) << "\n";
+        return out.str();
+    }
+
+    bool WriteFile(const std::string& path, const std::string& text, std::string& error) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open() || !(out << text)) {
+            error = "cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    bool RenderNode(uint32_t nodeId, const NodeConfig& node, uint64_t& bytes, std::string& error) {
+        std::string dir = m_root + "/" + DCE_NODE_DIR_PREFIX + std::to_string(nodeId) + QUAGGA_CONF_DIR;
+        if (!MakeDirectories(dir)) {
+            error = "cannot create " + dir;
+            return false;
+        }
+
+        std::string zebraInterfaces, ospfdInterfaces;
+        std::string timers = TimersBlock();
+        for (const Interface& iface : node.interfaces) {
+            std::map<std::string, std::string> values = {
+                {"ifname", DCE_IFNAME_PREFIX + std::to_string(iface.ifIndex)},
+                {"address", FormatIpv4(iface.address)},
+                {"prefix", std::to_string(iface.prefixLength)},
+                {"cost", std::to_string(iface.cost)},
+                {"timers", timers}};
+            zebraInterfaces += RenderTemplate(QUAGGA_ZEBRA_INTERFACE_TEMPLATE, values);
+            ospfdInterfaces += RenderTemplate(QUAGGA_OSPFD_INTERFACE_TEMPLATE, values);
+        }
+
+        std::map<std::string, std::string> values = {
+            {"hostname", node.hostname},
+            {"router_id", RouterId(nodeId)},
+            {"network", node.network},
+            {"router_timers", RouterTimersBlock()},
+            {"interfaces", zebraInterfaces}};
+        std::string zebra = RenderTemplate(QUAGGA_ZEBRA_TEMPLATE, values);
+        values["interfaces"] = ospfdInterfaces;
+        std::string ospfd = RenderTemplate(QUAGGA_OSPFD_TEMPLATE, values);
+
+        bytes += zebra.size() + ospfd.size();
+        return WriteFile(dir + "/zebra.conf", zebra, error) && WriteFile(dir + "/ospfd.conf", ospfd, error);
+    }
+
+public:
+    QuaggaConfigWriter(const OspfTimers& timers, const std::string& root = ".")
+        : m_root(root), m_timers(timers), m_rendered(0), m_bytes(0) {}
+
+    static std::string RouterId(uint32_t nodeId) {
+        return FormatIpv4(nodeId + 1);
+    }
+
+    /**
+     * A node running Quagga; network is the ospfd "network" statement (area 0)
+     */
+    void AddNode(uint32_t nodeId, const std::string& hostname, const std::string& network) {
+        NodeConfig& node = m_nodes[nodeId];
+        node.hostname = hostname;
+        node.network = network;
+    }
+
+    /**
+     * An interface of a node (ignored at render time if the node runs no Quagga)
+     */
+    void AddInterface(uint32_t nodeId, uint32_t ifIndex, Ipv4Address address, uint16_t prefixLength,
+                      uint32_t cost = QUAGGA_DEFAULT_COST) {
+        m_nodes[nodeId].interfaces.push_back({ifIndex, address.Get(), prefixLength, cost});
+    }
+
+    /**
+     * Writes every node's files, nodes spread over up to QUAGGA_RENDER_MAX_THREADS threads
+     */
+    bool Render(std::string& error) {
+        std::vector<std::pair<uint32_t, const NodeConfig*>> nodes;
+        for (const auto& entry : m_nodes) {
+            if (!entry.second.hostname.empty()) nodes.push_back(std::make_pair(entry.first, &entry.second));
+        }
+
+        uint32_t threads = std::min<uint32_t>(QUAGGA_RENDER_MAX_THREADS, std::max(1u, std::thread::hardware_concurrency()));
+        threads = std::max<uint32_t>(1, std::min<uint32_t>(threads, nodes.size()));
+        std::atomic<size_t> next(0);
+        std::vector<uint64_t> bytes(threads, 0);
+        std::vector<std::string> errors(threads);
+
+        auto worker = [&](uint32_t t) {
+            for (size_t i = next++; i < nodes.size(); i = next++) {
+                if (!RenderNode(nodes[i].first, *nodes[i].second, bytes[t], errors[t])) return;
+            }
+        };
+        std::vector<std::thread> pool;
+        for (uint32_t t = 1; t < threads; t++) {
+            pool.emplace_back(worker, t);
+        }
+        worker(0);
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+
+        m_rendered = nodes.size();
+        m_bytes = 0;
+        for (uint32_t t = 0; t < threads; t++) {
+            m_bytes += bytes[t];
+            if (!errors[t].empty()) {
+                error = errors[t];
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Print() const {
+        std::cout << "Quagga configs: " << m_rendered << " nodes (" << 2 * m_rendered << " files, "
+                  << m_bytes / 1024 << " KiB) under " << m_root << "/" << DCE_NODE_DIR_PREFIX << "*"
+                  << QUAGGA_CONF_DIR << std::endl;
+    }
+};
+
+#endif // QUAGGA_CONFIG_H
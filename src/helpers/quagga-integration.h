@@ -12,6 +12,11 @@
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
 //#include "ns3/dce-module.h"
+#include "results-writer.h"
+#include "async-logger.h"
+#include "dce-fiber-pool.h"
+#include "quagga-config.h"
+#include "../core/instrumentation.h"
 
 using namespace ns3;
 
@@ -19,6 +24,7 @@ using namespace ns3;
 struct VtyshState {
     bool available;
     bool checked;
+    std::vector<double> daemonStart;    // Per node id: Quagga start time, < 0 none (empty: not tracked)
     
     VtyshState() : available(false), checked(false) {}
 };
@@ -31,6 +37,29 @@ inline VtyshState& GetVtyshState() {
     return state;
 }
 
+/**
+ * Records that the node runs zebra/ospfd from startTime on
+ */
+inline void SetQuaggaNode(uint32_t node, double startTime) {
+    VtyshState& state = GetVtyshState();
+    if (state.daemonStart.empty()) {
+        state.daemonStart.assign(NodeList::GetNNodes(), -1.0);
+    }
+    if (node >= state.daemonStart.size()) {
+        state.daemonStart.resize(node + 1, -1.0);
+    }
+    state.daemonStart[node] = startTime;
+}
+
+/**
+ * Whether vtysh on this node has daemons to talk to at this time
+ */
+inline bool IsQuaggaRunning(uint32_t node, double now) {
+    const VtyshState& state = GetVtyshState();
+    if (state.daemonStart.empty()) return true;
+    return node < state.daemonStart.size() && state.daemonStart[node] >= 0.0 && state.daemonStart[node] <= now;
+}
+
 /**
  * Validates that node indices are within valid limits
  */
@@ -38,18 +67,17 @@ inline bool ValidateNodeIndices(int nodeA, int nodeB) {
     uint32_t totalNodes = NodeList::GetNNodes();
     
     if (nodeA < 0 || nodeB < 0) {
-        std::cerr << "Negative node indices: " << nodeA << ", " << nodeB << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "Negative node indices: {}, {}", nodeA, nodeB);
         return false;
     }
     
     if ((uint32_t)nodeA >= totalNodes || (uint32_t)nodeB >= totalNodes) {
-        std::cerr << "Node indices out of range: " << nodeA << ", " << nodeB 
-                  << " (max: " << (totalNodes - 1) << ")" << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "Node indices out of range: {}, {} (max: {})", nodeA, nodeB, totalNodes - 1);
         return false;
     }
     
     if (nodeA == nodeB) {
-        std::cerr << "Identical node indices: " << nodeA << ", " << nodeB << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "Identical node indices: {}, {}", nodeA, nodeB);
         return false;
     }
     
@@ -77,9 +105,13 @@ inline std::string GetPrimaryDceRoot() {
 inline bool IsVtyshAvailable() {
     VtyshState& state = GetVtyshState();
     
-    std::cout << "DEBUG: IsVtyshAvailable() called" << std::endl;
+    SATLOG_LOGIC(SATLOG_QUAGGA, "DEBUG: IsVtyshAvailable() called");
+#ifdef SATNET_NO_DCE
+    // Core-only build (benchmarks): no DCE to run vtysh in
+    state.checked = true;
+#endif
     if (state.checked) {
-        std::cout << "DEBUG: Returning cached value: " << state.available << std::endl;
+        SATLOG_LOGIC(SATLOG_QUAGGA, "DEBUG: Returning cached value: {}", state.available);
         return state.available;
     }
     
@@ -87,8 +119,8 @@ inline bool IsVtyshAvailable() {
     const char* dcePath = getenv("DCE_PATH");
     std::string dceRoot = GetPrimaryDceRoot();
     
-    std::cout << "DEBUG: DCE_PATH=" << (dcePath ? dcePath : "NULL") << std::endl;
-    std::cout << "DEBUG: DCE_ROOT (primary)=" << dceRoot << std::endl;
+    SATLOG_DEBUG(SATLOG_QUAGGA, "DEBUG: DCE_PATH={}", dcePath ? dcePath : "NULL");
+    SATLOG_DEBUG(SATLOG_QUAGGA, "DEBUG: DCE_ROOT (primary)={}", dceRoot);
     
     // Check vtysh in multiple possible locations
     struct stat buffer;
@@ -123,20 +155,20 @@ inline bool IsVtyshAvailable() {
     
     // Try each path
     for (const auto& path : pathsToCheck) {
-        std::cout << "DEBUG: Checking vtysh at: " << path << std::endl;
+        SATLOG_DEBUG(SATLOG_QUAGGA, "DEBUG: Checking vtysh at: {}", path);
         if (stat(path.c_str(), &buffer) == 0) {
             exists = true;
             foundPath = path;
-            std::cout << "DEBUG: Found vtysh at: " << path << " size=" << buffer.st_size << std::endl;
+            SATLOG_DEBUG(SATLOG_QUAGGA, "DEBUG: Found vtysh at: {} size={}", path, buffer.st_size);
             break;
         }
     }
     
     if (!exists) {
-        std::cerr << "vtysh not found in any DCE path" << std::endl;
+        SATLOG_WARN(SATLOG_QUAGGA, "vtysh not found in any DCE path");
         state.available = false;
     } else {
-        std::cout << "vtysh available at: " << foundPath << std::endl;
+        SATLOG_INFO(SATLOG_QUAGGA, "vtysh available at: {}", foundPath);
         state.available = true;
     }
     
@@ -144,32 +176,70 @@ inline bool IsVtyshAvailable() {
     return state.available;
 }
 
+#ifndef SATNET_NO_DCE
+inline void OnVtyshExit(uint64_t token, uint16_t pid, int status) {
+    GetDceFiberPool().OnProcessExit(token);
+}
+
+/**
+ * Runs a batch of commands in one vtysh process (one -c per command)
+ */
+inline bool SpawnVtyshBatch(Ptr<Node> node, const std::vector<std::string>& commands, uint32_t stackSize, uint64_t token) {
+    try {
+        // Execute command via DCE
+        DceApplicationHelper dce;
+        
+        // Use just "vtysh" - DCE will find it in DCE_PATH/bin_dce
+        dce.SetBinary("vtysh");
+        dce.SetStackSize(stackSize);
+        for (const std::string& command : commands) {
+            dce.AddArgument("-c");
+            dce.AddArgument(command);
+        }
+        dce.SetFinishedCallback(MakeBoundCallback(&OnVtyshExit, token));
+        
+        ApplicationContainer app = dce.Install(node);
+        SATNET_COUNT(COUNTER_VTYSH_SPAWNED, 1);
+        SATNET_COUNT(COUNTER_DCE_PROCESSES, 1);
+        app.Start(Seconds(VTYSH_START_DELAY));
+        return true;
+        
+    } catch (const std::exception& e) {
+        SATLOG_ERROR(SATLOG_QUAGGA, "Error secure vtysh on node {}: {}", node->GetId(), e.what());
+    } catch (...) {
+        SATLOG_ERROR(SATLOG_QUAGGA, "Unknown vtysh error on node {}", node->GetId());
+    }
+    SATLOG_LOGIC(SATLOG_QUAGGA, "🔄 Fallback: simulating {} commands", commands.size());
+    return false;
+}
+#endif
+
 inline void SetupDceEnvironmentSafe() {
-    std::cout << "🔧 === CONFIGURATION ENVIRONNEMENT DCE SÉCURISÉE ===" << std::endl;
+    SATLOG_INFO(SATLOG_QUAGGA, "🔧 === CONFIGURATION ENVIRONNEMENT DCE SÉCURISÉE ===");
     
     const char* dcePath = getenv("DCE_PATH");
     std::string dceRoot = GetPrimaryDceRoot();
     
     if (!dcePath) {
-        std::cerr << "DCE_PATH not defined, using default" << std::endl;
+        SATLOG_WARN(SATLOG_QUAGGA, "DCE_PATH not defined, using default");
         setenv("DCE_PATH", "/bake/build/bin_dce:/bake/source/quagga/vtysh:/bake/source/quagga/zebra:/bake/source/quagga/ospfd", 1);
     }
     
     if (dceRoot.empty()) {
-        std::cerr << "DCE_ROOT not defined, using default" << std::endl;
+        SATLOG_WARN(SATLOG_QUAGGA, "DCE_ROOT not defined, using default");
         setenv("DCE_ROOT", "/bake/build", 1);
         dceRoot = "/bake/build";
     }
     
     std::string rootStr = dceRoot;
-    std::string cmd;
     
-    cmd = "mkdir -p " + rootStr + "/etc"; system(cmd.c_str());
-    cmd = "mkdir -p " + rootStr + "/var/log"; system(cmd.c_str());
-    cmd = "mkdir -p " + rootStr + "/var/run"; system(cmd.c_str());
-    cmd = "mkdir -p " + rootStr + "/bin_dce"; system(cmd.c_str());
-    cmd = "mkdir -p " + rootStr + "/tmp"; system(cmd.c_str());
+    for (const char* dir : {"/etc", "/var/log", "/var/run", "/bin_dce", "/tmp"}) {
+        if (!MakeDirectories(rootStr + dir)) {
+            SATLOG_WARN(SATLOG_QUAGGA, "Cannot create {}{}", rootStr, dir);
+        }
+    }
     
+    // Fallback only: Quagga nodes read the per-node files QuaggaConfigWriter renders
     std::ofstream zebraConf(rootStr + "/etc/zebra.conf");
     if (zebraConf.is_open()) {
         zebraConf << "hostname zebra\n";
@@ -184,7 +254,7 @@ inline void SetupDceEnvironmentSafe() {
         zebraConf << " exec-timeout 0 0\n";
         zebraConf << "!\n";
         zebraConf.close();
-        std::cout << "zebra.conf created at " << rootStr << "/etc/zebra.conf" << std::endl;
+        SATLOG_INFO(SATLOG_QUAGGA, "zebra.conf created at {}/etc/zebra.conf", rootStr);
     }
     
     std::ofstream ospfdConf(rootStr + "/etc/ospfd.conf");
@@ -195,75 +265,76 @@ inline void SetupDceEnvironmentSafe() {
         ospfdConf << "log stdout\n";
         ospfdConf << "!\n";
         ospfdConf << "router ospf\n";
-        ospfdConf << " ospf router-id 1.1.1.1\n";
         ospfdConf << " network 10.0.0.0/8 area 0.0.0.0\n";
         ospfdConf << "!\n";
         ospfdConf << "line vty\n";
         ospfdConf << " exec-timeout 0 0\n";
         ospfdConf << "!\n";
         ospfdConf.close();
-        std::cout << "ospfd.conf created" << std::endl;
+        SATLOG_INFO(SATLOG_QUAGGA, "ospfd.conf created");
     }
     
+#ifndef SATNET_NO_DCE
+    GetDceFiberPool().SetSpawnFunction(SpawnVtyshBatch);
+#endif
+    
     // Check vtysh availability
     bool vtyshOk = IsVtyshAvailable();
     if (vtyshOk) {
-        std::cout << "DCE configuration completed with vtysh" << std::endl;
+        SATLOG_INFO(SATLOG_QUAGGA, "DCE configuration completed with vtysh");
     } else {
-        std::cerr << "DCE configuration completed WITHOUT vtysh (simulation mode)" << std::endl;
-        std::cerr << "Simulation will continue with simulated commands" << std::endl;
+        SATLOG_WARN(SATLOG_QUAGGA, "DCE configuration completed WITHOUT vtysh (simulation mode)");
+        SATLOG_WARN(SATLOG_QUAGGA, "Simulation will continue with simulated commands");
     }
 }
 
 /**
- * Executes a vtysh command on a node via DCE (ULTRA-SECURE VERSION)
+ * Executes a vtysh command sequence on a node via DCE (ULTRA-SECURE VERSION)
+ *
+ * The commands depend on each other ("configure terminal" first) and are queued as
+ * one unit, so they always run in the same vtysh process.
  */
-inline void ExecuteVtyshCommand(Ptr<Node> node, const std::string& command) {
+inline void ExecuteVtyshSequence(Ptr<Node> node, const std::vector<std::string>& commands) {
+    SATNET_TIMER(TIMER_VTYSH_COMMAND);
     if (!node) {
-        std::cerr << "ExecuteVtyshCommand: null node pointer" << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "ExecuteVtyshSequence: null node pointer");
         return;
     }
     
-    if (command.empty()) {
-        // std::cout << "ExecuteVtyshCommand: empty command" << std::endl;
+    if (commands.empty()) {
+        SATLOG_LOGIC(SATLOG_QUAGGA, "ExecuteVtyshSequence: empty command");
         return;
     }
     
-    if (!IsVtyshAvailable()) {
-        std::cout << "🔧 SIMULATED VTYSH on node " << node->GetId() << ": " << command << std::endl;
-        return;
+    for (const std::string& command : commands) {
+        GetResultsWriter().CountQuaggaCommand(node->GetId(), command);
     }
     
-    std::cout << "SAFE VTYSH on node " << node->GetId() << ": " << command << std::endl;
+    // No daemons on this node (outside the active region, or its wave has not started)
+    if (!IsVtyshAvailable() || !IsQuaggaRunning(node->GetId(), Simulator::Now().GetSeconds())) {
+        SATNET_COUNT(COUNTER_VTYSH_SIMULATED, commands.size());
+        for (const std::string& command : commands) {
+            SATLOG_LOGIC(SATLOG_QUAGGA, "🔧 SIMULATED VTYSH on node {}: {}", node->GetId(), command);
+        }
+        return;
+    }
     
-    try {
-        if (command.length() > 200) {
-            std::cerr << "Command too long, truncating: " << command.substr(0, 50) << "..." << std::endl;
+    for (const std::string& command : commands) {
+        SATLOG_LOGIC(SATLOG_QUAGGA, "SAFE VTYSH on node {}: {}", node->GetId(), command);
+        
+        // A sequence with a missing step must not run at all
+        if (command.empty() || command.length() > 200) {
+            SATLOG_ERROR(SATLOG_QUAGGA, "Invalid command, sequence dropped: {}...", command.substr(0, 50));
             return;
         }
-        
-        // Execute command via DCE
-        DceApplicationHelper dce;
-        
-        // Use just "vtysh" - DCE will find it in DCE_PATH/bin_dce
-        dce.SetBinary("vtysh");
-        dce.SetStackSize(1 << 16); 
-        dce.AddArgument("-c");
-        dce.AddArgument(command);
-        
-        ApplicationContainer app = dce.Install(node);
-        app.Start(Seconds(0.1));
-        // app.Stop(Seconds(1.0)); // Don't stop immediately, let it run
-        
-        // std::cout << "🦓 SAFE VTYSH on node " << node->GetId() << ": " << command << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Error secure vtysh on node " << node->GetId() << ": " << e.what() << std::endl;
-        // std::cout << "🔄 Fallback: simulating command: " << command << std::endl;
-    } catch (...) {
-        std::cerr << "Unknown vtysh error on node " << node->GetId() << std::endl;
-        // std::cout << "🔄 Fallback: simulating command: " << command << std::endl;
     }
+    
+    // Batched with the node's other sequences of this instant (see DceFiberPool)
+    GetDceFiberPool().QueueVtysh(node, commands);
+}
+
+inline void ExecuteVtyshCommand(Ptr<Node> node, const std::string& command) {
+    ExecuteVtyshSequence(node, std::vector<std::string>(1, command));
 }
 
 /**
@@ -275,26 +346,17 @@ inline void SetQuaggaLinkStateReal(int nodeA, int nodeB, bool isUp) {    if (!Va
     Ptr<Node> nodeBPtr = NodeList::GetNode(nodeB);
     
     if (!nodeAPtr || !nodeBPtr) {
-        std::cerr << "Invalid nodes: " << nodeA << ", " << nodeB << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "Invalid nodes: {}, {}", nodeA, nodeB);
         return;
     }
 
     try {
         // Interface with Quagga via vtysh
         if (IsVtyshAvailable()) {
-            ExecuteVtyshCommand(nodeAPtr, "configure terminal");
-            
-            std::ostringstream cmd;
-            if (isUp) {
-                cmd << "no shutdown";    
-            } else {
-                cmd << "shutdown";       
-            }
-            ExecuteVtyshCommand(nodeAPtr, cmd.str());
-            
+            ExecuteVtyshSequence(nodeAPtr, {"configure terminal", isUp ? "no shutdown" : "shutdown"});
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error during OSPF notification: " << e.what() << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "Error during OSPF notification: {}", e.what());
     }
 }
 
@@ -302,25 +364,19 @@ inline void SetQuaggaLinkStateReal(int nodeA, int nodeB, bool isUp) {    if (!Va
  * Adds a route in Quagga with error handling
  */
 inline void AddQuaggaRoute(Ptr<Node> node, const std::string& prefix, const std::string& nexthop, int metric = 1) {
-    std::cout << "➕ Adding route on node " << node->GetId() << ": " << prefix << " via " << nexthop << std::endl;
+    SATLOG_LOGIC(SATLOG_QUAGGA, "➕ Adding route on node {}: {} via {}", node->GetId(), prefix, nexthop);
     
     try {
-        // Configuration via vtysh
-        ExecuteVtyshCommand(node, "configure terminal");
-        
+        // Configuration via vtysh, then redistribute in OSPF
         std::ostringstream cmd;
         cmd << "ip route " << prefix << " " << nexthop << " " << metric;
-        ExecuteVtyshCommand(node, cmd.str());
-        
-        // Redistribute in OSPF
-        ExecuteVtyshCommand(node, "router ospf");
-        ExecuteVtyshCommand(node, "redistribute static");
+        ExecuteVtyshSequence(node, {"configure terminal", cmd.str(), "router ospf", "redistribute static"});
         
-        std::cout << "Route added and redistributed in OSPF" << std::endl;
+        SATLOG_LOGIC(SATLOG_QUAGGA, "Route added and redistributed in OSPF");
         
     } catch (const std::exception& e) {
-        std::cerr << "Error adding route: " << e.what() << std::endl;
-        std::cerr << "🔧 Route ajoutée en mode simulation" << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "Error adding route: {}", e.what());
+        SATLOG_WARN(SATLOG_QUAGGA, "🔧 Route ajoutée en mode simulation");
     }
 }
 
@@ -328,20 +384,18 @@ inline void AddQuaggaRoute(Ptr<Node> node, const std::string& prefix, const std:
  * Removes a route in Quagga with error handling
  */
 inline void DelQuaggaRoute(Ptr<Node> node, const std::string& prefix, const std::string& nexthop) {
-    std::cout << "➖ Deleting route on node " << node->GetId() << ": " << prefix << " via " << nexthop << std::endl;
+    SATLOG_LOGIC(SATLOG_QUAGGA, "➖ Deleting route on node {}: {} via {}", node->GetId(), prefix, nexthop);
     
     try {
-        ExecuteVtyshCommand(node, "configure terminal");
-        
         std::ostringstream cmd;
         cmd << "no ip route " << prefix << " " << nexthop;
-        ExecuteVtyshCommand(node, cmd.str());
+        ExecuteVtyshSequence(node, {"configure terminal", cmd.str()});
         
-        std::cout << "Route deleted from routing table" << std::endl;
+        SATLOG_LOGIC(SATLOG_QUAGGA, "Route deleted from routing table");
         
     } catch (const std::exception& e) {
-        std::cerr << "Error deleting route: " << e.what() << std::endl;
-        std::cerr << "🔧 Route supprimée en mode simulation" << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "Error deleting route: {}", e.what());
+        SATLOG_WARN(SATLOG_QUAGGA, "🔧 Route supprimée en mode simulation");
     }
 }
 
@@ -349,7 +403,7 @@ inline void DelQuaggaRoute(Ptr<Node> node, const std::string& prefix, const std:
  * Forces OSPF re-convergence on all nodes with error handling
  */
 inline void ForceOspfConvergence() {
-    std::cout << "🔄 Forcing OSPF convergence on all nodes..." << std::endl;
+    SATLOG_INFO(SATLOG_QUAGGA, "🔄 Forcing OSPF convergence on all nodes...");
     
     try {
         uint32_t maxNodes = std::min(NodeList::GetNNodes(), (uint32_t)20); // Limit to avoid errors
@@ -357,17 +411,15 @@ inline void ForceOspfConvergence() {
         for (uint32_t i = 0; i < maxNodes; i++) {
             Ptr<Node> node = NodeList::GetNode(i);
             
-            ExecuteVtyshCommand(node, "clear ip ospf database");
-            ExecuteVtyshCommand(node, "router ospf");
-            ExecuteVtyshCommand(node, "area 0.0.0.0 stub");
-            ExecuteVtyshCommand(node, "no area 0.0.0.0 stub");
+            ExecuteVtyshSequence(node, {"clear ip ospf database", "router ospf",
+                                        "area 0.0.0.0 stub", "no area 0.0.0.0 stub"});
         }
         
-        std::cout << "OSPF convergence triggered on " << maxNodes << " nodes" << std::endl;
+        SATLOG_INFO(SATLOG_QUAGGA, "OSPF convergence triggered on {} nodes", maxNodes);
         
     } catch (const std::exception& e) {
-        std::cerr << "Error OSPF convergence: " << e.what() << std::endl;
-        std::cerr << "🔧 Convergence OSPF en mode simulation" << std::endl;
+        SATLOG_ERROR(SATLOG_QUAGGA, "Error OSPF convergence: {}", e.what());
+        SATLOG_WARN(SATLOG_QUAGGA, "🔧 Convergence OSPF en mode simulation");
     }
 }
 
@@ -0,0 +1,378 @@
+#ifndef RESULTS_WRITER_H
+#define RESULTS_WRITER_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Columnar binary results (.scol files, little-endian)
+ *
+ * Header: "SATCOL01", u8 codec, u16 table name length + name, u32 column count,
+ *         per column: u8 type, u16 name length + name
+ * Chunk:  u32 "CHNK" magic, u32 rows, per column: u8 compressed, u32 raw size,
+ *         u32 stored size, stored bytes
+ * STRING values are u32 length + bytes. Compressed columns use the LZ4 block format.
+ * scripts/read_results.py loads these files.
+ */
+enum ColumnType : uint8_t {
+    COLUMN_U8 = 1,
+    COLUMN_I32 = 2,
+    COLUMN_U32 = 3,
+    COLUMN_U64 = 4,
+    COLUMN_F64 = 5,
+    COLUMN_STRING = 6
+};
+
+const uint32_t RESULTS_CHUNK_ROWS = 65536;
+const uint32_t RESULTS_CHUNK_MAGIC = 0x4B4E4843;    // "CHNK"
+const uint32_t LZ4_HASH_BITS = 12;
+
+/**
+ * LZ4 block compressor (greedy, single hash probe)
+ * The hash table is owned by the caller so compressing does not allocate
+ */
+inline size_t Lz4CompressBlock(const uint8_t* src, size_t size, std::vector<uint8_t>& out,
+                               std::vector<int32_t>& table) {
+    out.clear();
+    table.assign(1u << LZ4_HASH_BITS, -1);
+
+    auto read32 = [src](size_t pos) {
+        uint32_t v;
+        memcpy(&v, src + pos, 4);
+        return v;
+    };
+    auto putLength = [&out](size_t length) {
+        for (; length >= 255; length -= 255) out.push_back(255);
+        out.push_back((uint8_t)length);
+    };
+    auto emit = [&](size_t literalStart, size_t literalLength, size_t offset, size_t matchLength) {
+        size_t extraMatch = matchLength >= 4 ? matchLength - 4 : 0;
+        uint8_t token = (uint8_t)((std::min<size_t>(literalLength, 15) << 4) |
+                                  (matchLength ? std::min<size_t>(extraMatch, 15) : 0));
+        out.push_back(token);
+        if (literalLength >= 15) putLength(literalLength - 15);
+        out.insert(out.end(), src + literalStart, src + literalStart + literalLength);
+        if (matchLength) {
+            out.push_back((uint8_t)(offset & 0xFF));
+            out.push_back((uint8_t)(offset >> 8));
+            if (extraMatch >= 15) putLength(extraMatch - 15);
+        }
+    };
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    if (size >= 13) {
+        size_t matchLimit = size - 12;     // no match starts in the last 12 bytes
+        size_t endLimit = size - 5;        // the last 5 bytes are literals
+        while (pos < matchLimit) {
+            uint32_t sequence = read32(pos);
+            uint32_t h = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+            int32_t ref = table[h];
+            table[h] = (int32_t)pos;
+
+            if (ref >= 0 && pos - ref <= 65535 && read32(ref) == sequence) {
+                size_t length = 4;
+                while (pos + length < endLimit && src[ref + length] == src[pos + length]) length++;
+                emit(anchor, pos - anchor, pos - ref, length);
+                pos += length;
+                anchor = pos;
+            } else {
+                pos++;
+            }
+        }
+    }
+    emit(anchor, size - anchor, 0, 0);
+    return out.size();
+}
+
+/**
+ * One columnar table: rows are buffered per column and written chunk by chunk
+ */
+class ColumnarWriter {
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        std::vector<uint8_t> data;
+    };
+
+    std::ofstream m_file;
+    std::vector<char> m_fileBuffer;
+    std::string m_tableName;
+    std::vector<Column> m_columns;
+    uint32_t m_rows;
+    uint32_t m_chunkRows;
+    bool m_compress;
+    bool m_headerWritten;
+    uint64_t m_totalRows;
+    uint64_t m_rawBytes;
+    uint64_t m_storedBytes;
+
+    std::vector<uint8_t> m_compressed;
+    std::vector<int32_t> m_hashTable;
+
+    template <typename T>
+    void Write(const T& value) {
+        m_file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void WriteString16(const std::string& value) {
+        Write((uint16_t)value.size());
+        m_file.write(value.data(), value.size());
+    }
+
+    void WriteHeader() {
+        m_file.write("SATCOL01", 8);
+        Write((uint8_t)(m_compress ? 1 : 0));
+        WriteString16(m_tableName);
+        Write((uint32_t)m_columns.size());
+        for (const Column& column : m_columns) {
+            Write((uint8_t)column.type);
+            WriteString16(column.name);
+        }
+        m_headerWritten = true;
+    }
+
+    template <typename T>
+    void Put(uint32_t column, T value) {
+        std::vector<uint8_t>& data = m_columns[column].data;
+        size_t offset = data.size();
+        data.resize(offset + sizeof(T));
+        memcpy(&data[offset], &value, sizeof(T));
+    }
+
+public:
+    ColumnarWriter(const std::string& filename, const std::string& tableName, bool compress,
+                   uint32_t chunkRows = RESULTS_CHUNK_ROWS)
+        : m_fileBuffer(1 << 20), m_tableName(tableName), m_rows(0), m_chunkRows(chunkRows),
+          m_compress(compress), m_headerWritten(false), m_totalRows(0), m_rawBytes(0), m_storedBytes(0) {
+        m_file.rdbuf()->pubsetbuf(m_fileBuffer.data(), m_fileBuffer.size());
+        m_file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!m_file) {
+            std::cerr << "Error results writer: cannot open " << filename << std::endl;
+        }
+    }
+
+    ~ColumnarWriter() {
+        Close();
+    }
+
+    uint32_t AddColumn(const std::string& name, ColumnType type) {
+        Column column;
+        column.name = name;
+        column.type = type;
+        column.data.reserve((size_t)m_chunkRows * (type == COLUMN_STRING ? 16 : 8));
+        m_columns.push_back(column);
+        return m_columns.size() - 1;
+    }
+
+    void PutU8(uint32_t column, uint8_t value) { Put(column, value); }
+    void PutI32(uint32_t column, int32_t value) { Put(column, value); }
+    void PutU32(uint32_t column, uint32_t value) { Put(column, value); }
+    void PutU64(uint32_t column, uint64_t value) { Put(column, value); }
+    void PutF64(uint32_t column, double value) { Put(column, value); }
+
+    void PutString(uint32_t column, const std::string& value) {
+        Put(column, (uint32_t)value.size());
+        std::vector<uint8_t>& data = m_columns[column].data;
+        data.insert(data.end(), value.begin(), value.end());
+    }
+
+    void EndRow() {
+        m_rows++;
+        if (m_rows >= m_chunkRows) FlushChunk();
+    }
+
+    void FlushChunk() {
+        if (!m_file.is_open()) return;
+        if (!m_headerWritten) WriteHeader();
+        if (m_rows == 0) return;
+
+        Write(RESULTS_CHUNK_MAGIC);
+        Write(m_rows);
+        for (Column& column : m_columns) {
+            uint32_t rawSize = column.data.size();
+            bool compressed = false;
+            if (m_compress && rawSize > 0) {
+                compressed = Lz4CompressBlock(column.data.data(), rawSize, m_compressed, m_hashTable) < rawSize;
+            }
+
+            const std::vector<uint8_t>& stored = compressed ? m_compressed : column.data;
+            Write((uint8_t)(compressed ? 1 : 0));
+            Write(rawSize);
+            Write((uint32_t)stored.size());
+            m_file.write(reinterpret_cast<const char*>(stored.data()), stored.size());
+
+            m_rawBytes += rawSize;
+            m_storedBytes += stored.size();
+            column.data.clear();
+        }
+        m_totalRows += m_rows;
+        m_rows = 0;
+    }
+
+    void Close() {
+        if (!m_file.is_open()) return;
+        FlushChunk();
+        m_file.close();
+    }
+
+    uint64_t GetTotalRows() const { return m_totalRows + m_rows; }
+    uint64_t GetRawBytes() const { return m_rawBytes; }
+    uint64_t GetStoredBytes() const { return m_storedBytes; }
+};
+
+/**
+ * Results of one run: link events, RFP markers, route updates, Quagga command counts,
+ * plus the per-event and per-flow metrics written at the end
+ */
+class ResultsWriter {
+private:
+    std::string m_prefix;
+    bool m_compress;
+    bool m_open;
+
+    ColumnarWriter* m_linkEvents;
+    ColumnarWriter* m_markers;
+    ColumnarWriter* m_routeUpdates;
+    std::map<std::pair<uint32_t, std::string>, uint64_t> m_quaggaCommands;
+
+public:
+    ResultsWriter() : m_compress(true), m_open(false),
+                      m_linkEvents(nullptr), m_markers(nullptr), m_routeUpdates(nullptr) {}
+
+    ~ResultsWriter() {
+        Close();
+    }
+
+    /**
+     * Opens <prefix>_<table>.scol files
+     */
+    void Open(const std::string& prefix, bool compress) {
+        if (m_open) return;
+        m_prefix = prefix;
+        m_compress = compress;
+
+        m_linkEvents = new ColumnarWriter(prefix + "_link_events.scol", "link_events", compress);
+        m_linkEvents->AddColumn("time", COLUMN_F64);
+        m_linkEvents->AddColumn("node_a", COLUMN_I32);
+        m_linkEvents->AddColumn("node_b", COLUMN_I32);
+        m_linkEvents->AddColumn("is_up", COLUMN_U8);
+        m_linkEvents->AddColumn("predicted", COLUMN_U8);
+
+        m_markers = new ColumnarWriter(prefix + "_rfp_markers.scol", "rfp_markers", compress);
+        m_markers->AddColumn("time", COLUMN_F64);
+        m_markers->AddColumn("node_a", COLUMN_I32);
+        m_markers->AddColumn("node_b", COLUMN_I32);
+        m_markers->AddColumn("marker", COLUMN_U8);      // 1 = T1, 2 = T2, 0 = T0, 3 = T3
+
+        m_routeUpdates = new ColumnarWriter(prefix + "_route_updates.scol", "route_updates", compress);
+        m_routeUpdates->AddColumn("time", COLUMN_F64);
+        m_routeUpdates->AddColumn("node", COLUMN_U32);
+        m_routeUpdates->AddColumn("op", COLUMN_U8);          // 0 = ADD, 1 = DEL, 2 = UPDATE
+        m_routeUpdates->AddColumn("destination", COLUMN_I32);
+        m_routeUpdates->AddColumn("next_hop", COLUMN_I32);   // first next hop of the set
+        m_routeUpdates->AddColumn("next_hops", COLUMN_U8);
+        m_routeUpdates->AddColumn("metric", COLUMN_U32);
+        m_routeUpdates->AddColumn("buffered", COLUMN_U8);    // delayed by BFU
+
+        m_open = true;
+        std::cout << "Results: writing columnar files " << prefix << "_*.scol"
+                  << (compress ? " (LZ4)" : "") << std::endl;
+    }
+
+    bool IsOpen() const { return m_open; }
+
+    void RecordLinkEvent(double time, int nodeA, int nodeB, bool isUp, bool predicted) {
+        if (!m_open) return;
+        m_linkEvents->PutF64(0, time);
+        m_linkEvents->PutI32(1, nodeA);
+        m_linkEvents->PutI32(2, nodeB);
+        m_linkEvents->PutU8(3, isUp ? 1 : 0);
+        m_linkEvents->PutU8(4, predicted ? 1 : 0);
+        m_linkEvents->EndRow();
+    }
+
+    void RecordMarker(double time, int nodeA, int nodeB, uint8_t marker) {
+        if (!m_open) return;
+        m_markers->PutF64(0, time);
+        m_markers->PutI32(1, nodeA);
+        m_markers->PutI32(2, nodeB);
+        m_markers->PutU8(3, marker);
+        m_markers->EndRow();
+    }
+
+    void RecordRouteUpdate(double time, uint32_t node, uint8_t op, int destination, int nextHop,
+                           uint8_t nextHopCount, uint32_t metric, bool buffered) {
+        if (!m_open) return;
+        m_routeUpdates->PutF64(0, time);
+        m_routeUpdates->PutU32(1, node);
+        m_routeUpdates->PutU8(2, op);
+        m_routeUpdates->PutI32(3, destination);
+        m_routeUpdates->PutI32(4, nextHop);
+        m_routeUpdates->PutU8(5, nextHopCount);
+        m_routeUpdates->PutU32(6, metric);
+        m_routeUpdates->PutU8(7, buffered ? 1 : 0);
+        m_routeUpdates->EndRow();
+    }
+
+    /**
+     * Counts a vtysh command under its first two words ("ip route", "router ospf", ...)
+     */
+    void CountQuaggaCommand(uint32_t node, const std::string& command) {
+        if (!m_open) return;
+        size_t first = command.find(' ');
+        size_t second = (first == std::string::npos) ? first : command.find(' ', first + 1);
+        m_quaggaCommands[std::make_pair(node, command.substr(0, second))]++;
+    }
+
+    /**
+     * Starts an extra table written in one go (per-event or per-flow metrics)
+     */
+    ColumnarWriter* CreateTable(const std::string& name) {
+        if (!m_open) return nullptr;
+        return new ColumnarWriter(m_prefix + "_" + name + ".scol", name, m_compress);
+    }
+
+    void Close() {
+        if (!m_open) return;
+
+        ColumnarWriter commands(m_prefix + "_quagga_commands.scol", "quagga_commands", m_compress);
+        commands.AddColumn("node", COLUMN_U32);
+        commands.AddColumn("command", COLUMN_STRING);
+        commands.AddColumn("count", COLUMN_U64);
+        for (const auto& entry : m_quaggaCommands) {
+            commands.PutU32(0, entry.first.first);
+            commands.PutString(1, entry.first.second);
+            commands.PutU64(2, entry.second);
+            commands.EndRow();
+        }
+        commands.Close();
+
+        ColumnarWriter* tables[3] = {m_linkEvents, m_markers, m_routeUpdates};
+        uint64_t raw = 0, stored = 0;
+        for (ColumnarWriter* table : tables) {
+            table->Close();
+            raw += table->GetRawBytes();
+            stored += table->GetStoredBytes();
+            delete table;
+        }
+        m_linkEvents = m_markers = m_routeUpdates = nullptr;
+        m_open = false;
+
+        std::cout << "Results: " << raw << " bytes of columns written as " << stored << " bytes" << std::endl;
+    }
+};
+
+inline ResultsWriter& GetResultsWriter() {
+    static ResultsWriter writer;
+    return writer;
+}
+
+#endif // RESULTS_WRITER_H
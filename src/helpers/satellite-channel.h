@@ -0,0 +1,280 @@
+#ifndef SATELLITE_CHANNEL_H
+#define SATELLITE_CHANNEL_H
+
+#include <iostream>
+#include <cmath>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#ifdef SATNET_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/point-to-point-remote-channel.h"
+#endif
+#include "../core/constellation-params.h"
+#include "satellite-helper.h"
+
+using namespace ns3;
+
+const double SPEED_OF_LIGHT_KM_S = 299792.458;
+
+/**
+ * Inter-satellite range delay (range / c) of one ISL
+ * The delay is evaluated from the orbit model when a packet is sent and kept for a
+ * short refresh interval: no event tracks the orbit and nothing is allocated per packet.
+ */
+class IslRangeDelay {
+private:
+    SatelliteHelper* m_satHelper;
+    uint32_t m_satA;
+    uint32_t m_satB;
+    uint32_t m_numSatellites;
+
+    double m_refreshInterval;      // s, how long a computed delay is reused
+    double m_validUntil;
+    Time m_cachedDelay;
+
+    uint64_t m_delayUpdates;
+    double m_minDelay;
+    double m_maxDelay;
+
+public:
+    IslRangeDelay()
+        : m_satHelper(nullptr), m_satA(0), m_satB(0), m_numSatellites(0),
+          m_refreshInterval(0.001), m_validUntil(-1.0),
+          m_delayUpdates(0), m_minDelay(1e9), m_maxDelay(0.0) {}
+
+    void SetEndpoints(SatelliteHelper* satHelper, uint32_t satA, uint32_t satB, uint32_t numSatellites) {
+        m_satHelper = satHelper;
+        m_satA = satA;
+        m_satB = satB;
+        m_numSatellites = numSatellites;
+        m_validUntil = -1.0;
+    }
+
+    void SetRefreshInterval(double interval) {
+        m_refreshInterval = std::max(interval, 0.0);
+    }
+
+    /**
+     * Current propagation delay, recomputed only when the cached value is older than the
+     * refresh interval; fallback without endpoints
+     */
+    Time Get(Time fallback) {
+        if (!m_satHelper) return fallback;
+
+        double now = Simulator::Now().GetSeconds();
+        if (now < m_validUntil) return m_cachedDelay;
+
+        Vector a = m_satHelper->GetRealPosition(m_satA, m_numSatellites, now);
+        Vector b = m_satHelper->GetRealPosition(m_satB, m_numSatellites, now);
+        double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+        double delay = std::sqrt(dx * dx + dy * dy + dz * dz) / SPEED_OF_LIGHT_KM_S;
+
+        m_cachedDelay = Seconds(delay);
+        m_validUntil = now + m_refreshInterval;
+        m_delayUpdates++;
+        m_minDelay = std::min(m_minDelay, delay);
+        m_maxDelay = std::max(m_maxDelay, delay);
+        return m_cachedDelay;
+    }
+
+    uint64_t GetDelayUpdates() const { return m_delayUpdates; }
+    double GetMinDelay() const { return m_delayUpdates ? m_minDelay : 0.0; }
+    double GetMaxDelay() const { return m_maxDelay; }
+};
+
+/**
+ * Point-to-point channel whose delay follows the inter-satellite range (IslRangeDelay)
+ * The TxRxPointToPoint trace of the base channel is not fired (NetAnim does not show ISL packets).
+ */
+class SatelliteIslChannel : public PointToPointChannel {
+private:
+    IslRangeDelay m_range;
+
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::SatelliteIslChannel")
+            .SetParent<PointToPointChannel>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SatelliteIslChannel>();
+        return tid;
+    }
+
+    IslRangeDelay& GetRange() { return m_range; }
+    const IslRangeDelay& GetRange() const { return m_range; }
+
+    Time GetPropagationDelay() {
+        return m_range.Get(GetDelay());
+    }
+
+    bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime) override {
+        uint32_t wire = (src == GetSource(0)) ? 0 : 1;
+        Ptr<PointToPointNetDevice> dst = GetDestination(wire);
+
+        Simulator::ScheduleWithContext(dst->GetNode()->GetId(), txTime + GetPropagationDelay(),
+                                       &PointToPointNetDevice::Receive, dst, p->Copy());
+        return true;
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(SatelliteIslChannel);
+
+#ifdef SATNET_MPI
+/**
+ * Range-delay ISL between satellites on different simulator ranks (plane-partition.h)
+ * The "Delay" attribute holds the lookahead the distributed simulator reads at start;
+ * a range delay below it (closer than sampled) is clamped so no packet arrives inside
+ * the window the other rank may already have run.
+ */
+class SatelliteIslRemoteChannel : public PointToPointRemoteChannel {
+private:
+    IslRangeDelay m_range;
+    uint64_t m_clamped;
+
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::SatelliteIslRemoteChannel")
+            .SetParent<PointToPointRemoteChannel>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SatelliteIslRemoteChannel>();
+        return tid;
+    }
+
+    SatelliteIslRemoteChannel() : m_clamped(0) {}
+
+    IslRangeDelay& GetRange() { return m_range; }
+    const IslRangeDelay& GetRange() const { return m_range; }
+    uint64_t GetClamped() const { return m_clamped; }
+
+    bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime) override {
+        uint32_t wire = (src == GetSource(0)) ? 0 : 1;
+        Ptr<PointToPointNetDevice> dst = GetDestination(wire);
+
+        Time lookahead = GetDelay();
+        Time delay = m_range.Get(lookahead);
+        if (delay < lookahead) {
+            delay = lookahead;
+            m_clamped++;
+        }
+
+        Ptr<Node> node = dst->GetNode();
+        if (node->GetSystemId() == MpiInterface::GetSystemId()) {
+            Simulator::ScheduleWithContext(node->GetId(), txTime + delay,
+                                           &PointToPointNetDevice::Receive, dst, p->Copy());
+        } else {
+            MpiInterface::SendPacket(p->Copy(), Simulator::Now() + txTime + delay,
+                                     node->GetId(), dst->GetIfIndex());
+        }
+        return true;
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(SatelliteIslRemoteChannel);
+#endif
+
+/**
+ * Installs ISLs on SatelliteIslChannel, devices and queues set up as PointToPointHelper does
+ */
+class SatelliteLinkHelper {
+private:
+    SatelliteHelper* m_satHelper;
+    uint32_t m_numSatellites;
+    std::string m_dataRate;
+    double m_refreshInterval;
+    Time m_remoteDelay;
+    std::vector<Ptr<SatelliteIslChannel>> m_channels;
+#ifdef SATNET_MPI
+    std::vector<Ptr<SatelliteIslRemoteChannel>> m_remoteChannels;
+#endif
+
+    Ptr<PointToPointNetDevice> CreateDevice(Ptr<Node> node) {
+        Ptr<PointToPointNetDevice> device = CreateObject<PointToPointNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        device->SetAttribute("DataRate", StringValue(m_dataRate));
+        node->AddDevice(device);
+
+        Ptr<Queue<Packet>> queue = CreateObject<DropTailQueue<Packet>>();
+        device->SetQueue(queue);
+
+        // Traffic control layer sees the device queue (same as PointToPointHelper)
+        Ptr<NetDeviceQueueInterface> queueInterface = CreateObject<NetDeviceQueueInterface>();
+        queueInterface->GetTxQueue(0)->ConnectQueueTraces(queue);
+        device->AggregateObject(queueInterface);
+        return device;
+    }
+
+public:
+    SatelliteLinkHelper(SatelliteHelper* satHelper, uint32_t numSatellites, double refreshInterval = 0.001)
+        : m_satHelper(satHelper), m_numSatellites(numSatellites), m_dataRate(P2P_RATE),
+          m_refreshInterval(refreshInterval), m_remoteDelay(Time(SATELLITE_DELAY)) {}
+
+    void SetDataRate(const std::string& dataRate) { m_dataRate = dataRate; }
+
+    /**
+     * Lookahead of the distributed run, Delay of the cross-rank channels
+     */
+    void SetRemoteDelay(Time delay) { m_remoteDelay = delay; }
+
+    NetDeviceContainer Install(Ptr<Node> a, Ptr<Node> b, uint32_t satA, uint32_t satB) {
+        Ptr<PointToPointNetDevice> deviceA = CreateDevice(a);
+        Ptr<PointToPointNetDevice> deviceB = CreateDevice(b);
+
+#ifdef SATNET_MPI
+        if (MpiInterface::IsEnabled() && a->GetSystemId() != b->GetSystemId()) {
+            Ptr<SatelliteIslRemoteChannel> channel = CreateObject<SatelliteIslRemoteChannel>();
+            channel->SetAttribute("Delay", TimeValue(m_remoteDelay));
+            channel->GetRange().SetEndpoints(m_satHelper, satA, satB, m_numSatellites);
+            channel->GetRange().SetRefreshInterval(m_refreshInterval);
+            deviceA->Attach(channel);
+            deviceB->Attach(channel);
+            m_remoteChannels.push_back(channel);
+        } else
+#endif
+        {
+            Ptr<SatelliteIslChannel> channel = CreateObject<SatelliteIslChannel>();
+            channel->GetRange().SetEndpoints(m_satHelper, satA, satB, m_numSatellites);
+            channel->GetRange().SetRefreshInterval(m_refreshInterval);
+            deviceA->Attach(channel);
+            deviceB->Attach(channel);
+            m_channels.push_back(channel);
+        }
+
+        NetDeviceContainer devices;
+        devices.Add(deviceA);
+        devices.Add(deviceB);
+        return devices;
+    }
+
+    void PrintStatistics() const {
+        std::vector<const IslRangeDelay*> ranges;
+        for (const auto& channel : m_channels) ranges.push_back(&channel->GetRange());
+        uint64_t clamped = 0;
+#ifdef SATNET_MPI
+        for (const auto& channel : m_remoteChannels) {
+            ranges.push_back(&channel->GetRange());
+            clamped += channel->GetClamped();
+        }
+#endif
+
+        uint64_t updates = 0;
+        double minDelay = 1e9, maxDelay = 0.0;
+        for (const IslRangeDelay* range : ranges) {
+            if (range->GetDelayUpdates() == 0) continue;
+            updates += range->GetDelayUpdates();
+            minDelay = std::min(minDelay, range->GetMinDelay());
+            maxDelay = std::max(maxDelay, range->GetMaxDelay());
+        }
+
+        std::cout << "ISL propagation delay statistics:" << std::endl;
+        std::cout << "   Range-delay channels: " << ranges.size() << std::endl;
+        std::cout << "   Delay updates: " << updates << std::endl;
+        if (updates > 0) {
+            std::cout << "   Delay range: " << minDelay * 1000.0 << " - " << maxDelay * 1000.0 << " ms" << std::endl;
+        }
+        if (clamped > 0) {
+            std::cout << "   Cross-rank sends clamped to the lookahead: " << clamped << std::endl;
+        }
+    }
+};
+
+#endif // SATELLITE_CHANNEL_H
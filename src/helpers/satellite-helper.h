@@ -7,9 +7,75 @@
 #include "ns3/core-module.h"
 #include "ns3/mobility-module.h"
 #include "../core/constellation-params.h"
+#include "../core/constellation-config.h"
+#include "../core/instrumentation.h"
 
 using namespace ns3;
 
+const double CELL_DEG = 10.0;                 // Spatial index cell size
+const int LAT_CELLS = 18;
+const int LON_CELLS = 36;
+
+/**
+ * Latitude/longitude grid of sub-satellite points
+ * Lets ground stations query only the satellites that can be above their horizon
+ */
+class SatelliteSpatialIndex {
+private:
+    std::vector<std::vector<uint32_t>> m_cells;
+    
+    static int LatCell(double latDeg) {
+        return std::min(LAT_CELLS - 1, std::max(0, (int)((latDeg + 90.0) / CELL_DEG)));
+    }
+    
+    static int LonCell(double lonDeg) {
+        int cell = (int)std::floor((lonDeg + 180.0) / CELL_DEG) % LON_CELLS;
+        return (cell < 0) ? cell + LON_CELLS : cell;
+    }
+    
+public:
+    SatelliteSpatialIndex() : m_cells(LAT_CELLS * LON_CELLS) {}
+    
+    template <typename Positions>
+    void Rebuild(const Positions& positions, uint32_t count) {
+        for (auto& cell : m_cells) cell.clear();
+        
+        for (uint32_t i = 0; i < count && i < positions.size(); i++) {
+            const Vector& p = positions[i].realPos;
+            double r = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+            if (r <= 0) continue;
+            
+            double latDeg = std::asin(p.z / r) * 180.0 / PI;
+            double lonDeg = std::atan2(p.y, p.x) * 180.0 / PI;
+            m_cells[LatCell(latDeg) * LON_CELLS + LonCell(lonDeg)].push_back(i);
+        }
+    }
+    
+    /**
+     * Satellites whose sub-satellite point lies within radiusDeg (central angle) of (lat, lon)
+     * Candidates only: the caller still checks the elevation angle
+     */
+    void Query(double latDeg, double lonDeg, double radiusDeg, std::vector<uint32_t>& out) const {
+        out.clear();
+        
+        int latMin = LatCell(latDeg - radiusDeg);
+        int latMax = LatCell(latDeg + radiusDeg);
+        
+        double maxLat = std::min(89.0, std::max(std::abs(latDeg - radiusDeg), std::abs(latDeg + radiusDeg)));
+        double lonRadius = radiusDeg / std::cos(maxLat * PI / 180.0);
+        bool allLongitudes = (lonRadius >= 180.0 || latDeg + radiusDeg >= 90.0 || latDeg - radiusDeg <= -90.0);
+        int lonSpan = allLongitudes ? LON_CELLS : std::min(LON_CELLS, (int)std::ceil(lonRadius / CELL_DEG) * 2 + 1);
+        int lonStart = allLongitudes ? 0 : LonCell(lonDeg - lonRadius);
+        
+        for (int lat = latMin; lat <= latMax; lat++) {
+            for (int k = 0; k < lonSpan; k++) {
+                const std::vector<uint32_t>& cell = m_cells[lat * LON_CELLS + (lonStart + k) % LON_CELLS];
+                out.insert(out.end(), cell.begin(), cell.end());
+            }
+        }
+    }
+};
+
 class SatelliteHelper {
 public:
     SatelliteHelper() {}
@@ -25,24 +91,36 @@ public:
     
     std::vector<SatellitePosition> m_currentPositions;
     
+private:
+    const double DISPLAY_ORBIT_RADIUS = 150.0;
+    
+    SatelliteSpatialIndex m_spatialIndex;
+    std::vector<OrbitalState> m_states;
+    
+public:
+    
+    /**
+     * Propagates the constellation (GetConstellation()) and moves the satellite nodes
+     * Satellite i of the constellation is node i of the container
+     */
     void UpdatePositions(NodeContainer satellites, double time) {
+        SATNET_TIMER(TIMER_UPDATE_POSITIONS);
         try {
             if (satellites.GetN() == 0) return;
             
-            uint32_t actualSatellites = satellites.GetN();
+            ConstellationConfig& constellation = GetConstellation();
+            constellation.EnsureBuilt(satellites.GetN());
+            constellation.Propagate(time, m_states);
+            
+            uint32_t actualSatellites = std::min(satellites.GetN(), constellation.GetSatelliteCount());
             if (m_currentPositions.empty() || m_currentPositions.size() < actualSatellites) {
                 m_currentPositions.resize(actualSatellites);
             }
             
-            double animTime = time * ANIMATION_SPEED_FACTOR;
-            uint32_t satIndex = 0;
-            
             double earthCenterX = 600.0;      
             double earthCenterY = 400.0;      
             double orbitScaleFactor = 2.0;    
             
-            uint32_t effectivePlanes = std::min((uint32_t)NUM_PLANES, actualSatellites);
-            
             for (uint32_t i = 0; i < actualSatellites; i++) {
                 try {
                     Ptr<Node> satelliteNode = satellites.Get(i);
@@ -51,44 +129,20 @@ public:
                     Ptr<MobilityModel> mobility = satelliteNode->GetObject<MobilityModel>();
                     if (!mobility) continue;
 
-                    // Round-Robin distribution in planes
-                    uint32_t plane = i % effectivePlanes;
-                    uint32_t satOrder = i / effectivePlanes;
-                    
-                    // Calculate number of satellites in this plan for spacing
-                    uint32_t satsInThisPlane = actualSatellites / effectivePlanes;
-                    if (plane < actualSatellites % effectivePlanes) {
-                        satsInThisPlane++;
-                    }
-                    
-                    // Espacement dynamique (360 / N)
-                    double dynamicPhaseDiff = 360.0 / satsInThisPlane;
-                    
-                    // RAAN (Right Ascension of Ascending Node)
-                    double raan = plane * (PI / effectivePlanes); 
-                    
-                    double inclination = DegToRad(INCLINATION_DEG[plane % 6]);
-                    
-                    double orbitRadius = 150.0; 
-                    
-                    double satPhase = DegToRad(satOrder * dynamicPhaseDiff);
-                    double theta = 2 * PI * (animTime / ORBIT_PERIOD) + satPhase;
-                    
-                    double x_orb = orbitRadius * cos(theta);
-                    double y_orb = orbitRadius * sin(theta);
-                    
-                    double x3d = x_orb * cos(raan) - y_orb * cos(inclination) * sin(raan);
-                    double y3d = x_orb * sin(raan) + y_orb * cos(inclination) * cos(raan);
-                    double z3d = y_orb * sin(inclination);
+                    const OrbitalState& state = m_states[i];
+                    double x3d = state.unit.x * DISPLAY_ORBIT_RADIUS;
+                    double y3d = state.unit.y * DISPLAY_ORBIT_RADIUS;
+                    double z3d = state.unit.z * DISPLAY_ORBIT_RADIUS;
                     
                     double displayX = earthCenterX + x3d * orbitScaleFactor;
                     double displayY = earthCenterY + (y3d * 0.3 - z3d) * orbitScaleFactor;
                     
-                    if (i < m_currentPositions.size()) {
-                        m_currentPositions[i].angle = theta;
-                        m_currentPositions[i].normalizedPos = fmod(theta, 2 * PI) / (2 * PI);
-                        m_currentPositions[i].displayPos = Vector(displayX, displayY, 0);
-                    }
+                    m_currentPositions[i].angle = state.theta;
+                    m_currentPositions[i].normalizedPos = fmod(state.theta, 2 * PI) / (2 * PI);
+                    m_currentPositions[i].displayPos = Vector(displayX, displayY, 0);
+                    m_currentPositions[i].realPos = Vector(state.unit.x * state.radiusKm,
+                                                           state.unit.y * state.radiusKm,
+                                                           state.unit.z * state.radiusKm);
                     
                     mobility->SetPosition(Vector(displayX, displayY, 0));
                     
@@ -98,19 +152,40 @@ public:
                     
                 } catch (...) {}
             }
+            
+            m_spatialIndex.Rebuild(m_currentPositions, actualSatellites);
         } catch (...) {}
     }
     
+    /**
+     * Real position (km, Earth-centered, Earth rotation ignored) of satellite i at a given time
+     * Used to predict visibility ahead of the current position update
+     */
+    Vector GetRealPosition(uint32_t i, uint32_t numSatellites, double time) {
+        ConstellationConfig& constellation = GetConstellation();
+        constellation.EnsureBuilt(numSatellites);
+        if (i >= constellation.GetSatelliteCount()) return Vector();
+        OrbitalState state = constellation.PropagateSatellite(i, time);
+        return Vector(state.unit.x * state.radiusKm, state.unit.y * state.radiusKm, state.unit.z * state.radiusKm);
+    }
+    
+    const SatelliteSpatialIndex& GetSpatialIndex() const {
+        return m_spatialIndex;
+    }
+    
     bool IsSatelliteVisible(uint32_t satA, uint32_t satB, bool isInterPlane) {
+        SATNET_TIMER(TIMER_SATELLITE_VISIBLE);
         try {
             if (m_currentPositions.empty() || satA >= m_currentPositions.size() || satB >= m_currentPositions.size()) {
                 return false;
             }
             
-            uint32_t planeA = satA / SATS_PER_PLANE;
-            uint32_t planeB = satB / SATS_PER_PLANE;
+            const ConstellationConfig& constellation = GetConstellation();
+            uint32_t planeA = constellation.PlaneOf(satA);
+            uint32_t planeB = constellation.PlaneOf(satB);
             
             if (planeA == planeB) {
+                SATNET_COUNT(COUNTER_VISIBLE_LINKS, 1);
                 return true;
             }
             
@@ -123,7 +198,9 @@ public:
                 posDiff = 1.0 - posDiff;
             }
             
-            return posDiff < LINK_VISIBILITY_THRESHOLD;
+            bool visible = posDiff < LINK_VISIBILITY_THRESHOLD;
+            if (visible) SATNET_COUNT(COUNTER_VISIBLE_LINKS, 1);
+            return visible;
             
         } catch (const std::exception& e) {
             std::cerr << "Error is satellite visible: " << e.what() << std::endl;
@@ -0,0 +1,317 @@
+#ifndef SATNET_ROUTING_H
+#define SATNET_ROUTING_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "async-logger.h"
+#include "../modules/forwarding-table.h"
+
+using namespace ns3;
+
+const int16_t SATNET_ROUTING_PRIORITY = 10;     // Ahead of Ipv4StaticRouting / Ipv4DceRouting (0)
+
+/**
+ * Forwarding state shared by the SatnetRouting instances of every node
+ *
+ * - Addresses: every interface address maps to its node (registered by the nodes'
+ *   SatnetRouting as addresses are assigned)
+ * - Table-routed nodes: their routes come from the RMM forwarding tables (OSPF model,
+ *   CGR); the selector is the RMM lookup (active table, 5-tuple hash over the ECMP set)
+ * - Attachment: the satellite currently serving a ground station, -1 for other nodes
+ */
+class SatnetForwarding {
+public:
+    typedef std::function<int(uint32_t node, int destination, uint32_t flowHash)> NextHopSelector;
+    typedef std::function<int(uint32_t node)> AttachmentResolver;
+
+private:
+    std::map<uint32_t, uint32_t> m_nodeOfAddress;
+    std::vector<bool> m_tableRouted;
+    NextHopSelector m_selector;
+    AttachmentResolver m_attachment;
+
+    uint64_t m_direct;
+    uint64_t m_table;
+    uint64_t m_uplink;
+    uint64_t m_fallThrough;
+
+public:
+    SatnetForwarding() : m_direct(0), m_table(0), m_uplink(0), m_fallThrough(0) {}
+
+    void AddAddress(Ipv4Address address, uint32_t node) {
+        m_nodeOfAddress[address.Get()] = node;
+    }
+
+    int GetNode(Ipv4Address address) const {
+        auto it = m_nodeOfAddress.find(address.Get());
+        return (it != m_nodeOfAddress.end()) ? (int)it->second : -1;
+    }
+
+    void SetTableRouted(uint32_t node, bool tableRouted) {
+        if (node >= m_tableRouted.size()) m_tableRouted.resize(node + 1, false);
+        m_tableRouted[node] = tableRouted;
+    }
+
+    bool IsTableRouted(uint32_t node) const {
+        return node < m_tableRouted.size() && m_tableRouted[node];
+    }
+
+    uint32_t GetTableRoutedCount() const {
+        return (uint32_t)std::count(m_tableRouted.begin(), m_tableRouted.end(), true);
+    }
+
+    void SetNextHopSelector(NextHopSelector selector) {
+        m_selector = selector;
+    }
+
+    void SetAttachmentResolver(AttachmentResolver attachment) {
+        m_attachment = attachment;
+    }
+
+    int SelectNextHop(uint32_t node, int destination, uint32_t flowHash) const {
+        return m_selector ? m_selector(node, destination, flowHash) : -1;
+    }
+
+    int GetAttachment(uint32_t node) const {
+        return m_attachment ? m_attachment(node) : -1;
+    }
+
+    void CountDirect() { m_direct++; }
+    void CountTable() { m_table++; }
+    void CountUplink() { m_uplink++; }
+    void CountFallThrough() { m_fallThrough++; }
+
+    uint64_t GetTableForwarded() const { return m_table; }
+
+    void PrintStatistics() const {
+        std::cout << "Forwarding (" << GetTableRoutedCount() << " table-routed nodes): " << m_table
+                  << " packets by RMM table, " << m_direct << " to a neighbour, " << m_uplink
+                  << " to the serving satellite, " << m_fallThrough << " left to the node's routing" << std::endl;
+    }
+};
+
+/**
+ * Per-node forwarding hook, added to the node's Ipv4ListRouting ahead of the static
+ * (or DCE kernel) table
+ *
+ * Destination address -> destination node, then in order:
+ * 1. destination is a neighbour over an up interface: sent to it
+ * 2. table-routed node: RMM next hop towards the destination (or the satellite serving
+ *    it, for a ground station), chosen by FlowHash over the 5-tuple
+ * 3. ground station: its serving satellite
+ * 4. otherwise the lower-priority protocols decide (Quagga kernel table, static routes)
+ * Packets routed by RouteOutput carry no transport header yet: their hash uses ports 0.
+ */
+class SatnetRouting : public Ipv4RoutingProtocol {
+private:
+    struct Adjacency {
+        uint32_t interface;
+        Ipv4Address gateway;        // Neighbour's address on the link
+    };
+
+    SatnetForwarding* m_forwarding;
+    Ptr<Ipv4> m_ipv4;
+    uint32_t m_nodeId;
+    std::map<uint32_t, Adjacency> m_neighbors;      // Neighbour node -> point-to-point interface
+    bool m_neighborsValid;
+
+    void RegisterAddress(const Ipv4InterfaceAddress& address) {
+        if (m_forwarding && address.GetLocal() != Ipv4Address::GetLoopback()) {
+            m_forwarding->AddAddress(address.GetLocal(), m_nodeId);
+        }
+    }
+
+    /**
+     * Neighbours from the point-to-point channels of the node's interfaces
+     */
+    void RefreshNeighbors() {
+        m_neighbors.clear();
+        m_neighborsValid = true;
+        for (uint32_t i = 0; i < m_ipv4->GetNInterfaces(); i++) {
+            Ptr<NetDevice> device = m_ipv4->GetNetDevice(i);
+            Ptr<Channel> channel = device ? device->GetChannel() : Ptr<Channel>();
+            if (!channel || channel->GetNDevices() != 2 || m_ipv4->GetNAddresses(i) == 0) continue;
+
+            Ptr<NetDevice> remote = channel->GetDevice(channel->GetDevice(0) == device ? 1 : 0);
+            Ptr<Ipv4> remoteIpv4 = remote->GetNode()->GetObject<Ipv4>();
+            if (!remoteIpv4) continue;
+            int32_t remoteInterface = remoteIpv4->GetInterfaceForDevice(remote);
+            if (remoteInterface < 0 || remoteIpv4->GetNAddresses(remoteInterface) == 0) {
+                m_neighborsValid = false;      // Other end not addressed yet
+                continue;
+            }
+            m_neighbors[remote->GetNode()->GetId()] = {i, remoteIpv4->GetAddress(remoteInterface, 0).GetLocal()};
+        }
+    }
+
+    bool FindNeighbor(int node, Adjacency& adjacency) {
+        if (node < 0) return false;
+        if (!m_neighborsValid) RefreshNeighbors();
+        auto it = m_neighbors.find(node);
+        if (it == m_neighbors.end() || !m_ipv4->IsUp(it->second.interface)) return false;
+        adjacency = it->second;
+        return true;
+    }
+
+    Ptr<Ipv4Route> MakeRoute(const Ipv4Header& header, const Adjacency& adjacency) {
+        Ptr<Ipv4Route> route = Create<Ipv4Route>();
+        route->SetDestination(header.GetDestination());
+        route->SetGateway(adjacency.gateway);
+        route->SetSource(m_ipv4->GetAddress(adjacency.interface, 0).GetLocal());
+        route->SetOutputDevice(m_ipv4->GetNetDevice(adjacency.interface));
+        return route;
+    }
+
+    Ptr<Ipv4Route> Decide(const Ipv4Header& header, uint32_t flowHash) {
+        if (!m_forwarding || !m_ipv4) return Ptr<Ipv4Route>();
+        int destination = m_forwarding->GetNode(header.GetDestination());
+        if (destination < 0 || destination == (int)m_nodeId) return Ptr<Ipv4Route>();
+
+        Adjacency adjacency;
+        if (FindNeighbor(destination, adjacency)) {
+            m_forwarding->CountDirect();
+            return MakeRoute(header, adjacency);
+        }
+
+        // A ground station is reached through the satellite serving it
+        int target = destination;
+        int serving = m_forwarding->GetAttachment(destination);
+        if (serving >= 0) {
+            target = serving;
+            if (FindNeighbor(target, adjacency)) {
+                m_forwarding->CountDirect();
+                return MakeRoute(header, adjacency);
+            }
+        }
+
+        if (m_forwarding->IsTableRouted(m_nodeId) &&
+            FindNeighbor(m_forwarding->SelectNextHop(m_nodeId, target, flowHash), adjacency)) {
+            m_forwarding->CountTable();
+            return MakeRoute(header, adjacency);
+        }
+
+        if (FindNeighbor(m_forwarding->GetAttachment(m_nodeId), adjacency)) {
+            m_forwarding->CountUplink();
+            return MakeRoute(header, adjacency);
+        }
+
+        m_forwarding->CountFallThrough();
+        return Ptr<Ipv4Route>();
+    }
+
+    static uint32_t HashOf(Ptr<const Packet> packet, const Ipv4Header& header) {
+        uint16_t sourcePort = 0, destinationPort = 0;
+        if (packet && header.GetProtocol() == UdpL4Protocol::PROT_NUMBER) {
+            UdpHeader udp;
+            if (packet->PeekHeader(udp)) {
+                sourcePort = udp.GetSourcePort();
+                destinationPort = udp.GetDestinationPort();
+            }
+        } else if (packet && header.GetProtocol() == TcpL4Protocol::PROT_NUMBER) {
+            TcpHeader tcp;
+            if (packet->PeekHeader(tcp)) {
+                sourcePort = tcp.GetSourcePort();
+                destinationPort = tcp.GetDestinationPort();
+            }
+        }
+        return FlowHash(header.GetSource().Get(), header.GetDestination().Get(), header.GetProtocol(),
+                        sourcePort, destinationPort);
+    }
+
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::SatnetRouting")
+            .SetParent<Ipv4RoutingProtocol>()
+            .SetGroupName("Internet")
+            .AddConstructor<SatnetRouting>();
+        return tid;
+    }
+
+    SatnetRouting() : m_forwarding(nullptr), m_nodeId(0), m_neighborsValid(false) {}
+
+    /**
+     * Adds the hook to the node's Ipv4ListRouting; false when the node has none
+     */
+    static bool Install(Ptr<Node> node, SatnetForwarding* forwarding) {
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        Ptr<Ipv4ListRouting> list = ipv4 ? DynamicCast<Ipv4ListRouting>(ipv4->GetRoutingProtocol()) : Ptr<Ipv4ListRouting>();
+        if (!list) {
+            SATLOG_WARN(SATLOG_RMM, "Node {} has no Ipv4ListRouting: RMM tables not used for forwarding", node->GetId());
+            return false;
+        }
+        Ptr<SatnetRouting> routing = CreateObject<SatnetRouting>();
+        routing->m_forwarding = forwarding;
+        list->AddRoutingProtocol(routing, SATNET_ROUTING_PRIORITY);
+        return true;
+    }
+
+    Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p, const Ipv4Header& header, Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr) override {
+        Ptr<Ipv4Route> route = Decide(header, HashOf(Ptr<const Packet>(), header));
+        if (route && oif && route->GetOutputDevice() != oif) route = Ptr<Ipv4Route>();
+        sockerr = route ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+        return route;
+    }
+
+    bool RouteInput(Ptr<const Packet> p, const Ipv4Header& header, Ptr<const NetDevice> idev,
+                    UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                    LocalDeliverCallback lcb, ErrorCallback ecb) override {
+        Ipv4Address destination = header.GetDestination();
+        if (destination.IsMulticast() || destination.IsBroadcast()) return false;
+        // Local delivery stays with Ipv4ListRouting
+        if (m_ipv4->IsDestinationAddress(destination, m_ipv4->GetInterfaceForDevice(idev))) return false;
+
+        Ptr<Ipv4Route> route = Decide(header, HashOf(p, header));
+        if (!route) return false;
+        ucb(route, p, header);
+        return true;
+    }
+
+    void NotifyInterfaceUp(uint32_t interface) override {
+        m_neighborsValid = false;
+    }
+
+    void NotifyInterfaceDown(uint32_t interface) override {
+        m_neighborsValid = false;
+    }
+
+    void NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) override {
+        RegisterAddress(address);
+        m_neighborsValid = false;
+    }
+
+    void NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) override {
+        m_neighborsValid = false;
+    }
+
+    void SetIpv4(Ptr<Ipv4> ipv4) override {
+        m_ipv4 = ipv4;
+        m_nodeId = ipv4->GetObject<Node>()->GetId();
+        for (uint32_t i = 0; i < ipv4->GetNInterfaces(); i++) {
+            for (uint32_t j = 0; j < ipv4->GetNAddresses(i); j++) {
+                RegisterAddress(ipv4->GetAddress(i, j));
+            }
+        }
+        m_neighborsValid = false;
+    }
+
+    void PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const override {
+        std::ostream* os = stream->GetStream();
+        *os << "Node " << m_nodeId << (m_forwarding && m_forwarding->IsTableRouted(m_nodeId) ? ", RMM table" : "")
+            << ", neighbours:";
+        for (const auto& neighbor : m_neighbors) {
+            *os << " " << neighbor.first << "@if" << neighbor.second.interface;
+        }
+        *os << std::endl;
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(SatnetRouting);
+
+#endif // SATNET_ROUTING_H
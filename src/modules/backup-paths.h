@@ -0,0 +1,256 @@
+#ifndef BACKUP_PATHS_H
+#define BACKUP_PATHS_H
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cstdint>
+
+const uint16_t UNREACHABLE_HOPS = 0xFFFF;     // Unreachable (hop count)
+
+/**
+ * Precomputed backup next hops for fast failover on unpredicted link failures
+ * Keeps up to k loop-free alternates (RFC 5286 LFA condition) per (node, destination).
+ * Hop-count distances are kept per source and only the rows whose shortest-path
+ * tree is touched by a link change are recomputed.
+ */
+class BackupPathTable {
+private:
+    uint32_t m_numNodes;
+    uint32_t m_k;                                   // next hops kept per destination
+    std::vector<std::vector<int>> m_adjacency;      // currently usable links
+    std::vector<uint16_t> m_distances;              // N x N hop counts
+    std::vector<int16_t> m_nextHops;                // N x N x k, best first, -1 padded
+    std::vector<uint8_t> m_distanceDirty;
+    std::vector<uint8_t> m_tableDirty;
+
+    uint64_t m_distanceRowsComputed;
+    uint64_t m_tableRowsComputed;
+    uint64_t m_failovers;
+
+    uint16_t Distance(int from, int to) const {
+        return m_distances[(size_t)from * m_numNodes + to];
+    }
+
+    bool IsValidNode(int node) const {
+        return node >= 0 && (uint32_t)node < m_numNodes;
+    }
+
+public:
+    BackupPathTable(uint32_t k = 3)
+        : m_numNodes(0), m_k(k > 0 ? k : 1), m_distanceRowsComputed(0), m_tableRowsComputed(0), m_failovers(0) {}
+
+    void Resize(uint32_t numNodes) {
+        if (numNodes <= m_numNodes) return;
+
+        std::vector<std::vector<int>> adjacency = m_adjacency;
+        adjacency.resize(numNodes);
+        m_adjacency.swap(adjacency);
+
+        m_numNodes = numNodes;
+        m_distances.assign((size_t)numNodes * numNodes, UNREACHABLE_HOPS);
+        m_nextHops.assign((size_t)numNodes * numNodes * m_k, -1);
+        m_distanceDirty.assign(numNodes, 1);
+        m_tableDirty.assign(numNodes, 1);
+    }
+
+    /**
+     * Records a link change and marks the affected rows
+     */
+    void SetLinkState(int nodeA, int nodeB, bool isUp) {
+        if (nodeA < 0 || nodeB < 0 || nodeA == nodeB) return;
+        Resize(std::max(nodeA, nodeB) + 1);
+
+        std::vector<int>& neighborsA = m_adjacency[nodeA];
+        bool present = std::find(neighborsA.begin(), neighborsA.end(), nodeB) != neighborsA.end();
+        if (present == isUp) return;
+
+        for (uint32_t s = 0; s < m_numNodes; s++) {
+            if (m_distanceDirty[s]) continue;
+
+            uint32_t distA = Distance(s, nodeA);
+            uint32_t distB = Distance(s, nodeB);
+            bool affected = isUp ? (distA + 1 < distB || distB + 1 < distA)
+                                 : (distA + 1 == distB || distB + 1 == distA);
+            if (affected) {
+                m_distanceDirty[s] = 1;
+            }
+        }
+
+        if (isUp) {
+            m_adjacency[nodeA].push_back(nodeB);
+            m_adjacency[nodeB].push_back(nodeA);
+        } else {
+            std::vector<int>& neighborsB = m_adjacency[nodeB];
+            neighborsA.erase(std::remove(neighborsA.begin(), neighborsA.end(), nodeB), neighborsA.end());
+            neighborsB.erase(std::remove(neighborsB.begin(), neighborsB.end(), nodeA), neighborsB.end());
+        }
+
+        m_tableDirty[nodeA] = 1;
+        m_tableDirty[nodeB] = 1;
+    }
+
+    bool IsLinkUp(int nodeA, int nodeB) const {
+        if (!IsValidNode(nodeA) || !IsValidNode(nodeB)) return false;
+        const std::vector<int>& neighbors = m_adjacency[nodeA];
+        return std::find(neighbors.begin(), neighbors.end(), nodeB) != neighbors.end();
+    }
+
+    /**
+     * Recomputes the dirty distance rows, then the backup rows depending on them
+     */
+    void Refresh() {
+        std::vector<int> changed;
+        for (uint32_t s = 0; s < m_numNodes; s++) {
+            if (m_distanceDirty[s]) {
+                ComputeDistanceRow(s);
+                m_distanceDirty[s] = 0;
+                changed.push_back(s);
+            }
+        }
+
+        // Row s of the table reads the distance rows of s and of its neighbors
+        for (int node : changed) {
+            m_tableDirty[node] = 1;
+            for (int neighbor : m_adjacency[node]) {
+                m_tableDirty[neighbor] = 1;
+            }
+        }
+
+        for (uint32_t s = 0; s < m_numNodes; s++) {
+            if (m_tableDirty[s]) {
+                ComputeTableRow(s);
+                m_tableDirty[s] = 0;
+            }
+        }
+    }
+
+    /**
+     * First usable next hop from source to destination, skipping a failed neighbor
+     * Returns -1 if no precomputed alternate survives
+     */
+    int GetNextHop(int source, int destination, int failedNeighbor = -1) const {
+        if (!IsValidNode(source) || !IsValidNode(destination)) return -1;
+
+        const int16_t* hops = &m_nextHops[((size_t)source * m_numNodes + destination) * m_k];
+        for (uint32_t i = 0; i < m_k && hops[i] >= 0; i++) {
+            if (hops[i] != failedNeighbor && IsLinkUp(source, hops[i])) {
+                return hops[i];
+            }
+        }
+        return -1;
+    }
+
+    int GetPrimaryNextHop(int source, int destination) const {
+        if (!IsValidNode(source) || !IsValidNode(destination)) return -1;
+        return m_nextHops[((size_t)source * m_numNodes + destination) * m_k];
+    }
+
+    /**
+     * Hop count from source to destination, UNREACHABLE_HOPS without a path
+     */
+    uint16_t GetHopCount(int source, int destination) const {
+        if (!IsValidNode(source) || !IsValidNode(destination)) return UNREACHABLE_HOPS;
+        return Distance(source, destination);
+    }
+
+    /**
+     * All shortest-path (equal-cost) next hops from source to destination
+     */
+    std::vector<int> GetEqualCostNextHops(int source, int destination) const {
+        std::vector<int> nextHops;
+        if (!IsValidNode(source) || !IsValidNode(destination) || source == destination) return nextHops;
+
+        uint16_t ownDistance = Distance(source, destination);
+        if (ownDistance == UNREACHABLE_HOPS) return nextHops;
+
+        for (int n : m_adjacency[source]) {
+            if (Distance(n, destination) + 1 == ownDistance) {
+                nextHops.push_back(n);
+            }
+        }
+        return nextHops;
+    }
+
+    /**
+     * Local repair after an unpredicted failure of source<->failedNeighbor
+     * Returns (destination, backup next hop) for every destination that was using the link
+     */
+    std::vector<std::pair<int, int>> Failover(int source, int failedNeighbor) {
+        std::vector<std::pair<int, int>> repairs;
+        if (!IsValidNode(source)) return repairs;
+
+        for (uint32_t d = 0; d < m_numNodes; d++) {
+            if ((int)d == source || GetPrimaryNextHop(source, d) != failedNeighbor) continue;
+
+            int backup = GetNextHop(source, d, failedNeighbor);
+            if (backup >= 0) {
+                repairs.push_back(std::make_pair((int)d, backup));
+            }
+        }
+
+        m_failovers += repairs.size();
+        return repairs;
+    }
+
+    uint32_t GetNodeCount() const { return m_numNodes; }
+    uint64_t GetDistanceRowsComputed() const { return m_distanceRowsComputed; }
+    uint64_t GetTableRowsComputed() const { return m_tableRowsComputed; }
+    uint64_t GetFailoverCount() const { return m_failovers; }
+
+private:
+    void ComputeDistanceRow(uint32_t source) {
+        uint16_t* row = &m_distances[(size_t)source * m_numNodes];
+        std::fill(row, row + m_numNodes, UNREACHABLE_HOPS);
+
+        std::deque<int> queue;
+        row[source] = 0;
+        queue.push_back(source);
+
+        while (!queue.empty()) {
+            int node = queue.front();
+            queue.pop_front();
+            for (int neighbor : m_adjacency[node]) {
+                if (row[neighbor] == UNREACHABLE_HOPS) {
+                    row[neighbor] = row[node] + 1;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+        m_distanceRowsComputed++;
+    }
+
+    /**
+     * Neighbor n is kept for destination d if dist(n,d) < dist(n,s) + dist(s,d) (loop-free)
+     */
+    void ComputeTableRow(uint32_t source) {
+        const std::vector<int>& neighbors = m_adjacency[source];
+        std::vector<std::pair<uint16_t, int>> candidates;
+        candidates.reserve(neighbors.size());
+
+        for (uint32_t d = 0; d < m_numNodes; d++) {
+            int16_t* hops = &m_nextHops[((size_t)source * m_numNodes + d) * m_k];
+            std::fill(hops, hops + m_k, (int16_t)-1);
+
+            uint16_t ownDistance = Distance(source, d);
+            if (d == source || ownDistance == UNREACHABLE_HOPS) continue;
+
+            candidates.clear();
+            for (int n : neighbors) {
+                uint16_t neighborDistance = Distance(n, d);
+                if (neighborDistance != UNREACHABLE_HOPS && neighborDistance < 1 + (uint32_t)ownDistance) {
+                    candidates.push_back(std::make_pair(neighborDistance, n));
+                }
+            }
+            std::sort(candidates.begin(), candidates.end());
+
+            for (uint32_t i = 0; i < m_k && i < candidates.size(); i++) {
+                hops[i] = (int16_t)candidates[i].second;
+            }
+        }
+        m_tableRowsComputed++;
+    }
+};
+
+#endif // BACKUP_PATHS_H
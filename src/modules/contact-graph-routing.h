@@ -0,0 +1,286 @@
+#ifndef CONTACT_GRAPH_ROUTING_H
+#define CONTACT_GRAPH_ROUTING_H
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <map>
+#include <functional>
+#include <limits>
+#include <chrono>
+#include <sstream>
+#include "ns3/core-module.h"
+#include "../core/constellation.h"
+#include "route-mgmt.h"
+
+using namespace ns3;
+
+/**
+ * One directed contact extracted from a TopologyModel interval
+ */
+struct Contact {
+    int from;
+    int to;
+    double start;
+    double end;
+    double owlt;    // one-way light time (propagation delay)
+
+    Contact(int f, int t, double s, double e, double d) : from(f), to(t), start(s), end(e), owlt(d) {}
+};
+
+/**
+ * Result of an earliest-arrival search towards one destination
+ */
+struct CgrRoute {
+    int nextHop;          // -1 if the destination is unreachable in the contact plan
+    double arrivalTime;   // earliest arrival at the destination
+    double validUntil;    // end of the first contact of the path to end, route must be recomputed after
+    uint32_t hops;
+
+    CgrRoute() : nextHop(-1), arrivalTime(std::numeric_limits<double>::infinity()), validUntil(0), hops(0) {}
+};
+
+/**
+ * Contact Graph Routing (CGR) engine
+ * Earliest-arrival Dijkstra over the contact plan, used as an RMM route source
+ * instead of Quagga OSPF (no DCE processes involved)
+ *
+ * A route stays the earliest-arrival one until a contact of its path ends: departing
+ * later only removes options. Route updates therefore recompute only the pairs whose
+ * path lost a contact since the previous call, and emit only the next hops that changed.
+ */
+class ContactGraphRouter : public RouteSource {
+private:
+    typedef std::unordered_map<uint64_t, CgrRoute> RouteBucket;                 // (source, destination) -> route
+    typedef std::pair<double, uint64_t> Expiry;                                 // (validUntil, pair)
+
+    std::vector<std::vector<Contact>> m_contactsFrom;      // contacts indexed by sending node
+    std::map<uint32_t, RouteBucket> m_routeTable;          // departure-time bucket -> routes, oldest first
+    double m_bucketSize;                                   // departure-time bucket width (s)
+    double m_owlt;
+    int m_numNodes;
+
+    std::vector<CgrRoute> m_installed;                     // N x N, routes last handed to RMM
+    std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> m_expiries;
+    bool m_planChanged;                                    // new contact plan: every pair is recomputed
+
+    uint64_t m_searches;
+    uint64_t m_cacheHits;
+    uint64_t m_cacheMisses;
+    double m_computeTimeMs;
+
+    // Directed (source, destination) pair, 32-bit halves as MakeLinkKey
+    uint64_t MakeRouteKey(int source, int destination) const {
+        return ((uint64_t)(uint32_t)source << 32) | (uint32_t)destination;
+    }
+
+    uint32_t GetBucket(double time) const {
+        return (uint32_t)(std::max(time, 0.0) / m_bucketSize);
+    }
+
+public:
+    ContactGraphRouter(double bucketSize = 1.0, double owlt = 0.020)
+        : m_bucketSize(bucketSize > 0 ? bucketSize : 1.0), m_owlt(owlt), m_numNodes(0), m_planChanged(true),
+          m_searches(0), m_cacheHits(0), m_cacheMisses(0), m_computeTimeMs(0.0) {}
+
+    std::string GetName() const override { return "CGR"; }
+
+    /**
+     * Expands the TopologyModel intervals into directed contacts over [horizonStart, horizonEnd]
+     */
+    void LoadContactPlan(const TopologyModel& model, double horizonStart, double horizonEnd) {
+        m_contactsFrom.clear();
+        m_routeTable.clear();
+        m_numNodes = 0;
+        m_planChanged = true;
+
+        for (size_t i = 0; i < model.GetLinkCount(); i++) {
+            const TopologyModel::Link& link = model.GetLink(i);
+            m_numNodes = std::max(m_numNodes, std::max(link.nodeA, link.nodeB) + 1);
+        }
+        m_contactsFrom.resize(m_numNodes);
+
+        size_t contactCount = 0;
+        for (size_t i = 0; i < model.GetLinkCount(); i++) {
+            const TopologyModel::Link& link = model.GetLink(i);
+            if (link.nodeA < 0 || link.nodeB < 0) continue;
+
+            double offset = 0.0;
+            if (link.isPeriodic && link.period > 0) {
+                offset = std::floor(horizonStart / link.period) * link.period;
+            }
+
+            do {
+                for (const auto& interval : link.intervals) {
+                    double start = std::max(interval.startTime + offset, horizonStart);
+                    double end = std::min(interval.endTime + offset, horizonEnd);
+                    if (end <= start) continue;
+
+                    m_contactsFrom[link.nodeA].push_back(Contact(link.nodeA, link.nodeB, start, end, m_owlt));
+                    m_contactsFrom[link.nodeB].push_back(Contact(link.nodeB, link.nodeA, start, end, m_owlt));
+                    contactCount += 2;
+                }
+                offset += link.period;
+            } while (link.isPeriodic && link.period > 0 && offset < horizonEnd);
+        }
+
+        SATLOG_INFO(SATLOG_RMM, "CGR: Loaded {} contacts for {} nodes over [{}s, {}s]",
+                    contactCount, m_numNodes, horizonStart, horizonEnd);
+    }
+
+    /**
+     * Route lookup through the (destination, departure-time bucket) table
+     */
+    CgrRoute FindRoute(int source, int destination, double departureTime) {
+        if (source < 0 || destination < 0 || source >= m_numNodes || destination >= m_numNodes) {
+            return CgrRoute();
+        }
+
+        uint32_t bucket = GetBucket(departureTime);
+        RouteBucket& routes = m_routeTable[bucket];
+        auto it = routes.find(MakeRouteKey(source, destination));
+        if (it != routes.end() && departureTime < it->second.validUntil) {
+            m_cacheHits++;
+            return it->second;
+        }
+
+        m_cacheMisses++;
+        // A single search fills the routes towards every destination for this bucket
+        ComputeRoutesFrom(source, departureTime, routes, bucket);
+
+        it = routes.find(MakeRouteKey(source, destination));
+        return (it != routes.end()) ? it->second : CgrRoute();
+    }
+
+    std::vector<std::pair<Ptr<Node>, std::string>> ComputeRouteUpdates(double currentTime) override {
+        std::vector<std::pair<Ptr<Node>, std::string>> updates;
+        PurgeOldBuckets(currentTime);
+
+        size_t pairs = (size_t)m_numNodes * m_numNodes;
+        if (m_planChanged || m_installed.size() != pairs) {
+            // New contact plan: every pair is due, installed next hops are kept to diff against
+            std::vector<CgrRoute> installed(pairs);
+            for (size_t i = 0; i < m_installed.size() && i < pairs; i++) installed[i] = m_installed[i];
+            m_installed.swap(installed);
+            m_expiries = decltype(m_expiries)();
+            for (int source = 0; source < m_numNodes; source++) {
+                for (int destination = 0; destination < m_numNodes; destination++) {
+                    if (destination != source) m_expiries.push(Expiry(0.0, MakeRouteKey(source, destination)));
+                }
+            }
+            m_planChanged = false;
+        }
+
+        uint32_t totalNodes = NodeList::GetNNodes();
+        while (!m_expiries.empty() && m_expiries.top().first <= currentTime) {
+            Expiry due = m_expiries.top();
+            m_expiries.pop();
+
+            int source = (int)(uint32_t)(due.second >> 32);
+            int destination = (int)(uint32_t)due.second;
+            CgrRoute& installed = m_installed[(size_t)source * m_numNodes + destination];
+            if (due.first != 0.0 && due.first != installed.validUntil) continue;   // recomputed since
+
+            CgrRoute route = FindRoute(source, destination, currentTime);
+            if (route.nextHop >= 0) {
+                m_expiries.push(Expiry(route.validUntil, due.second));
+            }
+
+            Ptr<Node> node = ((uint32_t)source < totalNodes) ? NodeList::GetNode(source) : nullptr;
+            if (node && installed.nextHop >= 0 && installed.nextHop != route.nextHop) {
+                updates.push_back(std::make_pair(node, "DEL " + NodePrefix(destination) + " " + NodeNextHop(installed.nextHop)));
+            }
+            if (node && route.nextHop >= 0 && (route.nextHop != installed.nextHop || route.hops != installed.hops)) {
+                std::ostringstream update;
+                update << "ADD " << NodePrefix(destination) << " " << NodeNextHop(route.nextHop) << " " << route.hops;
+                updates.push_back(std::make_pair(node, update.str()));
+            }
+            installed = route;
+        }
+
+        return updates;
+    }
+
+    uint64_t GetSearchCount() const { return m_searches; }
+    uint64_t GetCacheHits() const { return m_cacheHits; }
+    uint64_t GetCacheMisses() const { return m_cacheMisses; }
+    double GetComputeTimeMs() const { return m_computeTimeMs; }
+
+    void PrintStatistics() const {
+        std::cout << "CGR statistics:" << std::endl;
+        std::cout << "   Dijkstra searches: " << m_searches << std::endl;
+        std::cout << "   Route cache hits/misses: " << m_cacheHits << "/" << m_cacheMisses << std::endl;
+        size_t entries = 0;
+        for (const auto& bucket : m_routeTable) entries += bucket.second.size();
+        std::cout << "   Route table entries: " << entries << " in " << m_routeTable.size() << " buckets" << std::endl;
+        std::cout << "   Computation time: " << m_computeTimeMs << " ms" << std::endl;
+    }
+
+private:
+    /**
+     * Earliest-arrival Dijkstra from one source (contacts are FIFO, so node labels suffice)
+     */
+    void ComputeRoutesFrom(int source, double departureTime, RouteBucket& table, uint32_t bucket) {
+        auto begin = std::chrono::steady_clock::now();
+        m_searches++;
+
+        const double inf = std::numeric_limits<double>::infinity();
+        std::vector<double> arrival(m_numNodes, inf);
+        std::vector<CgrRoute> routes(m_numNodes);
+
+        typedef std::pair<double, int> QueueEntry;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+        arrival[source] = departureTime;
+        queue.push(QueueEntry(departureTime, source));
+
+        while (!queue.empty()) {
+            QueueEntry top = queue.top();
+            queue.pop();
+
+            int node = top.second;
+            if (top.first > arrival[node]) continue;
+
+            for (const Contact& contact : m_contactsFrom[node]) {
+                if (contact.end <= arrival[node]) continue;
+
+                double sendTime = std::max(arrival[node], contact.start);
+                double arriveTime = sendTime + contact.owlt;
+                if (arriveTime >= arrival[contact.to]) continue;
+
+                arrival[contact.to] = arriveTime;
+                CgrRoute& route = routes[contact.to];
+                route.arrivalTime = arriveTime;
+                if (node == source) {
+                    route.nextHop = contact.to;
+                    route.validUntil = contact.end;
+                    route.hops = 1;
+                } else {
+                    route.nextHop = routes[node].nextHop;
+                    route.validUntil = std::min(routes[node].validUntil, contact.end);
+                    route.hops = routes[node].hops + 1;
+                }
+                queue.push(QueueEntry(arriveTime, contact.to));
+            }
+        }
+
+        for (int destination = 0; destination < m_numNodes; destination++) {
+            if (destination == source) continue;
+            if (routes[destination].nextHop < 0) {
+                routes[destination].validUntil = (bucket + 1) * m_bucketSize;
+            }
+            table[MakeRouteKey(source, destination)] = routes[destination];
+        }
+
+        m_computeTimeMs += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - begin).count();
+    }
+
+    // Buckets are ordered by time: the expired ones are the front of the map
+    void PurgeOldBuckets(double currentTime) {
+        m_routeTable.erase(m_routeTable.begin(), m_routeTable.lower_bound(GetBucket(currentTime)));
+    }
+};
+
+#endif // CONTACT_GRAPH_ROUTING_H
@@ -0,0 +1,487 @@
+#ifndef CONVERGENCE_MONITOR_H
+#define CONVERGENCE_MONITOR_H
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include "ns3/core-module.h"
+#include "../core/link-key.h"
+#include "../helpers/async-logger.h"
+#include "backup-paths.h"
+
+using namespace ns3;
+
+const int CONVERGENCE_NO_ROUTE = -1;
+const uint32_t CONVERGENCE_NOT_AFFECTED = UINT32_MAX;
+const double CONVERGENCE_POLL_INTERVAL = 0.05;     // s between two reads of the polled tables
+
+/**
+ * Measured convergence of a predicted event: are the routing tables already what OSPF
+ * computes without the link?
+ *
+ * A prefix belongs to one node (RMM convention, NodePrefix: 10.<node / 256>.<node % 256>.0/24) or to both ends of an
+ * ISL subnet (kernel FIB of a DCE node). At T1, with the link already down:
+ * - affected prefixes: those a shortest path may reach through the link, i.e. whose hop
+ *   distances from the two ends differ by one; every other route stays valid
+ * - per affected prefix, the post-failure hop distances (one BFS from its owners)
+ * - a next hop is valid when it is a neighbour over an up link one hop closer, so any
+ *   equal-cost choice counts; no route is valid only for an unreachable prefix
+ * The event has converged when no tracked node holds an invalid next hop for an affected
+ * prefix; the mismatch count is kept up to date instead of rescanning the tables.
+ *
+ * Tables are read through a RouteReader:
+ * - pushed nodes (OSPF model): each next-hop change re-checks that (node, prefix) only
+ * - polled nodes (DCE kernel FIB): every poll interval, the node's next hops for the
+ *   affected prefixes are folded into a hash; only nodes whose hash changed are re-checked
+ * A link change while an event is open updates its expected state on the new topology:
+ * two BFS from the event's link ends re-derive the affected prefixes; if they are the same,
+ * only the prefixes whose distances the changed link can move get a new BFS and a re-check
+ * of the tracked nodes (the others re-check the link's two ends). A changed affected set
+ * rebuilds the whole event.
+ */
+class ConvergenceMonitor {
+public:
+    typedef std::function<int(uint32_t node, uint32_t prefix)> RouteReader;
+    typedef std::function<void(int nodeA, int nodeB, double convergence)> ConvergedCallback;
+
+private:
+    enum NodeMode : uint8_t {
+        NODE_UNTRACKED,
+        NODE_PUSHED,
+        NODE_POLLED
+    };
+
+    struct Link {
+        uint32_t nodeA;
+        uint32_t nodeB;
+        bool up;
+    };
+
+    struct Event {
+        int nodeA;
+        int nodeB;
+        double start;
+        bool converged;
+        std::vector<uint32_t> prefixes;     // Affected prefixes
+        std::vector<uint32_t> slot;         // Per prefix, index in prefixes (or NOT_AFFECTED)
+        std::vector<uint16_t> distances;    // prefixes x nodes, post-failure hops to the prefix
+        std::vector<uint8_t> invalid;       // prefixes x nodes
+        std::vector<uint64_t> hashes;       // Per polled node, next hops at the last poll
+        uint32_t mismatches;
+    };
+
+    uint32_t m_numNodes;
+    std::vector<Link> m_links;
+    FlatLinkMap<uint32_t> m_linkIndex;
+    std::vector<std::vector<uint32_t>> m_adjacency;     // Link indices per node
+    std::vector<std::pair<uint32_t, uint32_t>> m_owners;
+    std::vector<uint8_t> m_mode;
+    std::vector<uint32_t> m_polled;
+
+    RouteReader m_reader;
+    ConvergedCallback m_callback;
+    double m_pollInterval;
+    bool m_pollScheduled;
+    std::deque<Event> m_events;
+
+    // BFS scratch
+    std::vector<uint32_t> m_queue;
+    std::vector<uint16_t> m_fromA;
+    std::vector<uint16_t> m_fromB;
+    std::vector<uint32_t> m_affected;
+
+    uint64_t m_started;
+    uint64_t m_converged;
+    uint64_t m_late;
+    uint64_t m_checks;
+    uint64_t m_polls;
+    uint64_t m_rebuilds;        // Prefixes recomputed after a link change
+    double m_maxConvergence;
+
+    void Grow(uint32_t node) {
+        if (node < m_numNodes) return;
+        m_numNodes = node + 1;
+        m_adjacency.resize(m_numNodes);
+        m_mode.resize(m_numNodes, NODE_UNTRACKED);
+    }
+
+    /**
+     * Hop distances from the sources over the up links (plus forcedUp, if any)
+     */
+    void Distances(uint32_t sourceA, uint32_t sourceB, const Link* forcedUp, uint16_t* out) {
+        std::fill(out, out + m_numNodes, UNREACHABLE_HOPS);
+        m_queue.clear();
+        out[sourceA] = 0;
+        out[sourceB] = 0;
+        m_queue.push_back(sourceA);
+        if (sourceB != sourceA) m_queue.push_back(sourceB);
+
+        for (size_t head = 0; head < m_queue.size(); head++) {
+            uint32_t node = m_queue[head];
+            for (uint32_t index : m_adjacency[node]) {
+                const Link& link = m_links[index];
+                if (!link.up && &link != forcedUp) continue;
+                uint32_t next = (link.nodeA == node) ? link.nodeB : link.nodeA;
+                if (out[next] != UNREACHABLE_HOPS) continue;
+                out[next] = out[node] + 1;
+                m_queue.push_back(next);
+            }
+        }
+    }
+
+    uint16_t PrefixDistance(const std::vector<uint16_t>& from, uint32_t prefix) const {
+        return std::min(from[m_owners[prefix].first], from[m_owners[prefix].second]);
+    }
+
+    bool IsValid(uint32_t node, uint32_t prefix, const uint16_t* distances, int nextHop) const {
+        if (node == m_owners[prefix].first || node == m_owners[prefix].second) return true;
+        if (distances[node] == UNREACHABLE_HOPS) return nextHop == CONVERGENCE_NO_ROUTE;
+        if (nextHop < 0 || (uint32_t)nextHop >= m_numNodes || distances[nextHop] + 1 != distances[node]) return false;
+
+        for (uint32_t index : m_adjacency[node]) {
+            const Link& link = m_links[index];
+            if (link.up && (link.nodeA == (uint32_t)nextHop || link.nodeB == (uint32_t)nextHop)) return true;
+        }
+        return false;
+    }
+
+    void Check(Event& event, uint32_t slot, uint32_t node) {
+        m_checks++;
+        uint32_t prefix = event.prefixes[slot];
+        size_t cell = (size_t)slot * m_numNodes + node;
+        bool invalid = !IsValid(node, prefix, &event.distances[(size_t)slot * m_numNodes], m_reader(node, prefix));
+        if (invalid == (bool)event.invalid[cell]) return;
+        event.invalid[cell] = invalid;
+        if (invalid) {
+            event.mismatches++;
+        } else {
+            event.mismatches--;
+        }
+    }
+
+    uint64_t HashNextHops(const Event& event, uint32_t node) const {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (uint32_t prefix : event.prefixes) {
+            hash ^= ((uint64_t)prefix << 32) | (uint32_t)(m_reader(node, prefix) + 1);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    /**
+     * Prefixes a shortest path may reach through the event's link, on the current topology
+     */
+    void AffectedPrefixes(const Event& event, std::vector<uint32_t>& prefixes) {
+        prefixes.clear();
+        const uint32_t* index = m_linkIndex.Find(MakeLinkKey(event.nodeA, event.nodeB));
+        if (!index) return;
+        const Link& failed = m_links[*index];
+
+        m_fromA.resize(m_numNodes);
+        m_fromB.resize(m_numNodes);
+        Distances(failed.nodeA, failed.nodeA, &failed, &m_fromA[0]);
+        Distances(failed.nodeB, failed.nodeB, &failed, &m_fromB[0]);
+        for (uint32_t prefix = 0; prefix < m_owners.size(); prefix++) {
+            uint16_t a = PrefixDistance(m_fromA, prefix);
+            uint16_t b = PrefixDistance(m_fromB, prefix);
+            if (a == UNREACHABLE_HOPS || b == UNREACHABLE_HOPS || (a + 1 != b && b + 1 != a)) continue;
+            prefixes.push_back(prefix);
+        }
+    }
+
+    /**
+     * Post-failure distances of one affected prefix, then a read of every tracked node
+     */
+    void BuildPrefix(Event& event, uint32_t slot) {
+        const std::pair<uint32_t, uint32_t>& owners = m_owners[event.prefixes[slot]];
+        Distances(owners.first, owners.second, nullptr, &event.distances[(size_t)slot * m_numNodes]);
+        for (uint32_t node = 0; node < m_numNodes; node++) {
+            if (m_mode[node] != NODE_UNTRACKED) Check(event, slot, node);
+        }
+    }
+
+    /**
+     * Expected state of an event on the current topology, then one full read of its prefixes
+     */
+    void Build(Event& event) {
+        AffectedPrefixes(event, event.prefixes);
+        event.slot.assign(m_owners.size(), CONVERGENCE_NOT_AFFECTED);
+        for (uint32_t slot = 0; slot < event.prefixes.size(); slot++) {
+            event.slot[event.prefixes[slot]] = slot;
+        }
+        event.mismatches = 0;
+
+        event.distances.resize(event.prefixes.size() * m_numNodes);
+        event.invalid.assign(event.prefixes.size() * m_numNodes, 0);
+        for (uint32_t slot = 0; slot < event.prefixes.size(); slot++) {
+            BuildPrefix(event, slot);
+        }
+
+        event.hashes.assign(m_polled.size(), 0);
+        for (uint32_t i = 0; i < m_polled.size(); i++) {
+            event.hashes[i] = HashNextHops(event, m_polled[i]);
+        }
+    }
+
+    /**
+     * The changed link (its new state already set) moves a prefix's distances only if it
+     * was on a shortest path (down) or shortens one (up)
+     */
+    void Update(Event& event, const Link& changed) {
+        AffectedPrefixes(event, m_affected);
+        if (m_affected != event.prefixes) {
+            m_rebuilds += m_affected.size();
+            Build(event);
+            return;
+        }
+
+        for (uint32_t slot = 0; slot < event.prefixes.size(); slot++) {
+            const uint16_t* distances = &event.distances[(size_t)slot * m_numNodes];
+            uint16_t a = distances[changed.nodeA];
+            uint16_t b = distances[changed.nodeB];
+            bool moved;
+            if (changed.up) {
+                moved = (a == UNREACHABLE_HOPS) != (b == UNREACHABLE_HOPS) ||
+                        (a != UNREACHABLE_HOPS && b != UNREACHABLE_HOPS && (a > b + 1 || b > a + 1));
+            } else {
+                moved = a != UNREACHABLE_HOPS && b != UNREACHABLE_HOPS && (a + 1 == b || b + 1 == a);
+            }
+
+            if (moved) {
+                m_rebuilds++;
+                BuildPrefix(event, slot);
+                continue;
+            }
+            // Same distances: only a next hop over the changed link changes validity
+            for (uint32_t node : {changed.nodeA, changed.nodeB}) {
+                if (m_mode[node] != NODE_UNTRACKED) Check(event, slot, node);
+            }
+        }
+    }
+
+    void Converge(Event& event) {
+        double now = Simulator::Now().GetSeconds();
+        double convergence = now - event.start;
+        event.converged = true;
+        m_converged++;
+        m_maxConvergence = std::max(m_maxConvergence, convergence);
+
+        // Expected state is no longer needed, only the verdict
+        std::vector<uint16_t>().swap(event.distances);
+        std::vector<uint8_t>().swap(event.invalid);
+        std::vector<uint64_t>().swap(event.hashes);
+
+        if (m_callback) {
+            m_callback(event.nodeA, event.nodeB, convergence);
+        }
+    }
+
+    /**
+     * Converged events are reported once the monitor state is consistent (callbacks may
+     * start or end events)
+     */
+    void ReportConverged() {
+        for (size_t i = 0; i < m_events.size(); i++) {
+            if (!m_events[i].converged && m_events[i].mismatches == 0) {
+                Converge(m_events[i]);
+            }
+        }
+    }
+
+    void SchedulePoll() {
+        if (m_pollScheduled || m_polled.empty() || !HasPending()) return;
+        m_pollScheduled = true;
+        Simulator::Schedule(Seconds(m_pollInterval), &ConvergenceMonitor::Poll, this);
+    }
+
+    void Poll() {
+        m_pollScheduled = false;
+        m_polls++;
+        for (Event& event : m_events) {
+            if (event.converged) continue;
+            for (uint32_t i = 0; i < m_polled.size(); i++) {
+                uint64_t hash = HashNextHops(event, m_polled[i]);
+                if (hash == event.hashes[i]) continue;
+                event.hashes[i] = hash;
+                for (uint32_t slot = 0; slot < event.prefixes.size(); slot++) {
+                    Check(event, slot, m_polled[i]);
+                }
+            }
+        }
+        ReportConverged();
+        SchedulePoll();
+    }
+
+    Event* FindEvent(int nodeA, int nodeB) {
+        uint64_t key = MakeLinkKey(nodeA, nodeB);
+        for (Event& event : m_events) {
+            if (MakeLinkKey(event.nodeA, event.nodeB) == key) return &event;
+        }
+        return nullptr;
+    }
+
+public:
+    ConvergenceMonitor()
+        : m_numNodes(0), m_pollInterval(CONVERGENCE_POLL_INTERVAL), m_pollScheduled(false),
+          m_started(0), m_converged(0), m_late(0), m_checks(0), m_polls(0), m_rebuilds(0), m_maxConvergence(0.0) {}
+
+    /**
+     * Next hop (node id) of a node towards a prefix, CONVERGENCE_NO_ROUTE without a route
+     */
+    void SetRouteReader(RouteReader reader) {
+        m_reader = reader;
+    }
+
+    /**
+     * Convergence time of an event (from its T1), as soon as its tables are consistent
+     */
+    void SetConvergedCallback(ConvergedCallback callback) {
+        m_callback = callback;
+    }
+
+    void SetPollInterval(double interval) {
+        if (interval > 0.0) m_pollInterval = interval;
+    }
+
+    /**
+     * A routing link, up at registration
+     */
+    void AddLink(int nodeA, int nodeB) {
+        uint64_t key = MakeLinkKey(nodeA, nodeB);
+        if (nodeA < 0 || nodeB < 0 || nodeA == nodeB || m_linkIndex.Find(key)) return;
+        Grow(std::max(nodeA, nodeB));
+
+        uint32_t index = m_links.size();
+        m_links.push_back({(uint32_t)std::min(nodeA, nodeB), (uint32_t)std::max(nodeA, nodeB), true});
+        m_linkIndex.Insert(key, index);
+        m_adjacency[m_links.back().nodeA].push_back(index);
+        m_adjacency[m_links.back().nodeB].push_back(index);
+    }
+
+    /**
+     * A prefix owned by one node (ownerB == ownerA) or by both ends of a subnet; returns its id
+     */
+    uint32_t AddPrefix(uint32_t ownerA, uint32_t ownerB) {
+        Grow(std::max(ownerA, ownerB));
+        m_owners.push_back(std::make_pair(ownerA, ownerB));
+        return m_owners.size() - 1;
+    }
+
+    /**
+     * A node whose table is checked: polled (read every poll interval) or pushed
+     * (OnRouteChange is called for each of its next-hop changes)
+     */
+    void TrackNode(uint32_t node, bool polled) {
+        Grow(node);
+        if (m_mode[node] == NODE_POLLED) return;
+        m_mode[node] = polled ? NODE_POLLED : NODE_PUSHED;
+        if (polled) m_polled.push_back(node);
+    }
+
+    /**
+     * Link state as reported to OSPF
+     */
+    void SetLinkState(int nodeA, int nodeB, bool isUp) {
+        const uint32_t* index = m_linkIndex.Find(MakeLinkKey(nodeA, nodeB));
+        if (!index || m_links[*index].up == isUp) return;
+        m_links[*index].up = isUp;
+
+        for (Event& event : m_events) {
+            if (!event.converged) Update(event, m_links[*index]);
+        }
+        ReportConverged();
+    }
+
+    /**
+     * T1 of a predicted event, its link already reported down
+     */
+    void Begin(int nodeA, int nodeB, double currentTime) {
+        if (!m_reader || FindEvent(nodeA, nodeB)) return;
+        m_started++;
+
+        m_events.push_back(Event());
+        Event& event = m_events.back();
+        event.nodeA = nodeA;
+        event.nodeB = nodeB;
+        event.start = currentTime;
+        event.converged = false;
+        Build(event);
+
+        SATLOG_LOGIC(SATLOG_RFP, "Convergence monitor: link {}<->{}, {} affected prefixes, {} routes to change",
+                     nodeA, nodeB, event.prefixes.size(), event.mismatches);
+        ReportConverged();
+        SchedulePoll();
+    }
+
+    /**
+     * The next hop of a pushed node towards this prefix changed
+     */
+    void OnRouteChange(uint32_t node, uint32_t prefix) {
+        if (node >= m_numNodes || m_mode[node] != NODE_PUSHED || prefix >= m_owners.size()) return;
+
+        bool converged = false;
+        for (Event& event : m_events) {
+            if (event.converged || event.slot[prefix] == CONVERGENCE_NOT_AFFECTED) continue;
+            Check(event, event.slot[prefix], node);
+            converged = converged || event.mismatches == 0;
+        }
+        if (converged) ReportConverged();
+    }
+
+    /**
+     * T2 of the event: stops tracking it. Returns whether it converged; pendingRoutes is the
+     * number of next hops still invalid otherwise.
+     */
+    bool End(int nodeA, int nodeB, uint32_t& pendingRoutes) {
+        pendingRoutes = 0;
+        uint64_t key = MakeLinkKey(nodeA, nodeB);
+        for (auto it = m_events.begin(); it != m_events.end(); ++it) {
+            if (MakeLinkKey(it->nodeA, it->nodeB) != key) continue;
+            bool converged = it->converged;
+            if (!converged) {
+                pendingRoutes = it->mismatches;
+                m_late++;
+            }
+            m_events.erase(it);
+            return converged;
+        }
+        return false;
+    }
+
+    bool HasLink(int nodeA, int nodeB) const {
+        return m_linkIndex.Find(MakeLinkKey(nodeA, nodeB)) != nullptr;
+    }
+
+    bool IsTracking(int nodeA, int nodeB) {
+        return FindEvent(nodeA, nodeB) != nullptr;
+    }
+
+    bool HasPending() const {
+        for (const Event& event : m_events) {
+            if (!event.converged) return true;
+        }
+        return false;
+    }
+
+    uint64_t GetConvergedCount() const { return m_converged; }
+    uint64_t GetLateCount() const { return m_late; }
+
+    void PrintStatistics() const {
+        std::cout << "Convergence monitor statistics:" << std::endl;
+        std::cout << "   Prefixes: " << m_owners.size() << ", tracked nodes: "
+                  << m_numNodes - std::count(m_mode.begin(), m_mode.end(), NODE_UNTRACKED)
+                  << " (" << m_polled.size() << " polled)" << std::endl;
+        std::cout << "   Events: " << m_started << ", converged before T2: " << m_converged
+                  << ", Tc insufficient: " << m_late << std::endl;
+        std::cout << "   Route checks: " << m_checks << ", polls: " << m_polls
+                  << ", prefixes rebuilt on link changes: " << m_rebuilds << std::endl;
+        if (m_converged > 0) {
+            std::cout << "   Slowest convergence: " << m_maxConvergence * 1000.0 << " ms" << std::endl;
+        }
+    }
+};
+
+#endif // CONVERGENCE_MONITOR_H
@@ -0,0 +1,147 @@
+#ifndef FLOW_TRACKER_H
+#define FLOW_TRACKER_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+const uint32_t FLOW_WINDOW = 1024;          // Sequence numbers in flight per flow (power of 2)
+
+/**
+ * Lost probe: flow and send time
+ */
+struct ProbeLoss {
+    uint32_t flow;
+    double txTime;      // s
+
+    bool operator<(const ProbeLoss& other) const { return txTime < other.txTime; }
+};
+
+/**
+ * Per-flow loss detection over sequence-numbered probes
+ * Each flow keeps a sliding window of FLOW_WINDOW sequence numbers: a received bitmap
+ * and the send times. A sequence number leaving the window without its bit set is lost
+ * (late arrivals beyond the window count as lost). Tx/Rx hooks are O(1), the only
+ * allocation is the append to the loss log.
+ */
+class FlowLossTracker {
+private:
+    struct Flow {
+        double interval;                    // s, probe spacing
+        uint32_t base;                      // oldest sequence number still in the window
+        uint32_t nextSeq;                   // one past the highest sequence number sent
+        uint64_t sent;
+        uint64_t received;
+        uint64_t lost;
+        std::vector<uint64_t> receivedBits;
+        std::vector<double> txTimes;
+
+        Flow(double i) : interval(i), base(0), nextSeq(0), sent(0), received(0), lost(0),
+                         receivedBits(FLOW_WINDOW / 64, 0), txTimes(FLOW_WINDOW, 0.0) {}
+    };
+
+    std::vector<Flow> m_flows;
+    std::vector<ProbeLoss> m_losses;
+    uint64_t m_lateArrivals;
+
+    static bool TestBit(const Flow& flow, uint32_t seq) {
+        uint32_t slot = seq & (FLOW_WINDOW - 1);
+        return (flow.receivedBits[slot >> 6] >> (slot & 63)) & 1;
+    }
+
+    /**
+     * Retires sequence numbers below newBase, recording the unreceived ones
+     */
+    void Slide(uint32_t flowId, uint32_t newBase) {
+        Flow& flow = m_flows[flowId];
+        for (; flow.base < newBase && flow.base < flow.nextSeq; flow.base++) {
+            uint32_t slot = flow.base & (FLOW_WINDOW - 1);
+            if (!TestBit(flow, flow.base)) {
+                flow.lost++;
+                m_losses.push_back(ProbeLoss{flowId, flow.txTimes[slot]});
+            }
+            flow.receivedBits[slot >> 6] &= ~(1ULL << (slot & 63));
+        }
+        flow.base = std::max(flow.base, newBase);
+    }
+
+public:
+    FlowLossTracker() : m_lateArrivals(0) {
+        m_losses.reserve(4096);
+    }
+
+    uint32_t AddFlow(double interval) {
+        m_flows.push_back(Flow(interval));
+        return m_flows.size() - 1;
+    }
+
+    void OnTx(uint32_t flowId, uint32_t seq, double now) {
+        if (flowId >= m_flows.size()) return;
+        Flow& flow = m_flows[flowId];
+        if (seq < flow.base) return;
+
+        if (seq >= flow.base + FLOW_WINDOW) {
+            Slide(flowId, seq - FLOW_WINDOW + 1);
+        }
+        flow.txTimes[seq & (FLOW_WINDOW - 1)] = now;
+        flow.nextSeq = std::max(flow.nextSeq, seq + 1);
+        flow.sent++;
+    }
+
+    void OnRx(uint32_t flowId, uint32_t seq) {
+        if (flowId >= m_flows.size()) return;
+        Flow& flow = m_flows[flowId];
+        if (seq < flow.base || seq >= flow.nextSeq) {
+            m_lateArrivals++;
+            return;
+        }
+
+        uint32_t slot = seq & (FLOW_WINDOW - 1);
+        uint64_t bit = 1ULL << (slot & 63);
+        if (!(flow.receivedBits[slot >> 6] & bit)) {
+            flow.receivedBits[slot >> 6] |= bit;
+            flow.received++;
+        }
+    }
+
+    /**
+     * Resolves every sequence number still in flight (end of simulation) and sorts the loss log
+     * Packets sent less than inFlightGrace seconds before now are not declared lost
+     */
+    void Finalize(double now, double inFlightGrace) {
+        for (uint32_t f = 0; f < m_flows.size(); f++) {
+            Flow& flow = m_flows[f];
+            uint32_t end = flow.base;
+            while (end < flow.nextSeq && flow.txTimes[end & (FLOW_WINDOW - 1)] < now - inFlightGrace) {
+                end++;
+            }
+            Slide(f, end);
+        }
+        std::sort(m_losses.begin(), m_losses.end());
+    }
+
+    const std::vector<ProbeLoss>& GetLosses() const { return m_losses; }
+    uint32_t GetFlowCount() const { return m_flows.size(); }
+    double GetInterval(uint32_t flowId) const { return m_flows[flowId].interval; }
+    uint64_t GetFlowSent(uint32_t flowId) const { return m_flows[flowId].sent; }
+    uint64_t GetFlowReceived(uint32_t flowId) const { return m_flows[flowId].received; }
+    uint64_t GetFlowLost(uint32_t flowId) const { return m_flows[flowId].lost; }
+
+    uint64_t GetSent() const {
+        uint64_t sent = 0;
+        for (const Flow& flow : m_flows) sent += flow.sent;
+        return sent;
+    }
+
+    uint64_t GetReceived() const {
+        uint64_t received = 0;
+        for (const Flow& flow : m_flows) received += flow.received;
+        return received;
+    }
+
+    uint64_t GetLost() const { return m_losses.size(); }
+    uint64_t GetLateArrivals() const { return m_lateArrivals; }
+};
+
+#endif // FLOW_TRACKER_H
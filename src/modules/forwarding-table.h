@@ -0,0 +1,375 @@
+#ifndef FORWARDING_TABLE_H
+#define FORWARDING_TABLE_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+using namespace ns3;
+
+const uint32_t MAX_ECMP_NEXT_HOPS = 8;
+const uint16_t ECMP_WEIGHT_SCALE = 64;      // Weight of an idle next hop
+
+/**
+ * Per-flow hash over the IPv4 5-tuple (same flow -> same next hop)
+ */
+inline uint32_t FlowHash(uint32_t src, uint32_t dst, uint8_t protocol, uint16_t srcPort, uint16_t dstPort) {
+    uint64_t h = ((uint64_t)src << 32) | dst;
+    h ^= ((uint64_t)protocol << 32) | ((uint32_t)srcPort << 16) | dstPort;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+/**
+ * RMM address convention, valid for node ids up to 65535:
+ * destination prefix "10.<node / 256>.<node % 256>.0/24", next hop "10.<neighbor / 256>.<neighbor % 256>.1"
+ */
+inline std::string NodePrefix(int node) {
+    return "10." + std::to_string(node / 256) + "." + std::to_string(node % 256) + ".0/24";
+}
+
+inline std::string NodeNextHop(int node) {
+    return "10." + std::to_string(node / 256) + "." + std::to_string(node % 256) + ".1";
+}
+
+inline int ParseNodeAddress(const std::string& address) {
+    int a = 0, high = -1, low = -1;
+    if (sscanf(address.c_str(), "%d.%d.%d.", &a, &high, &low) != 3) return -1;
+    if (a != 10 || high < 0 || high > 255 || low < 0 || low > 255) return -1;
+    return high * 256 + low;
+}
+
+inline int ParseDestinationNode(const std::string& prefix) {
+    return ParseNodeAddress(prefix);
+}
+
+inline int ParseNextHopNode(const std::string& nexthop) {
+    return ParseNodeAddress(nexthop);
+}
+
+/**
+ * Equal-cost next-hop set of one destination, fixed size (no allocation)
+ */
+struct NextHopSet {
+    uint8_t count;
+    uint32_t metric;
+    int16_t nextHops[MAX_ECMP_NEXT_HOPS];
+    uint16_t weights[MAX_ECMP_NEXT_HOPS];
+    uint32_t totalWeight;
+
+    NextHopSet() : count(0), metric(0), totalWeight(0) {}
+
+    void Add(int nextHop, uint16_t weight = ECMP_WEIGHT_SCALE) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (nextHops[i] == nextHop) return;
+        }
+        if (count >= MAX_ECMP_NEXT_HOPS || nextHop < 0) return;
+
+        nextHops[count] = (int16_t)nextHop;
+        weights[count] = std::max<uint16_t>(weight, 1);
+        totalWeight += weights[count];
+        count++;
+    }
+
+    void Remove(int nextHop) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (nextHops[i] == nextHop) {
+                totalWeight -= weights[i];
+                nextHops[i] = nextHops[count - 1];
+                weights[i] = weights[count - 1];
+                count--;
+                return;
+            }
+        }
+    }
+
+    void SetWeight(uint8_t index, uint16_t weight) {
+        weight = std::max<uint16_t>(weight, 1);
+        totalWeight = totalWeight - weights[index] + weight;
+        weights[index] = weight;
+    }
+
+    /**
+     * Weighted choice driven by the flow hash (equal weights = plain ECMP)
+     */
+    int Select(uint32_t flowHash) const {
+        if (count == 0) return -1;
+        if (count == 1) return nextHops[0];
+
+        uint32_t point = flowHash % totalWeight;
+        for (uint8_t i = 0; i < count; i++) {
+            if (point < weights[i]) return nextHops[i];
+            point -= weights[i];
+        }
+        return nextHops[count - 1];
+    }
+};
+
+/**
+ * ECMP weight of a next hop from its queue occupancy: an idle next hop weighs
+ * ECMP_WEIGHT_SCALE, a full queue weighs 1
+ */
+inline uint16_t LoadWeight(double occupancy) {
+    return std::max<uint16_t>((uint16_t)(ECMP_WEIGHT_SCALE * (1.0 - occupancy)), 1);
+}
+
+/**
+ * Samples the queue occupancy of the point-to-point devices of every link
+ * The (node, neighbor) pairs whose weight moved are kept until the next TakeChangedLinks.
+ */
+class LinkLoadMonitor {
+private:
+    std::map<std::pair<int, int>, Ptr<PointToPointNetDevice>> m_devices;   // (node, neighbor) -> device
+    std::map<std::pair<int, int>, double> m_occupancy;                      // (node, neighbor) -> [0, 1]
+    std::set<std::pair<int, int>> m_changed;                                // weight changed since the last take
+    double m_interval;
+    bool m_running;
+
+public:
+    LinkLoadMonitor(double interval = 0.1) : m_interval(interval), m_running(false) {}
+
+    /**
+     * Registers both devices of a point-to-point link between nodeA and nodeB
+     */
+    void AddLink(int nodeA, int nodeB, NetDeviceContainer devices) {
+        if (devices.GetN() < 2) return;
+        m_devices[std::make_pair(nodeA, nodeB)] = DynamicCast<PointToPointNetDevice>(devices.Get(0));
+        m_devices[std::make_pair(nodeB, nodeA)] = DynamicCast<PointToPointNetDevice>(devices.Get(1));
+    }
+
+    void Start(double startTime) {
+        if (m_running) return;
+        m_running = true;
+        Simulator::Schedule(Seconds(startTime), &LinkLoadMonitor::Sample, this);
+    }
+
+    void Stop() { m_running = false; }
+
+    double GetOccupancy(int node, int neighbor) const {
+        auto it = m_occupancy.find(std::make_pair(node, neighbor));
+        return (it != m_occupancy.end()) ? it->second : 0.0;
+    }
+
+    /**
+     * (node, neighbor) links whose weight changed since the previous call
+     */
+    void TakeChangedLinks(std::vector<std::pair<int, int>>& changed) {
+        changed.assign(m_changed.begin(), m_changed.end());
+        m_changed.clear();
+    }
+
+private:
+    void Sample() {
+        if (!m_running) return;
+
+        for (const auto& entry : m_devices) {
+            Ptr<PointToPointNetDevice> device = entry.second;
+            if (!device || !device->GetQueue()) continue;
+
+            double maxSize = device->GetQueue()->GetMaxSize().GetValue();
+            double current = device->GetQueue()->GetCurrentSize().GetValue();
+            double occupancy = (maxSize > 0) ? std::min(current / maxSize, 1.0) : 0.0;
+            double& sampled = m_occupancy[entry.first];
+            if (LoadWeight(occupancy) != LoadWeight(sampled)) m_changed.insert(entry.first);
+            sampled = occupancy;
+        }
+
+        Simulator::Schedule(Seconds(m_interval), &LinkLoadMonitor::Sample, this);
+    }
+};
+
+/**
+ * Simulator-side forwarding table of one node, indexed by destination node
+ */
+class ForwardingTable {
+private:
+    int m_nodeId;
+    std::vector<NextHopSet> m_routes;
+    std::vector<std::vector<int>> m_users;      // Per neighbor, destinations whose set holds it
+    bool m_usersValid;                          // Rebuilt on the first reweight after a route change
+    const ForwardingTable* m_base;              // Delta table: untouched destinations are the base's
+    std::vector<uint8_t> m_copied;              // Delta table: destination copied from the base
+    std::vector<int> m_touched;                 // Delta table: destinations written, in order
+
+    void IndexUsers() {
+        for (std::vector<int>& destinations : m_users) destinations.clear();
+        for (size_t d = 0; d < m_routes.size(); d++) {
+            for (uint8_t i = 0; i < m_routes[d].count; i++) {
+                int neighbor = m_routes[d].nextHops[i];
+                if ((size_t)neighbor >= m_users.size()) m_users.resize(neighbor + 1);
+                m_users[neighbor].push_back((int)d);
+            }
+        }
+        m_usersValid = true;
+    }
+
+    /**
+     * Set of a destination about to be written (a delta table copies it from its base first)
+     */
+    NextHopSet& Writable(int destination) {
+        if ((size_t)destination >= m_routes.size()) m_routes.resize(destination + 1);
+        m_usersValid = false;
+        if (m_base) {
+            if ((size_t)destination >= m_copied.size()) m_copied.resize(destination + 1, 0);
+            if (!m_copied[destination]) {
+                const NextHopSet* base = m_base->GetRoute(destination);
+                m_routes[destination] = base ? *base : NextHopSet();
+                m_copied[destination] = 1;
+                m_touched.push_back(destination);
+            }
+        }
+        return m_routes[destination];
+    }
+
+public:
+    ForwardingTable(int nodeId = -1) : m_nodeId(nodeId), m_usersValid(false), m_base(nullptr) {}
+
+    /**
+     * Makes this a delta over base: only the destinations written since the last
+     * ClearDelta are held, each copied from the base on its first write
+     */
+    void SetBase(const ForwardingTable* base) {
+        m_base = base;
+    }
+
+    const std::vector<int>& GetTouched() const { return m_touched; }
+
+    void ClearDelta() {
+        for (int destination : m_touched) m_copied[destination] = 0;
+        m_touched.clear();
+    }
+
+    void SetRoute(int destination, const NextHopSet& nextHops) {
+        if (destination < 0) return;
+        Writable(destination) = nextHops;
+    }
+
+    void AddNextHop(int destination, int nextHop, uint32_t metric) {
+        if (destination < 0) return;
+
+        NextHopSet& set = Writable(destination);
+        if (set.count > 0 && metric < set.metric) {
+            set = NextHopSet();    // strictly better path replaces the equal-cost set
+        }
+        if (set.count == 0 || metric == set.metric) {
+            set.metric = metric;
+            set.Add(nextHop);
+        }
+    }
+
+    void RemoveNextHop(int destination, int nextHop) {
+        if (destination < 0 || (!m_base && (size_t)destination >= m_routes.size())) return;
+        Writable(destination).Remove(nextHop);
+    }
+
+    /**
+     * Forwarding decision: per-flow hashing over the next-hop set
+     */
+    int Lookup(int destination, uint32_t flowHash) const {
+        if (destination < 0 || (size_t)destination >= m_routes.size()) return -1;
+        return m_routes[destination].Select(flowHash);
+    }
+
+    const NextHopSet* GetRoute(int destination) const {
+        if (destination < 0 || (size_t)destination >= m_routes.size()) return nullptr;
+        return &m_routes[destination];
+    }
+
+    /**
+     * Load-aware weighting of every next-hop set (see LoadWeight)
+     */
+    void ApplyLoad(const LinkLoadMonitor& monitor) {
+        for (NextHopSet& set : m_routes) {
+            for (uint8_t i = 0; i < set.count; i++) {
+                set.SetWeight(i, LoadWeight(monitor.GetOccupancy(m_nodeId, set.nextHops[i])));
+            }
+        }
+    }
+
+    /**
+     * Reweights only the sets holding this neighbor
+     */
+    void ApplyLoad(const LinkLoadMonitor& monitor, int neighbor) {
+        if (!m_usersValid) IndexUsers();
+        if (neighbor < 0 || (size_t)neighbor >= m_users.size()) return;
+
+        uint16_t weight = LoadWeight(monitor.GetOccupancy(m_nodeId, neighbor));
+        for (int destination : m_users[neighbor]) {
+            NextHopSet& set = m_routes[destination];
+            for (uint8_t i = 0; i < set.count; i++) {
+                if (set.nextHops[i] == neighbor) set.SetWeight(i, weight);
+            }
+        }
+    }
+
+    size_t GetRouteCount() const {
+        size_t routes = 0;
+        for (const NextHopSet& set : m_routes) {
+            if (set.count > 0) routes++;
+        }
+        return routes;
+    }
+};
+
+/**
+ * Active and shadow forwarding tables of one node (BFU double buffering)
+ * Routes computed during BFU are written into the shadow, a delta over the active table:
+ * only the destinations written are held, each copied from the active table on its first
+ * write. Lookups keep using the active table until Swap writes the staged destinations
+ * into it, in O(staged destinations). Nodes without staged routes keep their active table.
+ */
+class DoubleBufferedTable {
+private:
+    ForwardingTable m_active;
+    ForwardingTable m_shadow;       // Staged destinations only
+
+public:
+    DoubleBufferedTable(int nodeId = -1) : m_active(nodeId), m_shadow(nodeId) {
+        m_shadow.SetBase(&m_active);
+    }
+
+    // The shadow points at the active table of its own instance
+    DoubleBufferedTable(const DoubleBufferedTable& other) : m_active(other.m_active), m_shadow(other.m_shadow) {
+        m_shadow.SetBase(&m_active);
+    }
+
+    DoubleBufferedTable& operator=(const DoubleBufferedTable& other) {
+        m_active = other.m_active;
+        m_shadow = other.m_shadow;
+        m_shadow.SetBase(&m_active);
+        return *this;
+    }
+
+    ForwardingTable& Active() { return m_active; }
+    const ForwardingTable& Active() const { return m_active; }
+
+    ForwardingTable& Shadow() { return m_shadow; }
+
+    bool IsStaged() const { return !m_shadow.GetTouched().empty(); }
+
+    /**
+     * The staged destinations replace the active ones; returns false when nothing was staged
+     */
+    bool Swap() {
+        if (!IsStaged()) return false;
+        for (int destination : m_shadow.GetTouched()) {
+            m_active.SetRoute(destination, *m_shadow.GetRoute(destination));
+        }
+        m_shadow.ClearDelta();
+        return true;
+    }
+};
+
+#endif // FORWARDING_TABLE_H
@@ -0,0 +1,346 @@
+#ifndef GSL_MANAGEMENT_H
+#define GSL_MANAGEMENT_H
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <functional>
+#include <algorithm>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "../core/constellation-params.h"
+#include "../core/rfp-timing.h"
+#include "../helpers/satellite-helper.h"
+#include "../helpers/async-logger.h"
+
+using namespace ns3;
+
+const uint32_t GSL_STATION_ADDRESS_BASE = 0xC0A80000;     // 192.168.0.0: station i is 192.168.0.<i + 1>/32
+
+enum GslSelectionPolicy {
+    GSL_MAX_ELEVATION,        // Highest satellite above the station
+    GSL_LONGEST_CONTACT       // Satellite that stays visible the longest
+};
+
+/**
+ * Ground-to-Satellite Link (GSL) management
+ * Picks the serving satellite of every ground station from the orbit model and
+ * turns each predicted loss of visibility into a predictable link-down event
+ */
+class GroundStationLinkManager {
+public:
+    typedef std::function<void(int linkId, int nodeA, int nodeB, double eventTime)> PredictedLinkDownCallback;
+
+private:
+    struct Station {
+        Ptr<Node> node;
+        double latDeg;
+        double lonDeg;
+        Vector position;          // km, Earth-centered
+        int servingSat;
+        double contactEnd;
+        bool addressed;           // Stable address on the loopback
+
+        Station() : latDeg(0), lonDeg(0), servingSat(-1), contactEnd(0), addressed(false) {}
+    };
+
+    SatelliteHelper* m_satHelper;
+    NodeContainer m_satellites;
+    std::vector<Station> m_stations;
+    std::map<std::pair<uint32_t, int>, NetDeviceContainer> m_links;   // (station, satellite) -> GSL devices
+    double m_minElevationDeg;
+    GslSelectionPolicy m_policy;
+    PredictedLinkDownCallback m_predictedLinkDown;
+
+    PointToPointHelper m_p2p;
+    Ipv4AddressHelper m_ipv4;
+    int m_nextLinkId;
+
+    uint32_t m_handovers;
+    uint64_t m_candidatesChecked;
+    std::vector<uint32_t> m_candidates;
+
+public:
+    GroundStationLinkManager(SatelliteHelper* satHelper, NodeContainer satellites,
+                             double minElevationDeg = 10.0, GslSelectionPolicy policy = GSL_MAX_ELEVATION)
+        : m_satHelper(satHelper), m_satellites(satellites), m_minElevationDeg(minElevationDeg),
+          m_policy(policy), m_nextLinkId(1000), m_handovers(0), m_candidatesChecked(0) {
+        m_p2p.SetDeviceAttribute("DataRate", StringValue(P2P_RATE));
+        m_p2p.SetChannelAttribute("Delay", StringValue(GROUND_TO_SAT_DELAY));
+        // Ground stations live in 192.168.0.0/16: GSL subnets from 192.168.1.0/30, stable addresses in 192.168.0.0/24
+        m_ipv4.SetBase("192.168.1.0", "255.255.255.252");
+    }
+
+    void SetPredictedLinkDownCallback(PredictedLinkDownCallback callback) {
+        m_predictedLinkDown = callback;
+    }
+
+    void AddGroundStation(Ptr<Node> node, double latDeg, double lonDeg) {
+        Station station;
+        station.node = node;
+        station.latDeg = latDeg;
+        station.lonDeg = lonDeg;
+
+        double lat = latDeg * PI / 180.0;
+        double lon = lonDeg * PI / 180.0;
+        station.position = Vector(EARTH_RADIUS * cos(lat) * cos(lon),
+                                  EARTH_RADIUS * cos(lat) * sin(lon),
+                                  EARTH_RADIUS * sin(lat));
+        m_stations.push_back(station);
+    }
+
+    /**
+     * Attaches every station to its first serving satellite
+     */
+    void Start(double startTime) {
+        for (uint32_t i = 0; i < m_stations.size(); i++) {
+            Simulator::Schedule(Seconds(startTime), &GroundStationLinkManager::Handover, this, i);
+        }
+    }
+
+    /**
+     * Satellites that will serve any station between from and until: highest satellite
+     * at each handover instant, then its predicted contact end (full scan, no spatial
+     * index, so usable before the simulation runs). Sorted, without duplicates.
+     */
+    std::vector<uint32_t> PredictServingSatellites(double from, double until) {
+        uint32_t numSats = m_satellites.GetN();
+        double lead = GetRfpTiming().Lead();
+        std::vector<uint32_t> serving;
+
+        for (const Station& station : m_stations) {
+            double t = from;
+            while (t <= until) {
+                int best = -1;
+                double bestElevation = m_minElevationDeg;
+                for (uint32_t sat = 0; sat < numSats; sat++) {
+                    double elevation = ElevationDeg(station, m_satHelper->GetRealPosition(sat, numSats, t));
+                    if (elevation >= bestElevation) {
+                        bestElevation = elevation;
+                        best = sat;
+                    }
+                }
+                if (best < 0) {
+                    t += LINK_UPDATE_INTERVAL;
+                    continue;
+                }
+                serving.push_back(best);
+                t = std::max(t + LINK_UPDATE_INTERVAL, PredictContactEnd(station, best, t) - lead);
+            }
+        }
+
+        std::sort(serving.begin(), serving.end());
+        serving.erase(std::unique(serving.begin(), serving.end()), serving.end());
+        return serving;
+    }
+
+    /**
+     * Stable address of a station: GSL addresses belong to one (station, satellite) pair
+     * and go down at each handover, this one stays on the station's loopback
+     */
+    Ipv4Address GetStationAddress(uint32_t stationIndex) const {
+        return Ipv4Address(GSL_STATION_ADDRESS_BASE + stationIndex + 1);
+    }
+
+    /**
+     * Node id of the satellite serving a ground station node, -1 for any other node
+     */
+    int GetServingNode(uint32_t node) const {
+        for (const Station& station : m_stations) {
+            if (station.node->GetId() == node) {
+                return station.servingSat >= 0 ? (int)m_satellites.Get(station.servingSat)->GetId() : -1;
+            }
+        }
+        return -1;
+    }
+
+    uint32_t GetHandoverCount() const { return m_handovers; }
+    uint64_t GetCandidatesChecked() const { return m_candidatesChecked; }
+
+    void PrintStatistics() const {
+        std::cout << "GSL statistics:" << std::endl;
+        std::cout << "   Ground stations: " << m_stations.size() << std::endl;
+        std::cout << "   Handovers: " << m_handovers << std::endl;
+        std::cout << "   GSLs created: " << m_links.size() << std::endl;
+        std::cout << "   Candidates checked: " << m_candidatesChecked << std::endl;
+    }
+
+private:
+    double ElevationDeg(const Station& station, const Vector& satPos) const {
+        Vector d(satPos.x - station.position.x, satPos.y - station.position.y, satPos.z - station.position.z);
+        double range = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+        if (range <= 0) return 90.0;
+
+        double up = (d.x * station.position.x + d.y * station.position.y + d.z * station.position.z) / EARTH_RADIUS;
+        return std::asin(up / range) * 180.0 / PI;
+    }
+
+    /**
+     * Central angle around a station inside which a satellite is above the elevation mask
+     */
+    double CoverageRadiusDeg() const {
+        double mask = m_minElevationDeg * PI / 180.0;
+        double lambda = std::acos(EARTH_RADIUS / (EARTH_RADIUS + GetConstellation().GetMaxAltitude()) * cos(mask)) - mask;
+        return lambda * 180.0 / PI;
+    }
+
+    /**
+     * Time at which the satellite drops below the elevation mask (coarse scan + bisection)
+     */
+    double PredictContactEnd(const Station& station, int sat, double time) {
+        uint32_t numSats = m_satellites.GetN();
+        double orbitTime = GetConstellation().GetOrbitTime(sat);
+        double step = orbitTime / 720.0;
+
+        double visible = time;
+        double t = time + step;
+        while (t < time + orbitTime) {
+            if (ElevationDeg(station, m_satHelper->GetRealPosition(sat, numSats, t)) < m_minElevationDeg) {
+                break;
+            }
+            visible = t;
+            t += step;
+        }
+        if (t >= time + orbitTime) return t;     // never sets within one orbit
+
+        double lo = visible, hi = t;
+        for (int i = 0; i < 20; i++) {
+            double mid = 0.5 * (lo + hi);
+            if (ElevationDeg(station, m_satHelper->GetRealPosition(sat, numSats, mid)) >= m_minElevationDeg) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    int SelectSatellite(const Station& station, double time, int excluded, double& contactEnd) {
+        const std::vector<SatelliteHelper::SatellitePosition>& positions = m_satHelper->m_currentPositions;
+        m_satHelper->GetSpatialIndex().Query(station.latDeg, station.lonDeg, CoverageRadiusDeg(), m_candidates);
+
+        int best = -1;
+        double bestScore = -1e9;
+        for (uint32_t sat : m_candidates) {
+            if ((int)sat == excluded || sat >= positions.size()) continue;
+            m_candidatesChecked++;
+
+            double elevation = ElevationDeg(station, positions[sat].realPos);
+            if (elevation < m_minElevationDeg) continue;
+
+            double score = elevation;
+            double end = 0.0;
+            if (m_policy == GSL_LONGEST_CONTACT) {
+                end = PredictContactEnd(station, sat, time);
+                score = end;
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                best = sat;
+                contactEnd = end;
+            }
+        }
+
+        if (best >= 0 && m_policy == GSL_MAX_ELEVATION) {
+            contactEnd = PredictContactEnd(station, best, time);
+        }
+        return best;
+    }
+
+    void SetLinkUp(uint32_t stationIndex, int sat, bool isUp) {
+        auto it = m_links.find(std::make_pair(stationIndex, sat));
+        if (it == m_links.end()) return;
+
+        for (uint32_t i = 0; i < it->second.GetN(); i++) {
+            Ptr<NetDevice> device = it->second.Get(i);
+            Ptr<Ipv4> ipv4 = device->GetNode()->GetObject<Ipv4>();
+            if (!ipv4) continue;
+
+            int32_t interface = ipv4->GetInterfaceForDevice(device);
+            if (interface < 0) continue;
+            if (isUp) {
+                ipv4->SetUp(interface);
+            } else {
+                ipv4->SetDown(interface);
+            }
+        }
+    }
+
+    void AssignStationAddress(uint32_t stationIndex) {
+        Station& station = m_stations[stationIndex];
+        if (station.addressed) return;
+        Ptr<Ipv4> ipv4 = station.node->GetObject<Ipv4>();
+        if (!ipv4) return;
+        // Interface 0 is the loopback of the ns-3 IPv4 stack
+        ipv4->AddAddress(0, Ipv4InterfaceAddress(GetStationAddress(stationIndex), Ipv4Mask("255.255.255.255")));
+        station.addressed = true;
+    }
+
+    void Attach(uint32_t stationIndex, int sat) {
+        AssignStationAddress(stationIndex);
+        std::pair<uint32_t, int> key(stationIndex, sat);
+        if (m_links.find(key) == m_links.end()) {
+            NetDeviceContainer devices = m_p2p.Install(m_stations[stationIndex].node, m_satellites.Get(sat));
+            m_ipv4.Assign(devices);
+            m_ipv4.NewNetwork();
+            m_links[key] = devices;
+        } else {
+            SetLinkUp(stationIndex, sat, true);
+        }
+    }
+
+    void Detach(uint32_t stationIndex, int sat) {
+        if (m_stations[stationIndex].servingSat == sat) return;    // re-attached meanwhile
+        SetLinkUp(stationIndex, sat, false);
+    }
+
+    /**
+     * Make-before-break: the next satellite is attached before the serving one sets
+     */
+    void Handover(uint32_t stationIndex) {
+        try {
+            Station& station = m_stations[stationIndex];
+            double now = Simulator::Now().GetSeconds();
+            double lead = GetRfpTiming().Lead();
+
+            double contactEnd = 0.0;
+            int next = SelectSatellite(station, now, station.servingSat, contactEnd);
+            if (next < 0) {
+                // Coverage gap: retry at the next position update
+                Simulator::Schedule(Seconds(LINK_UPDATE_INTERVAL), &GroundStationLinkManager::Handover, this, stationIndex);
+                return;
+            }
+
+            int previous = station.servingSat;
+            Attach(stationIndex, next);
+            if (previous >= 0) {
+                double release = std::max(now, station.contactEnd);
+                Simulator::Schedule(Seconds(release - now), &GroundStationLinkManager::Detach, this, stationIndex, previous);
+                m_handovers++;
+            }
+
+            station.servingSat = next;
+            station.contactEnd = contactEnd;
+
+            int gsNode = station.node->GetId();
+            int satNode = m_satellites.Get(next)->GetId();
+            SATLOG_INFO(SATLOG_TMM, "GSL: GS-{} served by SAT-{} until t={}s", stationIndex, next, contactEnd);
+
+            // Feed the predicted loss of this GSL to RFP (only when it is known early enough)
+            if (m_predictedLinkDown && contactEnd - lead > now) {
+                m_predictedLinkDown(m_nextLinkId++, gsNode, satNode, contactEnd);
+            }
+
+            double handoverTime = std::max(now + LINK_UPDATE_INTERVAL, contactEnd - lead);
+            Simulator::Schedule(Seconds(handoverTime - now), &GroundStationLinkManager::Handover, this, stationIndex);
+
+        } catch (const std::exception& e) {
+            SATLOG_ERROR(SATLOG_TMM, "Error GSL handover: {}", e.what());
+        }
+    }
+};
+
+#endif // GSL_MANAGEMENT_H
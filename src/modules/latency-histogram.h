@@ -0,0 +1,166 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+const uint32_t HISTOGRAM_SUB_BUCKET_BITS = 8;      // 256 sub-buckets: < 0.8% relative error
+const uint32_t HISTOGRAM_BUCKETS = 33;             // values up to 2^40 us (~12 days)
+const uint32_t HISTOGRAM_HALF_COUNT = 1u << (HISTOGRAM_SUB_BUCKET_BITS - 1);
+const uint32_t HISTOGRAM_COUNTS_LEN = (HISTOGRAM_BUCKETS + 1) * HISTOGRAM_HALF_COUNT;
+
+/**
+ * Log-linear latency histogram (HDR style), microsecond resolution
+ * Fixed memory, Record() is O(1) without allocation so it can sit on the per-packet path.
+ * Values are recorded and reported in milliseconds.
+ */
+class LatencyHistogram {
+private:
+    uint64_t m_counts[HISTOGRAM_COUNTS_LEN];
+    uint64_t m_totalCount;
+    uint64_t m_minValue;
+    uint64_t m_maxValue;
+    double m_sum;
+
+    static uint32_t CountsIndex(uint64_t value) {
+        const uint64_t subBucketMask = (1ULL << HISTOGRAM_SUB_BUCKET_BITS) - 1;
+        uint32_t bucket = 63 - __builtin_clzll(value | subBucketMask) - (HISTOGRAM_SUB_BUCKET_BITS - 1);
+        uint32_t subBucket = (uint32_t)(value >> bucket);
+        return (bucket << (HISTOGRAM_SUB_BUCKET_BITS - 1)) + subBucket;
+    }
+
+    static uint64_t LowestValueAt(uint32_t index) {
+        int bucket = (int)(index >> (HISTOGRAM_SUB_BUCKET_BITS - 1)) - 1;
+        uint64_t subBucket = (index & (HISTOGRAM_HALF_COUNT - 1)) + HISTOGRAM_HALF_COUNT;
+        if (bucket < 0) {
+            subBucket -= HISTOGRAM_HALF_COUNT;
+            bucket = 0;
+        }
+        return subBucket << bucket;
+    }
+
+    static uint64_t HighestValueAt(uint32_t index) {
+        int bucket = std::max((int)(index >> (HISTOGRAM_SUB_BUCKET_BITS - 1)) - 1, 0);
+        return LowestValueAt(index) + (1ULL << bucket) - 1;
+    }
+
+    static uint64_t MaxTrackable() {
+        return HighestValueAt(HISTOGRAM_COUNTS_LEN - 1);
+    }
+
+public:
+    LatencyHistogram() {
+        Reset();
+    }
+
+    void Reset() {
+        std::fill(m_counts, m_counts + HISTOGRAM_COUNTS_LEN, 0);
+        m_totalCount = 0;
+        m_minValue = UINT64_MAX;
+        m_maxValue = 0;
+        m_sum = 0.0;
+    }
+
+    void RecordValue(uint64_t valueUs, uint64_t count = 1) {
+        valueUs = std::min(valueUs, MaxTrackable());
+        m_counts[CountsIndex(valueUs)] += count;
+        m_totalCount += count;
+        m_minValue = std::min(m_minValue, valueUs);
+        m_maxValue = std::max(m_maxValue, valueUs);
+        m_sum += (double)valueUs * count;
+    }
+
+    void Record(double valueMs) {
+        RecordValue(valueMs > 0 ? (uint64_t)(valueMs * 1000.0 + 0.5) : 0);
+    }
+
+    /**
+     * Adds the samples of another histogram (e.g. another run)
+     */
+    void Merge(const LatencyHistogram& other) {
+        for (uint32_t i = 0; i < HISTOGRAM_COUNTS_LEN; i++) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_totalCount += other.m_totalCount;
+        m_minValue = std::min(m_minValue, other.m_minValue);
+        m_maxValue = std::max(m_maxValue, other.m_maxValue);
+        m_sum += other.m_sum;
+    }
+
+    uint64_t GetTotalCount() const { return m_totalCount; }
+    double GetMin() const { return m_totalCount ? m_minValue / 1000.0 : 0.0; }
+    double GetMax() const { return m_maxValue / 1000.0; }
+    double GetMean() const { return m_totalCount ? m_sum / m_totalCount / 1000.0 : 0.0; }
+
+    /**
+     * Value (ms) below which the given percentage of samples fall
+     */
+    double GetPercentile(double percentile) const {
+        if (m_totalCount == 0) return 0.0;
+
+        percentile = std::min(std::max(percentile, 0.0), 100.0);
+        uint64_t target = std::max<uint64_t>((uint64_t)(percentile / 100.0 * m_totalCount + 0.5), 1);
+
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < HISTOGRAM_COUNTS_LEN; i++) {
+            seen += m_counts[i];
+            if (seen >= target) {
+                return std::min(HighestValueAt(i), m_maxValue) / 1000.0;
+            }
+        }
+        return GetMax();
+    }
+
+    void PrintSummary(const std::string& name) const {
+        std::cout << "   " << name << " (n=" << m_totalCount << "): p50=" << GetPercentile(50.0)
+                  << " p90=" << GetPercentile(90.0) << " p99=" << GetPercentile(99.0)
+                  << " p99.9=" << GetPercentile(99.9) << " max=" << GetMax() << " ms" << std::endl;
+    }
+
+    /**
+     * Text export: "name min_us max_us sum_us total" then one "index count" line per non-empty bucket
+     */
+    void Export(std::ostream& out, const std::string& name) const {
+        out << "histogram " << name << " " << (m_totalCount ? m_minValue : 0) << " " << m_maxValue
+            << " " << (uint64_t)m_sum << " " << m_totalCount << std::endl;
+        for (uint32_t i = 0; i < HISTOGRAM_COUNTS_LEN; i++) {
+            if (m_counts[i] > 0) {
+                out << i << " " << m_counts[i] << std::endl;
+            }
+        }
+        out << "end" << std::endl;
+    }
+
+    /**
+     * Reads back one exported histogram, merges it into this one and returns its name
+     */
+    bool Import(std::istream& in, std::string& name) {
+        std::string tag;
+        uint64_t minValue = 0, maxValue = 0, sum = 0, total = 0;
+        if (!(in >> tag >> name >> minValue >> maxValue >> sum >> total) || tag != "histogram") {
+            return false;
+        }
+
+        std::string token;
+        while (in >> token && token != "end") {
+            uint32_t index = (uint32_t)std::stoul(token);
+            uint64_t count = 0;
+            in >> count;
+            if (index < HISTOGRAM_COUNTS_LEN) {
+                m_counts[index] += count;
+            }
+        }
+
+        if (total > 0) {
+            m_minValue = std::min(m_minValue, minValue);
+            m_maxValue = std::max(m_maxValue, maxValue);
+        }
+        m_totalCount += total;
+        m_sum += (double)sum;
+        return true;
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_H
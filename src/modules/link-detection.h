@@ -7,10 +7,22 @@
 #include <algorithm>
 #include "ns3/core-module.h"
 #include "topology-mgmt.h"
+#include "forwarding-table.h"
 #include "../helpers/quagga-integration.h"
 
 using namespace ns3;
 
+/**
+ * Receives the link states LDM reports to OSPF (e.g. the in-simulator OSPF model)
+ * administrative: interface shut down / brought back by RFP rather than a detected change
+ */
+class LinkStateObserver {
+public:
+    virtual ~LinkStateObserver() {}
+    
+    virtual void OnReportedLinkState(int nodeA, int nodeB, bool isUp, bool administrative, double currentTime) = 0;
+};
+
 /**
  * Link Detection Module (LDM) - ROBUST ERROR HANDLING
  * Manages link state detection and BLD (Blind Link Detection) periods
@@ -20,12 +32,19 @@ private:
     std::map<std::pair<int, int>, bool> m_realLinkStates;      // Real link states
     std::map<std::pair<int, int>, bool> m_reportedLinkStates;  // Link states reported to OSPF
     std::set<std::pair<int, int>> m_forcedDownLinks;           // Links forced DOWN by RFP
+    LinkStateObserver* m_observer;                             // Optional OSPF model fed with the reported states
     
     std::pair<int, int> MakeOrderedPair(int nodeA, int nodeB) {
         return std::make_pair(std::min(nodeA, nodeB), std::max(nodeA, nodeB));
     }
     
 public:
+    LinkDetectionModule() : m_observer(nullptr) {}
+    
+    void SetObserver(LinkStateObserver* observer) {
+        m_observer = observer;
+    }
+    
     /**
      * Forces a link DOWN in OSPF for RFP (T1) - WITH ERROR HANDLING
      */
@@ -34,19 +53,23 @@ public:
         m_forcedDownLinks.insert(link);
         m_reportedLinkStates[link] = false;
         
-        std::cout << "LDM: Forcing link " << nodeA << "<->" << nodeB 
-                  << " DOWN in OSPF at t=" << currentTime << "s" << std::endl;
-        std::cout << "   → OSPF will recalculate routes to avoid this link" << std::endl;
+        SATLOG_INFO(SATLOG_LDM, "LDM: Forcing link {}<->{} DOWN in OSPF at t={}s", nodeA, nodeB, currentTime);
+        SATLOG_INFO(SATLOG_LDM, "   → OSPF will recalculate routes to avoid this link");
         
         try {
             // REAL modification in Quagga
             SetQuaggaLinkStateReal(nodeA, nodeB, false);
             
-            AddAlternativeRoutes(nodeA, nodeB);
+            if (m_observer) {
+                // The model recomputes the alternates itself
+                m_observer->OnReportedLinkState(nodeA, nodeB, false, true, currentTime);
+            } else {
+                AddAlternativeRoutes(nodeA, nodeB);
+            }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error forcing link down: " << e.what() << std::endl;
-            std::cerr << "🔧 Link down appliqué en mode simulation" << std::endl;
+            SATLOG_ERROR(SATLOG_LDM, "Error forcing link down: {}", e.what());
+            SATLOG_WARN(SATLOG_LDM, "🔧 Link down appliqué en mode simulation");
         }
     }
     
@@ -63,14 +86,17 @@ public:
         try {
             // REAL modification in Quagga
             SetQuaggaLinkStateReal(nodeA, nodeB, realState);
+            if (m_observer) {
+                m_observer->OnReportedLinkState(nodeA, nodeB, realState, true, currentTime);
+            }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error restoring detection: " << e.what() << std::endl;
-            std::cerr << "🔧 Restore detection appliqué en mode simulation" << std::endl;
+            SATLOG_ERROR(SATLOG_LDM, "Error restoring detection: {}", e.what());
+            SATLOG_WARN(SATLOG_LDM, "🔧 Restore detection appliqué en mode simulation");
         }
         
-        std::cout << "LDM: Restored normal detection for link " << nodeA << "<->" << nodeB 
-                  << " at t=" << currentTime << "s (real state: " << (realState ? "UP" : "DOWN") << ")" << std::endl;
+        SATLOG_INFO(SATLOG_LDM, "LDM: Restored normal detection for link {}<->{} at t={}s (real state: {})",
+                    nodeA, nodeB, currentTime, realState ? "UP" : "DOWN");
     }
     
     void UpdateRealLinkState(int nodeA, int nodeB, bool isUp, double currentTime,
@@ -80,15 +106,15 @@ public:
         m_realLinkStates[link] = isUp;
         
         if (m_forcedDownLinks.find(link) != m_forcedDownLinks.end()) {
-            // std::cout << "LDM: Link " << nodeA << "<->" << nodeB << " state change IGNORED"
-            //           << " (real=" << (isUp ? "UP" : "DOWN") << ", forced DOWN by RFP)" << std::endl;
+            SATLOG_LOGIC(SATLOG_LDM, "LDM: Link {}<->{} state change IGNORED (real={}, forced DOWN by RFP)",
+                         nodeA, nodeB, isUp ? "UP" : "DOWN");
             return;
         }
         
         // If in BLD period for this link, do not report change
         if (tmm && tmm->IsInBldPeriod(nodeA, nodeB, currentTime)) {
-            // std::cout << "LDM: Link " << nodeA << "<->" << nodeB << " state change BLOCKED"
-            //           << " (real=" << (isUp ? "UP" : "DOWN") << ", BLD period active)" << std::endl;
+            SATLOG_LOGIC(SATLOG_LDM, "LDM: Link {}<->{} state change BLOCKED (real={}, BLD period active)",
+                         nodeA, nodeB, isUp ? "UP" : "DOWN");
             return;
         }
         
@@ -96,13 +122,16 @@ public:
             try {
                 m_reportedLinkStates[link] = isUp;
                 SetQuaggaLinkStateReal(nodeA, nodeB, isUp);
+                if (m_observer) {
+                    m_observer->OnReportedLinkState(nodeA, nodeB, isUp, false, currentTime);
+                }
                 
-                std::cout << "LDM: Link " << nodeA << "<->" << nodeB << " REALLY reported to OSPF as " 
-                          << (isUp ? "UP" : "DOWN") << " at t=" << currentTime << "s" << std::endl;
+                SATLOG_INFO(SATLOG_LDM, "LDM: Link {}<->{} REALLY reported to OSPF as {} at t={}s",
+                            nodeA, nodeB, isUp ? "UP" : "DOWN", currentTime);
                            
             } catch (const std::exception& e) {
-                std::cerr << "Error updating link state: " << e.what() << std::endl;
-                std::cerr << "🔧 Link state update appliqué en mode simulation" << std::endl;
+                SATLOG_ERROR(SATLOG_LDM, "Error updating link state: {}", e.what());
+                SATLOG_WARN(SATLOG_LDM, "🔧 Link state update appliqué en mode simulation");
             }
         }
     }
@@ -121,15 +150,15 @@ public:
     
 private:
     void AddAlternativeRoutes(int nodeA, int nodeB) {
-        std::cout << "Finding alternative routes for disabled link " << nodeA << "<->" << nodeB << std::endl;
+        SATLOG_INFO(SATLOG_LDM, "Finding alternative routes for disabled link {}<->{}", nodeA, nodeB);
         
         try {
             uint32_t maxNodes = std::min(NodeList::GetNNodes(), (uint32_t)10);
             
             for (uint32_t i = 0; i < maxNodes; i++) {
                 if ((int)i != nodeA && (int)i != nodeB) {
-                    std::string prefix = "10." + std::to_string(nodeB) + ".0.0/16";
-                    std::string nexthop = "10.0." + std::to_string(i) + ".1";
+                    std::string prefix = NodePrefix(nodeB);
+                    std::string nexthop = NodeNextHop(i);
                     
                     Ptr<Node> nodeAPtr = NodeList::GetNode(nodeA);
                     if (nodeAPtr) {
@@ -139,8 +168,8 @@ private:
             }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error adding alternative routes: " << e.what() << std::endl;
-            std::cerr << "🔧 Routes alternatives ajoutées en mode simulation" << std::endl;
+            SATLOG_ERROR(SATLOG_LDM, "Error adding alternative routes: {}", e.what());
+            SATLOG_WARN(SATLOG_LDM, "🔧 Routes alternatives ajoutées en mode simulation");
         }
     }
 };
@@ -0,0 +1,517 @@
+#ifndef OSPF_MODEL_H
+#define OSPF_MODEL_H
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <sstream>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "../core/link-key.h"
+#include "../core/instrumentation.h"
+#include "../core/ospf-timers.h"
+#include "link-detection.h"
+#include "forwarding-table.h"
+#include "backup-paths.h"
+
+using namespace ns3;
+
+const int16_t OSPF_MODEL_NO_ROUTE = -1;
+
+/**
+ * In-simulator OSPF model: the behaviour RFP interacts with, without Quagga or DCE
+ *
+ * Receives the link states LDM reports (LinkStateObserver) and produces route updates
+ * in the RMM text format at the time each router would run SPF:
+ * - adjacency: an administrative shutdown (RFP T1) is seen at once, a detected failure
+ *   at the next dead-interval expiry, a link coming up at the next hello plus the
+ *   database exchange (per-link hello phase, deterministic)
+ * - LSA origination paced by lsaInterval per router, then flooded hop by hop
+ *   (floodDelay per hop over the adjacencies up at origination)
+ * - per router SPF: spfDelay after the LSA arrives, at least the current hold after the
+ *   previous run; the hold starts at spfHold and doubles up to spfMaxHold while requests
+ *   arrive within it (Quagga's SPF throttle); one run covers every LSA that arrived before it
+ *
+ * Each router's link-state database is the set of link changes whose LSA has reached
+ * it; changes seen by every router are folded into the shared base state. Routes are
+ * hop-count shortest paths (lowest neighbour id on ties: adjacency lists are kept sorted by
+ * neighbour, so the BFS reaches each level in first-hop order); only next-hop changes are
+ * emitted, the start tables are handed over whole per router. Memory is one int16 next hop per (router, destination).
+ */
+class OspfModel : public LinkStateObserver {
+public:
+    typedef std::function<void(Ptr<Node>, const std::string&, double)> RouteUpdateCallback;
+    typedef std::function<void(int nodeA, int nodeB, bool up)> DetectionCallback;
+    typedef std::function<void(int nodeA, int nodeB, bool up, double convergence)> ConvergenceCallback;
+    typedef std::function<void(uint32_t, uint32_t)> NextHopCallback;
+    typedef std::function<void(uint32_t router, const std::vector<int16_t>& nextHops,
+                               const std::vector<uint16_t>& hops)> RouteTableCallback;
+
+private:
+    struct Link {
+        int nodeA;
+        int nodeB;
+        bool up;                        // Adjacency state last originated
+        bool base;                      // State every router's database agrees on
+        bool target;                    // Reported state, pending detection
+        double helloPhase;
+        EventId detection;
+        std::deque<uint64_t> history;   // Changes not folded into base yet, oldest first
+    };
+
+    struct Change {
+        uint32_t link;
+        bool up;
+        double detectTime;
+        double convergedAt;
+        uint32_t pending;               // Routers whose SPF has not covered it yet
+        std::vector<double> arrival;    // Per router, infinity when unreachable
+        std::vector<bool> covered;      // Per router, an SPF already ran on it
+    };
+
+    OspfTimers m_timers;
+    RouteUpdateCallback m_callback;
+    DetectionCallback m_detectionCallback;
+    ConvergenceCallback m_convergenceCallback;
+    NextHopCallback m_nextHopCallback;
+    RouteTableCallback m_tableCallback;
+
+    uint32_t m_numNodes;
+    std::vector<Link> m_links;
+    FlatLinkMap<uint32_t> m_linkIndex;
+    std::vector<std::vector<uint32_t>> m_adjacency;     // Link indices per router
+
+    std::deque<Change> m_changes;                       // m_changes[i] is change m_firstChange + i
+    uint64_t m_firstChange;
+
+    std::vector<double> m_lastSpf;
+    std::vector<double> m_spfAt;                        // < 0: no SPF pending
+    std::vector<double> m_spfHold;                      // Current throttle hold per router
+    std::vector<double> m_lastOrigination;
+    std::vector<int16_t> m_nextHops;                    // N x N
+    std::vector<bool> m_external;                       // Routers running Quagga: flood, but emit no routes
+
+    // BFS scratch
+    std::vector<uint32_t> m_queue;
+    std::vector<uint16_t> m_hops;
+    std::vector<int16_t> m_firstHop;
+
+    uint64_t m_lsasOriginated;
+    uint64_t m_spfRuns;
+    uint64_t m_routeChanges;
+    uint64_t m_convergedChanges;
+    double m_convergenceSum;
+    double m_maxConvergence;
+    double m_maxFloodTime;
+
+    Change& GetChange(uint64_t id) { return m_changes[id - m_firstChange]; }
+
+    /**
+     * State of a link in the database of a router at time t
+     */
+    bool LinkUpFor(const Link& link, uint32_t node, double t) {
+        bool up = link.base;
+        for (uint64_t id : link.history) {
+            const Change& change = GetChange(id);
+            if (change.arrival[node] <= t) up = change.up;
+        }
+        return up;
+    }
+
+    double NextHello(const Link& link, double t) const {
+        return link.helloPhase + std::ceil((t - link.helloPhase) / m_timers.helloInterval) * m_timers.helloInterval;
+    }
+
+    double LastHello(const Link& link, double t) const {
+        return link.helloPhase + std::floor((t - link.helloPhase) / m_timers.helloInterval) * m_timers.helloInterval;
+    }
+
+    /**
+     * Adjacency change detected: both ends originate a router LSA (paced by lsaInterval),
+     * the first one floods through the adjacencies that are up
+     */
+    void Detect(uint32_t linkIndex) {
+        Link& link = m_links[linkIndex];
+        if (link.up == link.target) return;
+        link.up = link.target;
+
+        double now = Simulator::Now().GetSeconds();
+        double origin = std::numeric_limits<double>::infinity();
+        int ends[2] = {link.nodeA, link.nodeB};
+        for (int end : ends) {
+            double t = std::max(now, m_lastOrigination[end] + m_timers.lsaInterval);
+            m_lastOrigination[end] = t;
+            origin = std::min(origin, t);
+            m_lsasOriginated++;
+        }
+
+        Change change;
+        change.link = linkIndex;
+        change.up = link.up;
+        change.detectTime = now;
+        change.convergedAt = now;
+        change.pending = 0;
+        Flood(link, origin, change.arrival);
+        change.covered.assign(m_numNodes, false);
+
+        uint64_t id = m_firstChange + m_changes.size();
+        link.history.push_back(id);
+        m_changes.push_back(change);
+
+        Change& stored = m_changes.back();
+        for (uint32_t node = 0; node < m_numNodes; node++) {
+            if (std::isinf(stored.arrival[node])) continue;
+            stored.pending++;
+            m_maxFloodTime = std::max(m_maxFloodTime, stored.arrival[node] - origin);
+            ScheduleSpf(node, stored.arrival[node]);
+        }
+        if (stored.pending == 0) Collect();
+
+        SATLOG_LOGIC(SATLOG_RFP, "OSPF model: adjacency {}<->{} {} at t={}s, LSA flooded from t={}s",
+                     link.nodeA, link.nodeB, link.up ? "FULL" : "DOWN", now, origin);
+        if (m_detectionCallback) {
+            m_detectionCallback(link.nodeA, link.nodeB, link.up);
+        }
+    }
+
+    /**
+     * LSA arrival per router: BFS from both ends over the adjacencies currently up
+     */
+    void Flood(const Link& link, double origin, std::vector<double>& arrival) {
+        const double inf = std::numeric_limits<double>::infinity();
+        arrival.assign(m_numNodes, inf);
+        m_queue.clear();
+        arrival[link.nodeA] = origin;
+        arrival[link.nodeB] = origin;
+        m_queue.push_back(link.nodeA);
+        m_queue.push_back(link.nodeB);
+
+        for (size_t head = 0; head < m_queue.size(); head++) {
+            uint32_t node = m_queue[head];
+            for (uint32_t index : m_adjacency[node]) {
+                const Link& hop = m_links[index];
+                if (!hop.up) continue;
+                uint32_t next = (hop.nodeA == (int)node) ? hop.nodeB : hop.nodeA;
+                if (!std::isinf(arrival[next])) continue;
+                arrival[next] = arrival[node] + m_timers.floodDelay;
+                m_queue.push_back(next);
+            }
+        }
+    }
+
+    void ScheduleSpf(uint32_t node, double arrival) {
+        // A pending run covers this LSA, or reschedules itself for it when it runs first
+        if (m_spfAt[node] >= 0) return;
+
+        double& hold = m_spfHold[node];
+        hold = (arrival - m_lastSpf[node] < hold) ? std::min(2 * hold, m_timers.spfMaxHold) : m_timers.spfHold;
+        double at = std::max(arrival + m_timers.spfDelay, m_lastSpf[node] + hold);
+        m_spfAt[node] = at;
+        Simulator::Schedule(Seconds(at - Simulator::Now().GetSeconds()), &OspfModel::RunSpf, this, node);
+    }
+
+    /**
+     * SPF on one router's database, emits the next-hop changes
+     */
+    void RunSpf(uint32_t node) {
+        SATNET_TIMER(TIMER_OSPF_MODEL_SPF);
+        double now = Simulator::Now().GetSeconds();
+        m_spfAt[node] = -1.0;
+        m_lastSpf[node] = now;
+        m_spfRuns++;
+
+        ComputeRoutes(node, now);
+        EmitRouteChanges(node, now);
+
+        // Convergence accounting (an LSA arriving at the instant of an SPF counts once, for
+        // that SPF), and the LSAs still on their way to this router
+        double next = std::numeric_limits<double>::infinity();
+        bool finished = false;
+        for (Change& change : m_changes) {
+            if (change.pending == 0) continue;
+            double arrival = change.arrival[node];
+            if (arrival <= now && !change.covered[node]) {
+                change.covered[node] = true;
+                change.convergedAt = now;
+                if (--change.pending == 0) {
+                    RecordConvergence(change);
+                    finished = true;
+                }
+            } else if (arrival > now) {
+                next = std::min(next, arrival);
+            }
+        }
+        if (finished) Collect();
+        if (!std::isinf(next)) ScheduleSpf(node, next);
+    }
+
+    void ComputeRoutes(uint32_t source, double now) {
+        m_hops.assign(m_numNodes, UNREACHABLE_HOPS);
+        m_firstHop.assign(m_numNodes, OSPF_MODEL_NO_ROUTE);
+        m_queue.clear();
+        m_hops[source] = 0;
+        m_queue.push_back(source);
+
+        for (size_t head = 0; head < m_queue.size(); head++) {
+            uint32_t node = m_queue[head];
+            for (uint32_t index : m_adjacency[node]) {
+                const Link& link = m_links[index];
+                if (!LinkUpFor(link, source, now)) continue;
+                uint32_t next = (link.nodeA == (int)node) ? link.nodeB : link.nodeA;
+                if (m_hops[next] != UNREACHABLE_HOPS) continue;
+                m_hops[next] = m_hops[node] + 1;
+                m_firstHop[next] = (node == source) ? (int16_t)next : m_firstHop[node];
+                m_queue.push_back(next);
+            }
+        }
+    }
+
+    void EmitRouteChanges(uint32_t source, double now) {
+        int16_t* row = &m_nextHops[(size_t)source * m_numNodes];
+        Ptr<Node> node = NodeList::GetNode(source);
+
+        for (uint32_t destination = 0; destination < m_numNodes; destination++) {
+            if (destination == source || row[destination] == m_firstHop[destination]) continue;
+
+            m_routeChanges++;
+            int16_t previous = row[destination];
+            row[destination] = m_firstHop[destination];
+            if (m_callback && node && !IsExternal(source)) {
+                if (previous != OSPF_MODEL_NO_ROUTE) {
+                    std::ostringstream del;
+                    del << "DEL " << NodePrefix(destination) << " " << NodeNextHop(previous);
+                    m_callback(node, del.str(), now);
+                }
+                if (m_firstHop[destination] != OSPF_MODEL_NO_ROUTE) {
+                    std::ostringstream add;
+                    add << "ADD " << NodePrefix(destination) << " " << NodeNextHop(m_firstHop[destination]) << " "
+                        << m_hops[destination];
+                    m_callback(node, add.str(), now);
+                }
+            }
+            if (m_nextHopCallback) {
+                m_nextHopCallback(source, destination);
+            }
+        }
+    }
+
+    /**
+     * Routes of the converged start on the model's routers, one table per router: later
+     * changes only emit differences
+     */
+    void InstallInitialRoutes() {
+        if (!m_tableCallback) return;
+        double now = Simulator::Now().GetSeconds();
+        for (uint32_t source = 0; source < m_numNodes; source++) {
+            if (!NodeList::GetNode(source) || IsExternal(source)) continue;
+
+            ComputeRoutes(source, now);
+            m_tableCallback(source, m_firstHop, m_hops);
+        }
+    }
+
+    /**
+     * Adjacency lists are sorted by neighbour id (the BFS tie-break)
+     */
+    void InsertAdjacency(int node, uint32_t index) {
+        std::vector<uint32_t>& adjacency = m_adjacency[node];
+        int neighbour = (m_links[index].nodeA == node) ? m_links[index].nodeB : m_links[index].nodeA;
+        auto position = std::upper_bound(adjacency.begin(), adjacency.end(), neighbour,
+                                         [this, node](int id, uint32_t other) {
+                                             const Link& link = m_links[other];
+                                             return id < ((link.nodeA == node) ? link.nodeB : link.nodeA);
+                                         });
+        adjacency.insert(position, index);
+    }
+
+    void RecordConvergence(const Change& change) {
+        double convergence = change.convergedAt - change.detectTime;
+        m_convergedChanges++;
+        m_convergenceSum += convergence;
+        m_maxConvergence = std::max(m_maxConvergence, convergence);
+        if (m_convergenceCallback) {
+            const Link& link = m_links[change.link];
+            m_convergenceCallback(link.nodeA, link.nodeB, change.up, convergence);
+        }
+    }
+
+    /**
+     * Folds the changes every router has seen into the link base state
+     */
+    void Collect() {
+        while (!m_changes.empty() && m_changes.front().pending == 0) {
+            Change& change = m_changes.front();
+            Link& link = m_links[change.link];
+            if (!link.history.empty() && link.history.front() == m_firstChange) {
+                link.base = change.up;
+                link.history.pop_front();
+            }
+            m_changes.pop_front();
+            m_firstChange++;
+        }
+    }
+
+public:
+    OspfModel(const OspfTimers& timers = OspfTimers())
+        : m_timers(timers), m_numNodes(0), m_firstChange(0),
+          m_lsasOriginated(0), m_spfRuns(0), m_routeChanges(0), m_convergedChanges(0),
+          m_convergenceSum(0.0), m_maxConvergence(0.0), m_maxFloodTime(0.0) {}
+
+    /**
+     * Route updates in the RMM text format, at the SPF time of the router
+     */
+    void SetRouteUpdateCallback(RouteUpdateCallback callback) {
+        m_callback = callback;
+    }
+
+    /**
+     * Adjacency change of a link as the routers see it (detection, or an administrative shutdown)
+     */
+    void SetDetectionCallback(DetectionCallback callback) {
+        m_detectionCallback = callback;
+    }
+
+    /**
+     * Detection-to-last-SPF time of every change once all routers have run SPF on it
+     */
+    void SetConvergenceCallback(ConvergenceCallback callback) {
+        m_convergenceCallback = callback;
+    }
+
+    /**
+     * Start tables of the model's routers at t=0 (next hop and hop count per destination,
+     * OSPF_MODEL_NO_ROUTE without a route), written straight into the forwarding tables
+     */
+    void SetRouteTableCallback(RouteTableCallback callback) {
+        m_tableCallback = callback;
+    }
+
+    /**
+     * (router, destination) of every next-hop change, external routers included
+     */
+    void SetNextHopCallback(NextHopCallback callback) {
+        m_nextHopCallback = callback;
+    }
+
+    /**
+     * The router runs real Quagga (lazy activation region): the model still floods its
+     * LSAs and tracks its tables, but leaves its routes to Quagga
+     */
+    void SetExternalRouter(uint32_t node) {
+        if (node >= m_external.size()) m_external.resize(node + 1, false);
+        m_external[node] = true;
+    }
+
+    bool IsExternal(uint32_t node) const {
+        return node < m_external.size() && m_external[node];
+    }
+
+    /**
+     * Registers an ISL, up with a full adjacency from the start
+     */
+    void AddLink(int nodeA, int nodeB) {
+        uint64_t key = MakeLinkKey(nodeA, nodeB);
+        if (nodeA < 0 || nodeB < 0 || nodeA == nodeB || m_linkIndex.Find(key)) return;
+
+        uint32_t needed = std::max(nodeA, nodeB) + 1;
+        if (needed > m_numNodes) {
+            m_numNodes = needed;
+            m_adjacency.resize(needed);
+        }
+
+        Link link;
+        link.nodeA = std::min(nodeA, nodeB);
+        link.nodeB = std::max(nodeA, nodeB);
+        link.up = true;
+        link.base = true;
+        link.target = true;
+        link.helloPhase = (MakeLinkKey(nodeA, nodeB) * 0x9E3779B97F4A7C15ULL >> 40) % 1000 / 1000.0 * m_timers.helloInterval;
+
+        uint32_t index = m_links.size();
+        m_links.push_back(link);
+        m_linkIndex.Insert(key, index);
+        InsertAdjacency(link.nodeA, index);
+        InsertAdjacency(link.nodeB, index);
+    }
+
+    /**
+     * Converged state at start: every router already has the routes of the full topology
+     * (the same assumption as Quagga started before the first event). Call after the links.
+     */
+    void Start() {
+        m_lastSpf.assign(m_numNodes, -std::numeric_limits<double>::infinity());
+        m_spfAt.assign(m_numNodes, -1.0);
+        m_spfHold.assign(m_numNodes, m_timers.spfHold);
+        m_lastOrigination.assign(m_numNodes, -std::numeric_limits<double>::infinity());
+        m_nextHops.assign((size_t)m_numNodes * m_numNodes, OSPF_MODEL_NO_ROUTE);
+
+        for (uint32_t node = 0; node < m_numNodes; node++) {
+            ComputeRoutes(node, 0.0);
+            std::copy(m_firstHop.begin(), m_firstHop.end(), m_nextHops.begin() + (size_t)node * m_numNodes);
+        }
+        // At t=0, once the setup has named the routers left to Quagga
+        Simulator::Schedule(Seconds(0), &OspfModel::InstallInitialRoutes, this);
+        std::cout << "OSPF model: " << m_numNodes << " routers ("
+                  << std::count(m_external.begin(), m_external.end(), true) << " on Quagga), "
+                  << m_links.size() << " links, " << m_timers.Describe() << std::endl;
+    }
+
+    void OnReportedLinkState(int nodeA, int nodeB, bool isUp, bool administrative, double currentTime) override {
+        const uint32_t* index = m_linkIndex.Find(MakeLinkKey(nodeA, nodeB));
+        if (!index || m_lastSpf.empty()) return;
+
+        Link& link = m_links[*index];
+        if (link.target == isUp) return;
+        link.target = isUp;
+        Simulator::Cancel(link.detection);
+        if (link.up == isUp) return;        // Flap shorter than the detection delay
+
+        double detect = currentTime;
+        if (isUp) {
+            // Next hello, then the database exchange over the new adjacency
+            detect = NextHello(link, currentTime) + 2 * m_timers.floodDelay;
+        } else if (!administrative) {
+            detect = LastHello(link, currentTime) + m_timers.deadInterval;
+        }
+        link.detection = Simulator::Schedule(Seconds(detect - currentTime), &OspfModel::Detect, this, *index);
+    }
+
+    /**
+     * Next hop of the last SPF of a router (OSPF_MODEL_NO_ROUTE when none)
+     */
+    int GetNextHop(uint32_t node, uint32_t destination) const {
+        if (node >= m_numNodes || destination >= m_numNodes || m_nextHops.empty()) return OSPF_MODEL_NO_ROUTE;
+        return m_nextHops[(size_t)node * m_numNodes + destination];
+    }
+
+    const OspfTimers& GetTimers() const { return m_timers; }
+    uint64_t GetSpfRuns() const { return m_spfRuns; }
+    uint64_t GetRouteChanges() const { return m_routeChanges; }
+    double GetMaxConvergence() const { return m_maxConvergence; }
+    double GetMaxFloodTime() const { return m_maxFloodTime; }
+
+    double GetMeanConvergence() const {
+        return m_convergedChanges ? m_convergenceSum / m_convergedChanges : 0.0;
+    }
+
+    void PrintStatistics() const {
+        std::cout << "OSPF model statistics:" << std::endl;
+        std::cout << "   Routers: " << m_numNodes << ", links: " << m_links.size() << std::endl;
+        std::cout << "   LSAs originated: " << m_lsasOriginated << std::endl;
+        std::cout << "   SPF runs: " << m_spfRuns << std::endl;
+        std::cout << "   Route changes: " << m_routeChanges << std::endl;
+        std::cout << "   Flooding time (max): " << m_maxFloodTime * 1000.0 << " ms" << std::endl;
+        if (m_convergedChanges > 0) {
+            std::cout << "   Convergence (detection to last SPF): mean " << GetMeanConvergence() * 1000.0
+                      << " ms, max " << m_maxConvergence * 1000.0 << " ms over " << m_convergedChanges
+                      << " changes" << std::endl;
+        }
+    }
+};
+
+#endif // OSPF_MODEL_H
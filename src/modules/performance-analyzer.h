@@ -2,14 +2,70 @@
 #define PERFORMANCE_ANALYZER_H
 
 #include <iostream>
-#include <map>
+#include <fstream>
+#include <vector>
 #include <chrono>
 #include "ns3/core-module.h"
 #include "ns3/simulator.h"
 #include "../helpers/quagga-integration.h"
+#include "latency-histogram.h"
+#include "../core/link-key.h"
+#include "flow-tracker.h"
+#include "../helpers/results-writer.h"
+#include "../core/rfp-timing.h"
 
 using namespace ns3;
 
+const uint32_t PACKET_TX_SLOTS = 4096;      // In-flight packets tracked for end-to-end delay
+const size_t COMPLETED_EVENTS_RESERVE = 1024;
+const double LOSS_ATTRIBUTION_GRACE = 1.0;  // s after an event completes during which losses still count
+
+/**
+ * Completed link events, one column per field (appended, never erased)
+ * Events recorded without a link (RecordLinkDownEvent) carry NO_LINK_KEY
+ */
+struct CompletedEventLog {
+    std::vector<uint64_t> linkKey;
+    std::vector<double> linkDownTime;       // ms
+    std::vector<double> routeUpdateTime;    // ms
+    std::vector<double> detectionTime;      // ms
+    std::vector<double> outageTime;         // ms, control plane (route update - link down)
+    std::vector<double> completeTime;       // ms
+    std::vector<double> measuredOutage;     // ms, data plane (probe loss window)
+    std::vector<uint32_t> packetsLost;      // measured on probes
+    std::vector<uint32_t> quaggaMods;
+    std::vector<uint8_t> isRfp;
+    
+    void Reserve(size_t n) {
+        linkKey.reserve(n);
+        linkDownTime.reserve(n);
+        routeUpdateTime.reserve(n);
+        detectionTime.reserve(n);
+        outageTime.reserve(n);
+        completeTime.reserve(n);
+        measuredOutage.reserve(n);
+        packetsLost.reserve(n);
+        quaggaMods.reserve(n);
+        isRfp.reserve(n);
+    }
+    
+    void Append(uint64_t key, double downTime, double updateTime, double detection, double outage,
+                double endTime, uint32_t mods, bool rfp) {
+        linkKey.push_back(key);
+        linkDownTime.push_back(downTime);
+        routeUpdateTime.push_back(updateTime);
+        detectionTime.push_back(detection);
+        outageTime.push_back(outage);
+        completeTime.push_back(endTime);
+        measuredOutage.push_back(0.0);
+        packetsLost.push_back(0);
+        quaggaMods.push_back(mods);
+        isRfp.push_back(rfp ? 1 : 0);
+    }
+    
+    size_t Size() const { return linkKey.size(); }
+};
+
 /**
  * Collect and analyze RFP vs standard OSPF performance metrics
  * VERSION 2.0 - REAL MEASUREMENTS
@@ -22,9 +78,13 @@ private:
         uint32_t linkDownEvents;
         double detectionTimeTotal;   
         uint32_t realQuaggaModifications;
+        double measuredOutageTotal;
+        LatencyHistogram outageHistogram;
+        LatencyHistogram detectionHistogram;
+        LatencyHistogram measuredOutageHistogram;
         
         Metrics() : packetsLost(0), routeOutageTotal(0.0), linkDownEvents(0), 
-                   detectionTimeTotal(0.0), realQuaggaModifications(0) {}
+                   detectionTimeTotal(0.0), realQuaggaModifications(0), measuredOutageTotal(0.0) {}
     };
     
     struct LinkEvent {
@@ -32,37 +92,67 @@ private:
         double routeUpdateTime;      
         double detectionTime;        
         bool isRfp;                  
-        uint32_t packetsLostDuringOutage;
+        uint32_t quaggaModsAtStart;  // Quagga modifications issued before the event started
         bool completed;
         
         LinkEvent() : linkDownTime(0), routeUpdateTime(0), detectionTime(0),
-                     isRfp(false), packetsLostDuringOutage(0), completed(false) {}
+                     isRfp(false), quaggaModsAtStart(0), completed(false) {}
     };
     
     Metrics m_standardOspf;
     Metrics m_rfp;
     double m_simulationStartTime;
     
-    std::map<std::string, LinkEvent> m_activeEvents;
+    FlatLinkMap<LinkEvent> m_activeEvents;
+    CompletedEventLog m_completedEvents;
     
     uint64_t m_packetsSentTotal;
     uint64_t m_packetsReceivedTotal;
-    uint64_t m_packetsAtLinkDown;
+    uint32_t m_quaggaMods;                  // Quagga modifications issued so far
+    
+    FlowLossTracker m_probes;
+    bool m_finalized;
+    
+    LatencyHistogram m_packetDelay;
+    LatencyHistogram m_probeDelay;          // Probe flows only, kept out of the application delay
+    LatencyHistogram m_flushDuration;
+    LatencyHistogram m_convergence;         // Measured T1-to-converged time of RFP events
+    uint32_t m_convergenceChecks;           // Events whose convergence was checked at T2
+    uint32_t m_tcInsufficient;
+    std::string m_ospfBaseline;             // OSPF timers the standard OSPF figures were measured with
+    std::vector<uint64_t> m_txUid;          // Send time slots indexed by packet uid
+    std::vector<double> m_txTime;
     
-    std::string MakeLinkKey(int nodeA, int nodeB) {
-        if (nodeA > nodeB) std::swap(nodeA, nodeB);
-        return std::to_string(nodeA) + "-" + std::to_string(nodeB);
+    LatencyHistogram* FindHistogram(const std::string& name) {
+        if (name == "ospf_outage") return &m_standardOspf.outageHistogram;
+        if (name == "ospf_detection") return &m_standardOspf.detectionHistogram;
+        if (name == "rfp_outage") return &m_rfp.outageHistogram;
+        if (name == "rfp_detection") return &m_rfp.detectionHistogram;
+        if (name == "ospf_measured_outage") return &m_standardOspf.measuredOutageHistogram;
+        if (name == "rfp_measured_outage") return &m_rfp.measuredOutageHistogram;
+        if (name == "packet_delay") return &m_packetDelay;
+        if (name == "probe_delay") return &m_probeDelay;
+        if (name == "t2_flush") return &m_flushDuration;
+        if (name == "rfp_convergence") return &m_convergence;
+        return nullptr;
     }
     
 public:
     PerformanceAnalyzer() : m_simulationStartTime(0.0), 
-                            m_packetsSentTotal(0), m_packetsReceivedTotal(0),
-                            m_packetsAtLinkDown(0) {}
+                            m_packetsSentTotal(0), m_packetsReceivedTotal(0), m_quaggaMods(0),
+                            m_finalized(false), m_convergenceChecks(0), m_tcInsufficient(0),
+                            m_txUid(PACKET_TX_SLOTS, UINT64_MAX), m_txTime(PACKET_TX_SLOTS, 0.0) {
+        m_completedEvents.Reserve(COMPLETED_EVENTS_RESERVE);
+    }
     
     void SetSimulationStart(double startTime) {
         m_simulationStartTime = startTime;
     }
     
+    void SetOspfBaseline(const std::string& description) {
+        m_ospfBaseline = description;
+    }
+    
     void OnPacketSent() {
         m_packetsSentTotal++;
     }
@@ -71,14 +161,81 @@ public:
         m_packetsReceivedTotal++;
     }
     
+    /**
+     * Per-packet path: O(1), no allocation
+     */
+    void OnPacketSent(uint64_t packetUid) {
+        m_packetsSentTotal++;
+        uint32_t slot = packetUid % PACKET_TX_SLOTS;
+        m_txUid[slot] = packetUid;
+        m_txTime[slot] = Simulator::Now().GetSeconds();
+    }
+    
+    void OnPacketReceived(uint64_t packetUid) {
+        m_packetsReceivedTotal++;
+        uint32_t slot = packetUid % PACKET_TX_SLOTS;
+        if (m_txUid[slot] == packetUid) {
+            m_packetDelay.Record((Simulator::Now().GetSeconds() - m_txTime[slot]) * 1000.0);
+            m_txUid[slot] = UINT64_MAX;
+        }
+    }
+    
+    /**
+     * Registers a sequence-numbered probe flow, returns its id for the Tx/Rx hooks
+     */
+    uint32_t AddProbeFlow(double interval) {
+        return m_probes.AddFlow(interval);
+    }
+    
+    void OnProbeSent(uint32_t flowId, uint32_t seq) {
+        m_packetsSentTotal++;
+        m_probes.OnTx(flowId, seq, Simulator::Now().GetSeconds());
+    }
+    
+    void OnProbeReceived(uint32_t flowId, uint32_t seq, double txTime) {
+        m_packetsReceivedTotal++;
+        m_probes.OnRx(flowId, seq);
+        m_probeDelay.Record((Simulator::Now().GetSeconds() - txTime) * 1000.0);
+    }
+    
+    const CompletedEventLog& GetCompletedEvents() const {
+        return m_completedEvents;
+    }
+    
+    void RecordFlushDuration(double durationMs) {
+        m_flushDuration.Record(durationMs);
+    }
+    
+    void RecordMeasuredConvergence(double convergenceMs) {
+        m_convergence.Record(convergenceMs);
+    }
+    
+    /**
+     * T2 of a monitored event: converged in time, or Tc was too short
+     */
+    void RecordConvergenceCheck(bool converged) {
+        m_convergenceChecks++;
+        if (!converged) m_tcInsufficient++;
+    }
+    
+    /**
+     * Counts Quagga modifications (vtysh link states and routes) as they are issued; each
+     * event is charged those issued between its start and its completion
+     */
+    void CountQuaggaModifications(uint32_t count) {
+        m_quaggaMods += count;
+    }
+    
+    uint32_t GetQuaggaModifications() const { return m_quaggaMods; }
+    
     void StartLinkDownEvent(int nodeA, int nodeB, bool isRfp) {
-        std::string key = MakeLinkKey(nodeA, nodeB);
+        uint64_t key = MakeLinkKey(nodeA, nodeB);
         double now = Simulator::Now().GetSeconds() * 1000.0;
         
         LinkEvent event;
         event.linkDownTime = now;
         event.isRfp = isRfp;
-        event.packetsLostDuringOutage = 0;
+        event.quaggaModsAtStart = m_quaggaMods;
         event.completed = false;
         
         if (isRfp) {
@@ -86,78 +243,86 @@ public:
             event.detectionTime = 0;     
         }
         
-        m_activeEvents[key] = event;
-        m_packetsAtLinkDown = m_packetsSentTotal;
+        m_activeEvents.Insert(key, event);
         
-        std::cout << "MEASUREMENT: Link-down event started " << key 
+        std::cout << "MEASUREMENT: Link-down event started " << LinkKeyNodeA(key) << "-" << LinkKeyNodeB(key)
                   << " t=" << now << "ms (RFP=" << (isRfp ? "YES" : "NO") << ")" << std::endl;
     }
     
     void RecordOspfDetection(int nodeA, int nodeB) {
-        std::string key = MakeLinkKey(nodeA, nodeB);
         double now = Simulator::Now().GetSeconds() * 1000.0;
         
-        if (m_activeEvents.find(key) != m_activeEvents.end()) {
-            LinkEvent& event = m_activeEvents[key];
-            if (!event.isRfp) {
-                event.detectionTime = now - event.linkDownTime;
-                std::cout << "MEASUREMENT: OSPF detection after " << event.detectionTime << "ms" << std::endl;
+        LinkEvent* event = m_activeEvents.Find(MakeLinkKey(nodeA, nodeB));
+        if (event) {
+            // First endpoint to notice the failure sets the detection time
+            if (!event->isRfp && event->detectionTime == 0) {
+                event->detectionTime = now - event->linkDownTime;
+                std::cout << "MEASUREMENT: OSPF detection after " << event->detectionTime << "ms" << std::endl;
             }
         }
     }
     
     void RecordRouteConvergence(int nodeA, int nodeB) {
-        std::string key = MakeLinkKey(nodeA, nodeB);
         double now = Simulator::Now().GetSeconds() * 1000.0;
         
-        if (m_activeEvents.find(key) != m_activeEvents.end()) {
-            LinkEvent& event = m_activeEvents[key];
-            if (!event.isRfp) {
-                event.routeUpdateTime = now;
+        LinkEvent* event = m_activeEvents.Find(MakeLinkKey(nodeA, nodeB));
+        if (event) {
+            if (!event->isRfp) {
+                event->routeUpdateTime = now;
             }
             
-            // Calculer les paquets perdus pendant l'outage
-            event.packetsLostDuringOutage = m_packetsSentTotal - m_packetsAtLinkDown - 
-                                            (m_packetsReceivedTotal - m_packetsAtLinkDown);
-            
             std::cout << "📏 MESURE: Convergence à t=" << now << "ms" << std::endl;
         }
     }
     
-    void CompleteLinkEvent(int nodeA, int nodeB, uint32_t quaggaMods) {
-        std::string key = MakeLinkKey(nodeA, nodeB);
-        double now = Simulator::Now().GetSeconds() * 1000.0;
+    /**
+     * Unpredicted event: the routes converged around the failure, which closes it
+     */
+    void RecordReconvergence(int nodeA, int nodeB) {
+        LinkEvent* event = m_activeEvents.Find(MakeLinkKey(nodeA, nodeB));
+        if (!event || event->isRfp) return;
+        event->routeUpdateTime = Simulator::Now().GetSeconds() * 1000.0;
+        CompleteLinkEvent(nodeA, nodeB);
+    }
+    
+    void CompleteLinkEvent(int nodeA, int nodeB) {
+        uint64_t key = MakeLinkKey(nodeA, nodeB);
         
-        if (m_activeEvents.find(key) != m_activeEvents.end()) {
-            LinkEvent& event = m_activeEvents[key];
+        LinkEvent* found = m_activeEvents.Find(key);
+        if (found) {
+            LinkEvent& event = *found;
+            double now = Simulator::Now().GetSeconds() * 1000.0;
+            uint32_t quaggaMods = m_quaggaMods - event.quaggaModsAtStart;
             
             double outageTime = event.routeUpdateTime - event.linkDownTime;
             if (outageTime < 0) outageTime = 0; 
             
             if (event.isRfp) {
                 m_rfp.routeOutageTotal += outageTime;
-                m_rfp.packetsLost += event.packetsLostDuringOutage;
                 m_rfp.linkDownEvents++;
                 m_rfp.detectionTimeTotal += event.detectionTime;
                 m_rfp.realQuaggaModifications += quaggaMods;
+                m_rfp.outageHistogram.Record(outageTime);
+                m_rfp.detectionHistogram.Record(event.detectionTime);
                 
                 std::cout << "📊 MESURE RÉELLE RFP: outage=" << outageTime 
-                          << "ms, packets_lost=" << event.packetsLostDuringOutage 
-                          << ", quagga_mods=" << quaggaMods << std::endl;
+                          << "ms, quagga_mods=" << quaggaMods << std::endl;
             } else {
                 m_standardOspf.routeOutageTotal += outageTime;
-                m_standardOspf.packetsLost += event.packetsLostDuringOutage;
                 m_standardOspf.linkDownEvents++;
                 m_standardOspf.detectionTimeTotal += event.detectionTime;
                 m_standardOspf.realQuaggaModifications += quaggaMods;
+                m_standardOspf.outageHistogram.Record(outageTime);
+                m_standardOspf.detectionHistogram.Record(event.detectionTime);
                 
                 std::cout << "📊 MESURE RÉELLE OSPF: outage=" << outageTime 
-                          << "ms, detection=" << event.detectionTime
-                          << "ms, packets_lost=" << event.packetsLostDuringOutage << std::endl;
+                          << "ms, detection=" << event.detectionTime << "ms" << std::endl;
             }
             
             event.completed = true;
-            m_activeEvents.erase(key);
+            m_completedEvents.Append(key, event.linkDownTime, event.routeUpdateTime, event.detectionTime,
+                                     outageTime, now, quaggaMods, event.isRfp);
+            m_activeEvents.Erase(key);
         }
     }
     
@@ -170,14 +335,22 @@ public:
                 m_rfp.linkDownEvents++;
                 m_rfp.detectionTimeTotal += detectionTimeMs;
                 m_rfp.realQuaggaModifications += quaggaMods;
+                m_rfp.outageHistogram.Record(outageTimeMs);
+                m_rfp.detectionHistogram.Record(detectionTimeMs);
             } else {
                 m_standardOspf.routeOutageTotal += outageTimeMs;
                 m_standardOspf.packetsLost += packetsLost;
                 m_standardOspf.linkDownEvents++;
                 m_standardOspf.detectionTimeTotal += detectionTimeMs;
                 m_standardOspf.realQuaggaModifications += quaggaMods;
+                m_standardOspf.outageHistogram.Record(outageTimeMs);
+                m_standardOspf.detectionHistogram.Record(detectionTimeMs);
             }
             
+            double now = Simulator::Now().GetSeconds() * 1000.0;
+            m_completedEvents.Append(NO_LINK_KEY, now, now + outageTimeMs, detectionTimeMs, outageTimeMs,
+                                     now, quaggaMods, useRfp);
+            
             std::cout << "MEASUREMENT: Recorded " << (useRfp ? "RFP" : "Standard OSPF") 
                       << " event: outage=" << outageTimeMs << "ms, packets_lost=" << packetsLost 
                       << ", quagga_mods=" << quaggaMods << std::endl;
@@ -187,8 +360,221 @@ public:
         }
     }
     
+    /**
+     * Writes every histogram to a text file (see LatencyHistogram::Export)
+     */
+    bool ExportHistograms(const std::string& filename) const {
+        std::ofstream out(filename);
+        if (!out) {
+            std::cerr << "Error export histograms: cannot open " << filename << std::endl;
+            return false;
+        }
+        
+        m_standardOspf.outageHistogram.Export(out, "ospf_outage");
+        m_standardOspf.detectionHistogram.Export(out, "ospf_detection");
+        m_rfp.outageHistogram.Export(out, "rfp_outage");
+        m_rfp.detectionHistogram.Export(out, "rfp_detection");
+        m_standardOspf.measuredOutageHistogram.Export(out, "ospf_measured_outage");
+        m_rfp.measuredOutageHistogram.Export(out, "rfp_measured_outage");
+        m_packetDelay.Export(out, "packet_delay");
+        m_probeDelay.Export(out, "probe_delay");
+        m_flushDuration.Export(out, "t2_flush");
+        m_convergence.Export(out, "rfp_convergence");
+        
+        std::cout << "Histograms exported to " << filename << std::endl;
+        return true;
+    }
+    
+    /**
+     * Merges the histograms exported by previous runs into this one
+     */
+    bool MergeHistograms(const std::string& filename) {
+        std::ifstream in(filename);
+        if (!in) {
+            std::cerr << "Error merge histograms: cannot open " << filename << std::endl;
+            return false;
+        }
+        
+        std::string name;
+        LatencyHistogram imported;
+        uint32_t merged = 0;
+        while (imported.Import(in, name)) {
+            LatencyHistogram* target = FindHistogram(name);
+            if (target) {
+                target->Merge(imported);
+                merged++;
+            }
+            imported.Reset();
+        }
+        
+        std::cout << "Merged " << merged << " histograms from " << filename << std::endl;
+        return merged > 0;
+    }
+    
+    /**
+     * Attributes the probe losses to link events (once, at the end of the simulation)
+     * Completed events own the losses sent in [link down, completion + grace];
+     * events never completed (unpredicted failures OSPF did not reconverge from) own them
+     * until the next event starts.
+     * A loss inside several windows is charged once, to the latest event started before it.
+     */
+    void FinalizeMeasurements() {
+        if (m_finalized) return;
+        m_finalized = true;
+        
+        double nowMs = Simulator::Now().GetSeconds() * 1000.0;
+        m_probes.Finalize(Simulator::Now().GetSeconds(), LOSS_ATTRIBUTION_GRACE);
+        
+        // Close the events still open
+        std::vector<std::pair<uint64_t, LinkEvent>> open;
+        m_activeEvents.ForEach([&open](uint64_t key, const LinkEvent& event) {
+            open.push_back(std::make_pair(key, event));
+        });
+        m_activeEvents.Clear();
+        
+        size_t firstOpen = m_completedEvents.Size();
+        for (const auto& entry : open) {
+            const LinkEvent& event = entry.second;
+            m_completedEvents.Append(entry.first, event.linkDownTime, event.routeUpdateTime, event.detectionTime,
+                                     0.0, -1.0, m_quaggaMods - event.quaggaModsAtStart, event.isRfp);
+        }
+        
+        std::vector<double> startTimes(m_completedEvents.linkDownTime);
+        std::sort(startTimes.begin(), startTimes.end());
+        
+        // Loss windows, then the owner of each loss: the latest-started window holding it
+        size_t eventCount = m_completedEvents.Size();
+        std::vector<double> windowStart(eventCount), windowEnd(eventCount);
+        std::vector<size_t> byStart;
+        for (size_t i = 0; i < eventCount; i++) {
+            if (m_completedEvents.linkKey[i] == NO_LINK_KEY) continue;
+            windowStart[i] = m_completedEvents.linkDownTime[i] / 1000.0;
+            if (i < firstOpen) {
+                windowEnd[i] = m_completedEvents.completeTime[i] / 1000.0 + LOSS_ATTRIBUTION_GRACE;
+            } else {
+                auto next = std::upper_bound(startTimes.begin(), startTimes.end(), m_completedEvents.linkDownTime[i]);
+                windowEnd[i] = (next != startTimes.end()) ? *next / 1000.0 : nowMs / 1000.0;
+                m_completedEvents.completeTime[i] = windowEnd[i] * 1000.0;
+            }
+            byStart.push_back(i);
+        }
+        std::stable_sort(byStart.begin(), byStart.end(),
+                         [&windowStart](size_t a, size_t b) { return windowStart[a] < windowStart[b]; });
+        
+        const std::vector<ProbeLoss>& losses = m_probes.GetLosses();
+        std::vector<size_t> owner(losses.size(), eventCount);
+        for (size_t l = 0; l < losses.size(); l++) {
+            auto candidate = std::upper_bound(byStart.begin(), byStart.end(), losses[l].txTime,
+                                              [&windowStart](double t, size_t i) { return t < windowStart[i]; });
+            while (candidate != byStart.begin()) {
+                --candidate;
+                if (losses[l].txTime < windowEnd[*candidate]) {
+                    owner[l] = *candidate;
+                    break;
+                }
+            }
+        }
+        
+        std::vector<double> runStart(m_probes.GetFlowCount());
+        std::vector<double> lastLoss(m_probes.GetFlowCount());
+        
+        for (size_t i = 0; i < eventCount; i++) {
+            if (m_completedEvents.linkKey[i] == NO_LINK_KEY) continue;
+            
+            // Outage window: longest run of consecutive probe losses of any flow; a delivered
+            // probe (a gap of more than one interval between losses) ends the run
+            std::fill(runStart.begin(), runStart.end(), -1.0);
+            uint32_t lost = 0;
+            double outage = 0.0;
+            ProbeLoss from = {0, windowStart[i]};
+            for (auto it = std::lower_bound(losses.begin(), losses.end(), from);
+                 it != losses.end() && it->txTime < windowEnd[i]; ++it) {
+                if (owner[it - losses.begin()] != i) continue;
+                uint32_t f = it->flow;
+                double interval = m_probes.GetInterval(f);
+                if (runStart[f] < 0 || it->txTime - lastLoss[f] > 1.5 * interval) runStart[f] = it->txTime;
+                lastLoss[f] = it->txTime;
+                outage = std::max(outage, (lastLoss[f] - runStart[f] + interval) * 1000.0);
+                lost++;
+            }
+            
+            m_completedEvents.packetsLost[i] = lost;
+            m_completedEvents.measuredOutage[i] = outage;
+            
+            Metrics& metrics = m_completedEvents.isRfp[i] ? m_rfp : m_standardOspf;
+            metrics.packetsLost += lost;
+            metrics.measuredOutageTotal += outage;
+            metrics.measuredOutageHistogram.Record(outage);
+            if (i >= firstOpen) {
+                // No route update observed: the measured window is the route outage
+                m_completedEvents.outageTime[i] = outage;
+                metrics.linkDownEvents++;
+                metrics.routeOutageTotal += outage;
+                metrics.realQuaggaModifications += m_completedEvents.quaggaMods[i];
+                metrics.outageHistogram.Record(outage);
+            }
+        }
+    }
+    
+    /**
+     * Per-event and per-flow metrics as columnar tables (event_metrics, flow_metrics)
+     */
+    void WriteResults(ResultsWriter& writer) {
+        if (!writer.IsOpen()) return;
+        FinalizeMeasurements();
+        
+        ColumnarWriter* events = writer.CreateTable("event_metrics");
+        events->AddColumn("node_a", COLUMN_I32);
+        events->AddColumn("node_b", COLUMN_I32);
+        events->AddColumn("link_down_ms", COLUMN_F64);
+        events->AddColumn("route_update_ms", COLUMN_F64);
+        events->AddColumn("complete_ms", COLUMN_F64);
+        events->AddColumn("detection_ms", COLUMN_F64);
+        events->AddColumn("outage_ms", COLUMN_F64);
+        events->AddColumn("measured_outage_ms", COLUMN_F64);
+        events->AddColumn("packets_lost", COLUMN_U32);
+        events->AddColumn("quagga_mods", COLUMN_U32);
+        events->AddColumn("rfp", COLUMN_U8);
+        
+        const CompletedEventLog& log = m_completedEvents;
+        for (size_t i = 0; i < log.Size(); i++) {
+            bool hasLink = log.linkKey[i] != NO_LINK_KEY;
+            events->PutI32(0, hasLink ? LinkKeyNodeA(log.linkKey[i]) : -1);
+            events->PutI32(1, hasLink ? LinkKeyNodeB(log.linkKey[i]) : -1);
+            events->PutF64(2, log.linkDownTime[i]);
+            events->PutF64(3, log.routeUpdateTime[i]);
+            events->PutF64(4, log.completeTime[i]);
+            events->PutF64(5, log.detectionTime[i]);
+            events->PutF64(6, log.outageTime[i]);
+            events->PutF64(7, log.measuredOutage[i]);
+            events->PutU32(8, log.packetsLost[i]);
+            events->PutU32(9, log.quaggaMods[i]);
+            events->PutU8(10, log.isRfp[i]);
+            events->EndRow();
+        }
+        delete events;
+        
+        ColumnarWriter* flows = writer.CreateTable("flow_metrics");
+        flows->AddColumn("flow", COLUMN_U32);
+        flows->AddColumn("interval_s", COLUMN_F64);
+        flows->AddColumn("sent", COLUMN_U64);
+        flows->AddColumn("received", COLUMN_U64);
+        flows->AddColumn("lost", COLUMN_U64);
+        for (uint32_t f = 0; f < m_probes.GetFlowCount(); f++) {
+            flows->PutU32(0, f);
+            flows->PutF64(1, m_probes.GetInterval(f));
+            flows->PutU64(2, m_probes.GetFlowSent(f));
+            flows->PutU64(3, m_probes.GetFlowReceived(f));
+            flows->PutU64(4, m_probes.GetFlowLost(f));
+            flows->EndRow();
+        }
+        delete flows;
+    }
+    
     void PrintFinalResults() {
         try {
+            FinalizeMeasurements();
+            
             std::cout << "" << std::endl;
             std::cout << "" << std::endl;
             std::cout << "========== PERFORMANCE ANALYSIS RESULTS ==========" << std::endl;
@@ -205,18 +591,35 @@ public:
                 (m_rfp.detectionTimeTotal / m_rfp.linkDownEvents) : 0.0;
             
             std::cout << "Standard OSPF Performance:" << std::endl;
+            if (!m_ospfBaseline.empty()) {
+                std::cout << "   Timers: " << m_ospfBaseline << std::endl;
+            }
             std::cout << "   Events: " << m_standardOspf.linkDownEvents << std::endl;
             std::cout << "   Total packets lost: " << m_standardOspf.packetsLost << std::endl;
             std::cout << "   Average route outage: " << avgStandardOutage << " ms" << std::endl;
             std::cout << "   Average detection time: " << avgStandardDetection << " ms" << std::endl;
+            std::cout << "   Average measured outage (probes): " << (m_standardOspf.linkDownEvents > 0 ?
+                m_standardOspf.measuredOutageTotal / m_standardOspf.linkDownEvents : 0.0) << " ms" << std::endl;
             std::cout << "   Quagga modifications: " << m_standardOspf.realQuaggaModifications << std::endl;
             
             std::cout << "" << std::endl;
             std::cout << "SATNET-OSPF RFP Performance:" << std::endl;
+            std::cout << "   Tc: " << GetRfpTiming().tc << " s" << (GetRfpTiming().measuredTc ? " (measured)" : "");
+            if (GetRfpTiming().measuredSamples > 0) {
+                std::cout << ", slowest convergence " << GetRfpTiming().measuredMax << " s over "
+                          << GetRfpTiming().measuredSamples << " changes";
+            }
+            std::cout << std::endl;
+            if (m_convergenceChecks > 0) {
+                std::cout << "   Converged before T2: " << m_convergenceChecks - m_tcInsufficient << "/"
+                          << m_convergenceChecks << " events (Tc insufficient for " << m_tcInsufficient << ")" << std::endl;
+            }
             std::cout << "   Events: " << m_rfp.linkDownEvents << std::endl;
             std::cout << "   Total packets lost: " << m_rfp.packetsLost << std::endl;
             std::cout << "   Average route outage: " << avgRfpOutage << " ms" << std::endl;
             std::cout << "   Average detection time: " << avgRfpDetection << " ms" << std::endl;
+            std::cout << "   Average measured outage (probes): " << (m_rfp.linkDownEvents > 0 ?
+                m_rfp.measuredOutageTotal / m_rfp.linkDownEvents : 0.0) << " ms" << std::endl;
             std::cout << "   Quagga modifications: " << m_rfp.realQuaggaModifications << std::endl;
             
             std::cout << "" << std::endl;
@@ -245,9 +648,25 @@ public:
                       << (m_rfp.realQuaggaModifications + m_standardOspf.realQuaggaModifications) << std::endl;
             std::cout << "   vtysh status: " << (GetVtyshState().available ? "REAL" : "SIMULATED") << std::endl;
             
+            std::cout << "" << std::endl;
+            std::cout << "LATENCY DISTRIBUTIONS:" << std::endl;
+            m_standardOspf.outageHistogram.PrintSummary("OSPF route outage");
+            m_standardOspf.detectionHistogram.PrintSummary("OSPF detection time");
+            m_rfp.outageHistogram.PrintSummary("RFP route outage");
+            m_standardOspf.measuredOutageHistogram.PrintSummary("OSPF measured outage");
+            m_rfp.measuredOutageHistogram.PrintSummary("RFP measured outage");
+            m_rfp.detectionHistogram.PrintSummary("RFP detection time");
+            m_packetDelay.PrintSummary("End-to-end packet delay");
+            m_probeDelay.PrintSummary("Probe delay");
+            m_flushDuration.PrintSummary("T2 flush duration (wall clock)");
+            m_convergence.PrintSummary("RFP measured convergence (T1 to tables converged)");
+            
             std::cout << "" << std::endl;
             std::cout << "Total simulation packets: sent=" << m_packetsSentTotal 
                       << ", received=" << m_packetsReceivedTotal << std::endl;
+            std::cout << "Probe flows: " << m_probes.GetFlowCount() << ", sent=" << m_probes.GetSent()
+                      << ", received=" << m_probes.GetReceived() << ", lost=" << m_probes.GetLost()
+                      << ", late=" << m_probes.GetLateArrivals() << std::endl;
             
             std::cout << "" << std::endl;
             std::cout << "================================================" << std::endl;
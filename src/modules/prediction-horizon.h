@@ -0,0 +1,116 @@
+#ifndef PREDICTION_HORIZON_H
+#define PREDICTION_HORIZON_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "ns3/core-module.h"
+#include "../core/rfp-timing.h"
+#include "../helpers/async-logger.h"
+
+using namespace ns3;
+
+const double PREDICTION_HORIZON_MARGIN = 5.0;      // s on top of 2 x (Tc + 2dT)
+const double PREDICTION_HORIZON_MIN_STEP = 0.1;    // s, shortest time between two windows
+
+/**
+ * A link-down the contact plan predicts (T0 = time)
+ */
+struct PredictedTransition {
+    int linkId;
+    int nodeA;
+    int nodeB;
+    double time;
+};
+
+/**
+ * Streaming predictor: a sliding look-ahead window over the contact plan
+ *
+ * Every half horizon the source is asked for the transitions whose T0 falls between the
+ * end of the previous window and now + horizon; they are handed over in T0 order. The
+ * next window is taken at the latest margin / 2 before the first uncovered T0 minus the
+ * current Tc + 2dT, so a Tc measured since the last window brings it forward. The
+ * default horizon, 2 x (Tc + 2dT) + margin, follows Tc when it is measured. A Tc growing
+ * by more than margin / 2 before the next window can still make a prediction arrive
+ * after its T1; the RFP timeline refuses those (counted as late). Only one window of
+ * transitions is held at a time.
+ */
+class PredictionHorizon {
+public:
+    typedef std::function<void(double from, double until, std::vector<PredictedTransition>&)> TransitionSource;
+    typedef std::function<void(const std::vector<PredictedTransition>&)> PredictionCallback;
+
+private:
+    TransitionSource m_source;
+    PredictionCallback m_predict;
+    double m_horizon;           // s, 0: 2 x (Tc + 2dT) + margin
+    double m_margin;
+    double m_windowEnd;         // T0 covered so far
+    double m_until;             // End of the contact plan
+    std::vector<PredictedTransition> m_window;
+
+    uint64_t m_windows;
+    uint64_t m_predicted;
+    size_t m_peakWindow;
+
+    void Advance() {
+        double now = Simulator::Now().GetSeconds();
+        double horizon = GetHorizon();
+        double end = std::min(m_until, now + horizon);
+
+        if (end > m_windowEnd) {
+            m_window.clear();
+            if (m_source) m_source(m_windowEnd, end, m_window);
+            std::stable_sort(m_window.begin(), m_window.end(),
+                             [](const PredictedTransition& a, const PredictedTransition& b) { return a.time < b.time; });
+            SATLOG_LOGIC(SATLOG_TMM, "TMM: prediction window [{}s, {}s): {} link-down events", m_windowEnd, end, m_window.size());
+
+            m_windows++;
+            m_predicted += m_window.size();
+            m_peakWindow = std::max(m_peakWindow, m_window.size());
+            m_windowEnd = end;
+            if (m_predict && !m_window.empty()) m_predict(m_window);
+        }
+
+        if (m_windowEnd < m_until) {
+            double next = std::min(horizon / 2, m_windowEnd - now - GetRfpTiming().Lead() - m_margin / 2);
+            Simulator::Schedule(Seconds(std::max(next, PREDICTION_HORIZON_MIN_STEP)), &PredictionHorizon::Advance, this);
+        }
+    }
+
+public:
+    PredictionHorizon(double horizon = 0.0, double margin = PREDICTION_HORIZON_MARGIN)
+        : m_horizon(horizon), m_margin(margin), m_windowEnd(0.0), m_until(0.0),
+          m_windows(0), m_predicted(0), m_peakWindow(0) {}
+
+    /**
+     * Fills the vector with the transitions whose T0 is in [from, until)
+     */
+    void SetTransitionSource(TransitionSource source) {
+        m_source = source;
+    }
+
+    void SetPredictionCallback(PredictionCallback predict) {
+        m_predict = predict;
+    }
+
+    double GetHorizon() const {
+        return m_horizon > 0.0 ? m_horizon : 2 * GetRfpTiming().Lead() + m_margin;
+    }
+
+    /**
+     * First window at startTime (absolute), the last one ends at until
+     */
+    void Start(double startTime, double until) {
+        m_until = until;
+        Simulator::Schedule(Seconds(startTime) - Simulator::Now(), &PredictionHorizon::Advance, this);
+    }
+
+    void PrintStatistics() const {
+        std::cout << "Prediction horizon: " << GetHorizon() << "s, " << m_predicted << " link-down events in "
+                  << m_windows << " windows (peak " << m_peakWindow << " per window)" << std::endl;
+    }
+};
+
+#endif // PREDICTION_HORIZON_H
@@ -0,0 +1,149 @@
+#ifndef RFP_TIMELINE_H
+#define RFP_TIMELINE_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "ns3/core-module.h"
+#include "topology-mgmt.h"
+
+using namespace ns3;
+
+/**
+ * RFP phases in dispatch order for a single event
+ */
+enum RfpPhase : uint8_t {
+    RFP_PHASE_T1,
+    RFP_PHASE_T2,
+    RFP_PHASE_T0,
+    RFP_PHASE_T3,
+    RFP_PHASE_COUNT
+};
+
+inline double GetPhaseTime(const PredictableLinkDownEvent& event, RfpPhase phase) {
+    switch (phase) {
+        case RFP_PHASE_T1: return event.T1;
+        case RFP_PHASE_T2: return event.T2;
+        case RFP_PHASE_T0: return event.T0;
+        default: return event.T3;
+    }
+}
+
+/**
+ * Timeline of the RFP phase transitions of the events stored in the TMM
+ *
+ * Each scheduled event has one entry in a min-heap: its next phase (time, event, phase).
+ * Only the earliest entry is armed on the ns-3 scheduler; when it fires, every phase due
+ * by then is dispatched in one batch and the event's next phase takes its place in the
+ * heap. Ties keep the order four separate Simulator::Schedule calls per event would
+ * give: events in TMM order, then T1, T2, T0, T3.
+ */
+class RfpTimeline {
+public:
+    typedef std::function<void(uint32_t index, const PredictableLinkDownEvent&, RfpPhase, double)> DispatchCallback;
+
+private:
+    struct Entry {
+        double time;
+        uint32_t event;     // Index in the TMM
+        RfpPhase phase;
+    };
+
+    // std::*_heap keep the largest first: "later" entries compare as smaller
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.time != b.time) return a.time > b.time;
+            if (a.event != b.event) return a.event > b.event;
+            return a.phase > b.phase;
+        }
+    };
+
+    const TopologyManagementModule& m_tmm;
+    DispatchCallback m_dispatch;
+    std::vector<Entry> m_heap;
+    EventId m_next;
+    double m_nextTime;
+    bool m_firing;
+
+    uint64_t m_armed;
+    uint64_t m_batches;
+    uint64_t m_dispatched;
+    uint64_t m_late;
+    size_t m_peakPending;
+
+    void Push(uint32_t event, RfpPhase phase) {
+        m_heap.push_back({GetPhaseTime(m_tmm.GetEvent(event), phase), event, phase});
+        std::push_heap(m_heap.begin(), m_heap.end(), Later());
+        m_peakPending = std::max(m_peakPending, m_heap.size());
+    }
+
+    void Arm() {
+        if (m_heap.empty()) return;
+        double time = m_heap.front().time;
+        if (m_next.IsRunning()) {
+            if (time >= m_nextTime) return;
+            m_next.Cancel();
+        }
+        // Add refuses a T1 already passed, so the earliest entry is never in the past
+        m_next = Simulator::Schedule(Seconds(time) - Simulator::Now(), &RfpTimeline::Fire, this);
+        m_nextTime = time;
+        m_armed++;
+    }
+
+    void Fire() {
+        m_firing = true;
+        m_batches++;
+        double due = m_nextTime;
+        while (!m_heap.empty() && m_heap.front().time <= due) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), Later());
+            Entry entry = m_heap.back();
+            m_heap.pop_back();
+
+            if (entry.phase + 1 < RFP_PHASE_COUNT) {
+                Push(entry.event, (RfpPhase)(entry.phase + 1));
+            }
+            m_dispatched++;
+            if (m_dispatch) m_dispatch(entry.event, m_tmm.GetEvent(entry.event), entry.phase, entry.time);
+        }
+        m_firing = false;
+        Arm();
+    }
+
+public:
+    explicit RfpTimeline(const TopologyManagementModule& tmm)
+        : m_tmm(tmm), m_nextTime(0.0), m_firing(false), m_armed(0), m_batches(0), m_dispatched(0), m_late(0), m_peakPending(0) {}
+
+    void SetDispatchCallback(DispatchCallback dispatch) {
+        m_dispatch = dispatch;
+    }
+
+    /**
+     * Schedules the four phases of a TMM event (index returned by AddPredictableLinkDown);
+     * false, nothing scheduled, when its T1 has already passed
+     */
+    bool Add(uint32_t event) {
+        const PredictableLinkDownEvent& pld = m_tmm.GetEvent(event);
+        if (Seconds(pld.T1) < Simulator::Now()) {
+            m_late++;
+            SATLOG_WARN(SATLOG_RFP, "RFP timeline: link {}<->{} predicted after its T1 ({}s), not scheduled",
+                        pld.nodeA, pld.nodeB, pld.T1);
+            return false;
+        }
+        Push(event, RFP_PHASE_T1);
+        if (!m_firing) Arm();
+        return true;
+    }
+
+    size_t GetPending() const { return m_heap.size(); }
+    uint64_t GetArmedCount() const { return m_armed; }
+    uint64_t GetDispatchedCount() const { return m_dispatched; }
+
+    void PrintStatistics() const {
+        std::cout << "RFP timeline: " << m_dispatched << " phase transitions in " << m_batches
+                  << " batches (" << m_armed << " scheduler entries, peak " << m_peakPending << " events pending, "
+                  << m_late << " late)" << std::endl;
+    }
+};
+
+#endif // RFP_TIMELINE_H
@@ -5,48 +5,90 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <functional>
 #include "ns3/core-module.h"
 #include "../helpers/quagga-integration.h"
+#include "forwarding-table.h"
 
 using namespace ns3;
 
+/**
+ * Pluggable source of route updates (e.g. Contact Graph Routing)
+ * Updates use the RMM text format: "ADD <prefix> <nexthop> <metric>"
+ */
+class RouteSource {
+public:
+    virtual ~RouteSource() {}
+    
+    virtual std::string GetName() const = 0;
+    
+    virtual std::vector<std::pair<Ptr<Node>, std::string>> ComputeRouteUpdates(double currentTime) = 0;
+};
+
+enum RouteTarget {
+    ROUTE_TARGET_ACTIVE,      // Active forwarding table and Quagga
+    ROUTE_TARGET_SHADOW,      // BFU shadow table (Quagga at T2)
+    ROUTE_TARGET_QUAGGA       // Quagga only
+};
+
 /**
  * Route Management Module (RMM) - ROBUST ERROR HANDLING
  * Manages route updates and BFU (Blind Forwarding Update) periods
  */
 class RouteManagementModule {
+public:
+    typedef std::function<bool(uint32_t nodeId)> TableRoutedCallback;
+
 private:
     bool m_bfuActive;                                 // Is BFU period active?
     std::vector<std::pair<Ptr<Node>, std::string>> m_pendingUpdates;  // Pending updates
     uint32_t m_routeUpdatesBlocked;                   // Counter for blocked updates
     uint32_t m_routeUpdatesApplied;                   // Counter for applied updates
+    std::vector<DoubleBufferedTable> m_fibs;          // Simulator-side ECMP tables (active + BFU shadow), indexed by node
+    std::vector<uint32_t> m_stagedNodes;              // Nodes with routes in their shadow table
+    uint64_t m_tablesSwapped;                         // Of nodes whose packets use the active table
+    uint64_t m_mirrorsSwapped;                        // Of nodes forwarding with Quagga's kernel table
+    uint32_t m_swaps;
+    TableRoutedCallback m_tableRouted;
+    LinkLoadMonitor* m_loadMonitor;                   // Optional queue occupancy source
+    double m_loadRefreshInterval;
+    std::vector<uint32_t> m_reweightNodes;            // Active table changed since the last load refresh
+    std::vector<uint8_t> m_reweightPending;           // Per node, listed in m_reweightNodes
+    std::vector<std::pair<int, int>> m_changedLinks;  // (node, neighbor) whose load weight moved
     
 public:
-    RouteManagementModule() : m_bfuActive(false), m_routeUpdatesBlocked(0), m_routeUpdatesApplied(0) {}
+    RouteManagementModule() : m_bfuActive(false), m_routeUpdatesBlocked(0), m_routeUpdatesApplied(0),
+                              m_tablesSwapped(0), m_mirrorsSwapped(0), m_swaps(0), m_loadMonitor(nullptr), m_loadRefreshInterval(0.1) {}
     
     /**
      * Starts the BFU period - delays application of new routes (T1)
      */
     void StartBfuPeriod(double currentTime) {
         m_bfuActive = true;
-        std::cout << "⏸️ RMM: Started BFU period at t=" << currentTime << "s" << std::endl;
-        std::cout << "   → Route updates will be delayed until synchronization point" << std::endl;
+        SATLOG_INFO(SATLOG_RMM, "⏸️ RMM: Started BFU period at t={}s", currentTime);
+        SATLOG_INFO(SATLOG_RMM, "   → Route updates will be delayed until synchronization point");
     }
     
     /**
-     * Ends the BFU period - applies all pending routes SYNCHRONOUSLY (T2)
+     * Ends the BFU period (T2): every node with staged routes switches to its shadow table
+     * in this same event, then the pending updates are mirrored to Quagga
      */
     void EndBfuPeriod(double currentTime) {
+        SATNET_TIMER(TIMER_BFU_FLUSH);
+        SATNET_COUNT(COUNTER_BFU_UPDATES_FLUSHED, m_pendingUpdates.size());
         m_bfuActive = false;
         
-        std::cout << "🔄 RMM: Ended BFU period at t=" << currentTime << "s" << std::endl;
-        std::cout << "   → Applying " << m_pendingUpdates.size() 
-                  << " pending route updates SYNCHRONOUSLY" << std::endl;
+        SATLOG_INFO(SATLOG_RMM, "🔄 RMM: Ended BFU period at t={}s", currentTime);
+        SATLOG_INFO(SATLOG_RMM, "   → Switching {} forwarding tables, {} pending route updates",
+                    m_stagedNodes.size(), m_pendingUpdates.size());
         
         try {
-            // Apply all pending updates
+            // Atomic for forwarding: O(1) per node, all in this simulator event
+            SwapStagedTables();
+            
+            // Quagga mirror: vtysh processes start later, forwarding no longer depends on them
             for (const auto& update : m_pendingUpdates) {
-                ApplyRouteUpdateReal(update.first, update.second);
+                ApplyRouteUpdateReal(update.first, update.second, ROUTE_TARGET_QUAGGA);
                 m_routeUpdatesApplied++;
             }
             m_pendingUpdates.clear();
@@ -54,45 +96,224 @@ public:
             // Find alternative paths via other nodes (limited to avoid errors)
             ForceOspfConvergence();
             
-            std::cout << "RMM: All forwarding tables updated synchronously" << std::endl;
-            std::cout << "   → " << m_routeUpdatesApplied << " route updates applied" << std::endl;
+            SATLOG_INFO(SATLOG_RMM, "RMM: All forwarding tables updated synchronously");
+            SATLOG_INFO(SATLOG_RMM, "   → {} route updates applied", m_routeUpdatesApplied);
             
         } catch (const std::exception& e) {
-            std::cerr << "Error ending BFU period: " << e.what() << std::endl;
-            std::cerr << "BFU period ended in simulation mode" << std::endl;
+            SATLOG_ERROR(SATLOG_RMM, "Error ending BFU period: {}", e.what());
+            SATLOG_WARN(SATLOG_RMM, "BFU period ended in simulation mode");
         }
     }
     
 
     void OnNewRoutingTable(Ptr<Node> node, const std::string& routeUpdate, double currentTime) {
         try {
+            RecordRouteUpdate(node, routeUpdate, currentTime, m_bfuActive);
             if (m_bfuActive) {
+                ApplyRouteUpdateReal(node, routeUpdate, ROUTE_TARGET_SHADOW);
                 m_pendingUpdates.push_back(std::make_pair(node, routeUpdate));
                 m_routeUpdatesBlocked++;
-                // std::cout << "RMM: Route update DELAYED (BFU active) - " 
-                //           << m_routeUpdatesBlocked << " updates pending" << std::endl;
+                SATLOG_LOGIC(SATLOG_RMM, "RMM: Route update DELAYED (BFU active) - {} updates pending",
+                             m_routeUpdatesBlocked);
             } else {
                 ApplyRouteUpdateReal(node, routeUpdate);
                 m_routeUpdatesApplied++;
-                // std::cout << "RMM: Route update applied immediately" << std::endl;
+                SATLOG_LOGIC(SATLOG_RMM, "RMM: Route update applied immediately");
             }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error on new routing table: " << e.what() << std::endl;
-            std::cerr << "Routing table update applied in simulation mode" << std::endl;
+            SATLOG_ERROR(SATLOG_RMM, "Error on new routing table: {}", e.what());
+            SATLOG_WARN(SATLOG_RMM, "Routing table update applied in simulation mode");
+        }
+    }
+    
+    /**
+     * Applies a local repair route immediately, BFU does not delay fast failover
+     */
+    void ApplyFailoverUpdate(Ptr<Node> node, const std::string& routeUpdate) {
+        try {
+            RecordRouteUpdate(node, routeUpdate, Simulator::Now().GetSeconds(), false);
+            ApplyRouteUpdateReal(node, routeUpdate);
+            m_routeUpdatesApplied++;
+            
+        } catch (const std::exception& e) {
+            SATLOG_ERROR(SATLOG_RMM, "Error applying failover update: {}", e.what());
         }
     }
     
+    /**
+     * Pulls the current routes from a route source and applies them (BFU-aware)
+     */
+    void ApplyRouteSource(RouteSource& source, double currentTime) {
+        try {
+            std::vector<std::pair<Ptr<Node>, std::string>> updates = source.ComputeRouteUpdates(currentTime);
+            
+            for (const auto& update : updates) {
+                OnNewRoutingTable(update.first, update.second, currentTime);
+            }
+            
+            SATLOG_INFO(SATLOG_RMM, "RMM: {} route updates from {} at t={}s{}", updates.size(), source.GetName(),
+                        currentTime, m_bfuActive ? " (delayed by BFU)" : "");
+            
+        } catch (const std::exception& e) {
+            SATLOG_ERROR(SATLOG_RMM, "Error applying route source {}: {}", source.GetName(), e.what());
+        }
+    }
+    
+    /**
+     * Forwarding path (SatnetRouting): next hop of a flow from nodeId towards destination (-1 if no route)
+     */
+    int SelectNextHop(uint32_t nodeId, int destination, uint32_t flowHash) const {
+        if (nodeId >= m_fibs.size()) return -1;
+        return m_fibs[nodeId].Active().Lookup(destination, flowHash);
+    }
+    
+    /**
+     * Whole start table of a node (no Quagga, no update strings): next hop and metric per
+     * destination node, negative next hop without a route
+     */
+    void SeedForwardingTable(uint32_t nodeId, const std::vector<int16_t>& nextHops, const std::vector<uint16_t>& metrics) {
+        ForwardingTable& fib = GetFib(nodeId).Active();
+        for (size_t destination = 0; destination < nextHops.size(); destination++) {
+            if (nextHops[destination] < 0 || destination == nodeId) continue;
+            NextHopSet route;
+            route.metric = metrics[destination];
+            route.Add(nextHops[destination]);
+            fib.SetRoute(destination, route);
+        }
+        MarkReweight(nodeId);
+    }
+    
+    const ForwardingTable* GetForwardingTable(uint32_t nodeId) const {
+        return (nodeId < m_fibs.size()) ? &m_fibs[nodeId].Active() : nullptr;
+    }
+    
+    /**
+     * Nodes whose packets are forwarded with their active table (SatnetRouting); the
+     * tables of the other nodes only mirror what is pushed to Quagga
+     */
+    void SetTableRoutedCallback(TableRoutedCallback tableRouted) {
+        m_tableRouted = tableRouted;
+    }
+    
+    /**
+     * Reweights the next-hop sets from the sampled queue occupancy: at each refresh, the
+     * sets using a link whose weight changed, and every set of a table that changed
+     */
+    void EnableLoadAwareWeights(LinkLoadMonitor* monitor, double refreshInterval) {
+        m_loadMonitor = monitor;
+        m_loadRefreshInterval = refreshInterval;
+        Simulator::Schedule(Seconds(refreshInterval), &RouteManagementModule::RefreshLoadWeights, this);
+    }
+    
     uint32_t GetBlockedUpdatesCount() const { return m_routeUpdatesBlocked; }
     uint32_t GetAppliedUpdatesCount() const { return m_routeUpdatesApplied; }
     bool IsBfuActive() const { return m_bfuActive; }
+    uint64_t GetTablesSwapped() const { return m_tablesSwapped; }
+    uint64_t GetMirrorsSwapped() const { return m_mirrorsSwapped; }
+    uint32_t GetSwapCount() const { return m_swaps; }
     
 private:
+    void RefreshLoadWeights() {
+        if (!m_loadMonitor) return;
+        
+        m_loadMonitor->TakeChangedLinks(m_changedLinks);
+        for (const auto& link : m_changedLinks) {
+            if ((size_t)link.first >= m_fibs.size() || m_reweightPending[link.first]) continue;
+            m_fibs[link.first].Active().ApplyLoad(*m_loadMonitor, link.second);
+        }
+        for (uint32_t nodeId : m_reweightNodes) {
+            m_fibs[nodeId].Active().ApplyLoad(*m_loadMonitor);
+            m_reweightPending[nodeId] = 0;
+        }
+        m_reweightNodes.clear();
+        Simulator::Schedule(Seconds(m_loadRefreshInterval), &RouteManagementModule::RefreshLoadWeights, this);
+    }
+    
+    DoubleBufferedTable& GetFib(uint32_t nodeId) {
+        while (m_fibs.size() <= nodeId) {
+            m_fibs.push_back(DoubleBufferedTable(m_fibs.size()));
+            m_reweightPending.push_back(0);
+        }
+        return m_fibs[nodeId];
+    }
+    
+    // New next hops start idle: the whole table is reweighted at the next load refresh
+    void MarkReweight(uint32_t nodeId) {
+        if (!m_loadMonitor || m_reweightPending[nodeId]) return;
+        m_reweightPending[nodeId] = 1;
+        m_reweightNodes.push_back(nodeId);
+    }
+    
+    void SwapStagedTables() {
+        for (uint32_t nodeId : m_stagedNodes) {
+            if (!m_fibs[nodeId].Swap()) continue;
+            MarkReweight(nodeId);
+            if (m_tableRouted && m_tableRouted(nodeId)) {
+                m_tablesSwapped++;
+            } else {
+                m_mirrorsSwapped++;
+            }
+        }
+        SATNET_COUNT(COUNTER_FIB_SWAPS, m_stagedNodes.size());
+        m_stagedNodes.clear();
+        m_swaps++;
+    }
+    
+    void ApplyToTable(ForwardingTable& fib, const std::string& action, int destination, int neighbor, int metric) {
+        if (action == "ADD") {
+            fib.AddNextHop(destination, neighbor, metric);
+        } else if (action == "DEL") {
+            fib.RemoveNextHop(destination, neighbor);
+        } else if (action == "UPDATE") {
+            fib.RemoveNextHop(destination, neighbor);
+            fib.AddNextHop(destination, neighbor, metric);
+        }
+    }
+    
+    /**
+     * Route update row for the columnar results (parsed only when results are enabled)
+     */
+    void RecordRouteUpdate(Ptr<Node> node, const std::string& routeUpdate, double currentTime, bool buffered) {
+        ResultsWriter& results = GetResultsWriter();
+        if (!results.IsOpen()) return;
+        
+        char action[8] = {0};
+        char prefix[32] = {0};
+        char nexthop[128] = {0};
+        unsigned int metric = 1;
+        sscanf(routeUpdate.c_str(), "%7s %31s %127s %u", action, prefix, nexthop, &metric);
+        
+        uint8_t op = (action[0] == 'A') ? 0 : (action[0] == 'D') ? 1 : 2;
+        uint8_t hopCount = nexthop[0] ? 1 : 0;
+        for (const char* c = nexthop; *c; c++) {
+            if (*c == ',') hopCount++;
+        }
+        results.RecordRouteUpdate(currentTime, node->GetId(), op, ParseDestinationNode(prefix),
+                                  ParseNextHopNode(nexthop), hopCount, metric, buffered);
+    }
+    
+    /**
+     * Simulator FIB of a node to write into, or none (Quagga only)
+     */
+    ForwardingTable* TargetTable(uint32_t nodeId, RouteTarget target) {
+        if (target == ROUTE_TARGET_QUAGGA) return nullptr;
+        DoubleBufferedTable& fib = GetFib(nodeId);
+        if (target == ROUTE_TARGET_SHADOW) {
+            if (!fib.IsStaged()) m_stagedNodes.push_back(nodeId);
+            return &fib.Shadow();
+        }
+        return &fib.Active();
+    }
+    
     /**
-     * Really applies a route update in Quagga
+     * Really applies a route update: simulator FIB and Quagga (ROUTE_TARGET_ACTIVE), the
+     * BFU shadow table only, or Quagga only (T2 mirror of the staged updates)
+     * The next hop may be an ECMP set: "10.0.1.1,10.0.3.1" (NodeNextHop of nodes 1 and 3)
      */
-    void ApplyRouteUpdateReal(Ptr<Node> node, const std::string& routeUpdate) {
-        std::cout << "Applying route update to node " << node->GetId() << ": " << routeUpdate << std::endl;
+    void ApplyRouteUpdateReal(Ptr<Node> node, const std::string& routeUpdate,
+                              RouteTarget target = ROUTE_TARGET_ACTIVE) {
+        SATLOG_LOGIC(SATLOG_RMM, "Applying route update to node {}: {}", node->GetId(), routeUpdate);
         
         try {
             std::istringstream iss(routeUpdate);
@@ -101,21 +322,42 @@ private:
             
             iss >> action >> prefix >> nexthop >> metric;
             
-            if (action == "ADD") {
-                AddQuaggaRoute(node, prefix, nexthop, metric);
-            } else if (action == "DEL") {
-                DelQuaggaRoute(node, prefix, nexthop);
-            } else if (action == "UPDATE") {
-                // Mettre à jour route existante
-                DelQuaggaRoute(node, prefix, nexthop);
-                AddQuaggaRoute(node, prefix, nexthop, metric);
+            ForwardingTable* fib = TargetTable(node->GetId(), target);
+            // Applied at once during BFU (failover): the swap must not undo it
+            ForwardingTable* shadow = (target == ROUTE_TARGET_ACTIVE && GetFib(node->GetId()).IsStaged())
+                                      ? &GetFib(node->GetId()).Shadow() : nullptr;
+            // Table-routed nodes run no Quagga: their active table is the route on the packet path
+            bool quagga = target != ROUTE_TARGET_SHADOW && !(m_tableRouted && m_tableRouted(node->GetId()));
+            int destination = ParseDestinationNode(prefix);
+            
+            std::istringstream hops(nexthop);
+            std::string hop;
+            while (std::getline(hops, hop, ',')) {
+                if (hop.empty()) continue;
+                int neighbor = ParseNextHopNode(hop);
+                
+                if (action == "ADD") {
+                    if (quagga) AddQuaggaRoute(node, prefix, hop, metric);
+                } else if (action == "DEL") {
+                    if (quagga) DelQuaggaRoute(node, prefix, hop);
+                } else if (action == "UPDATE") {
+                    // Mettre à jour route existante
+                    if (quagga) {
+                        DelQuaggaRoute(node, prefix, hop);
+                        AddQuaggaRoute(node, prefix, hop, metric);
+                    }
+                }
+                for (ForwardingTable* table : {fib, shadow}) {
+                    if (table) ApplyToTable(*table, action, destination, neighbor, metric);
+                }
             }
+            if (fib && target == ROUTE_TARGET_ACTIVE) MarkReweight(node->GetId());
             
-            std::cout << "RFP: Applied route " << action << " " << prefix << " via " << nexthop << " on node " << node->GetId() << std::endl;
+            SATLOG_LOGIC(SATLOG_RMM, "RFP: Applied route {} {} via {} on node {}", action, prefix, nexthop, node->GetId());
             
         } catch (const std::exception& e) {
-            std::cerr << "Error applying route update: " << e.what() << std::endl;
-            std::cerr << "Route update applied in simulation mode" << std::endl;
+            SATLOG_ERROR(SATLOG_RMM, "Error applying route update: {}", e.what());
+            SATLOG_WARN(SATLOG_RMM, "Route update applied in simulation mode");
         }
     }
 };
@@ -3,8 +3,13 @@
 
 #include <iostream>
 #include <vector>
+#include <deque>
+#include <algorithm>
 #include "ns3/core-module.h"
 #include "../core/constellation-params.h"
+#include "../core/rfp-timing.h"
+#include "../core/instrumentation.h"
+#include "../helpers/async-logger.h"
 
 using namespace ns3;
 
@@ -26,16 +31,17 @@ struct PredictableLinkDownEvent {
     
     PredictableLinkDownEvent(int lid, int a, int b, double t0) 
         : linkId(lid), nodeA(a), nodeB(b), T0(t0), active(true) {
-        T1 = T0 - RFP_CONVERGENCE_TIME_TC - 2 * RFP_SAFETY_MARGIN_DT;
-        T2 = T0 - RFP_SAFETY_MARGIN_DT;
-        T3 = T0 + RFP_SAFETY_MARGIN_DT;
+        const RfpTiming& timing = GetRfpTiming();
+        T1 = T0 - timing.tc - 2 * timing.dt;
+        T2 = T0 - timing.dt;
+        T3 = T0 + timing.dt;
         
         // Ensure T1 > 0
         if (T1 < 0) {
             T1 = 0.1;
-            T2 = T1 + RFP_CONVERGENCE_TIME_TC + RFP_SAFETY_MARGIN_DT;
-            T3 = T2 + 2 * RFP_SAFETY_MARGIN_DT;
-            T0 = T3 - RFP_SAFETY_MARGIN_DT;
+            T2 = T1 + timing.tc + timing.dt;
+            T3 = T2 + 2 * timing.dt;
+            T0 = T3 - timing.dt;
         }
     }
 };
@@ -43,28 +49,62 @@ struct PredictableLinkDownEvent {
 /**
  * Topology Management Module (TMM)
  * Manages topological model and extracts predictable events
+ * Events keep their index for life. Each one is retired at its T3 dispatch and dropped
+ * once every event stored before it is retired too (ISL and GSL events arrive out of T3 order).
  */
 class TopologyManagementModule {
 private:
-    std::vector<PredictableLinkDownEvent> m_predictedEvents;
+    std::deque<PredictableLinkDownEvent> m_predictedEvents;
+    uint32_t m_firstIndex;      // Index of the front event
+    size_t m_peakEvents;
     
 public:
-    void AddPredictableLinkDown(int linkId, int nodeA, int nodeB, double eventTime) {
-        PredictableLinkDownEvent event(linkId, nodeA, nodeB, eventTime);
+    TopologyManagementModule() : m_firstIndex(0), m_peakEvents(0) {}
+    
+    /**
+     * Stores an event built by the caller, returns its index
+     */
+    uint32_t AddPredictableLinkDown(const PredictableLinkDownEvent& event) {
         m_predictedEvents.push_back(event);
+        m_peakEvents = std::max(m_peakEvents, m_predictedEvents.size());
         
-        std::cout << "TMM: Predicted link-down event scheduled for link " << linkId << std::endl;
-        std::cout << "   Link: " << nodeA << "<->" << nodeB << std::endl;
-        std::cout << "   T0 (actual failure): " << event.T0 << "s" << std::endl;
-        std::cout << "   T1 (start BLD/BFU): " << event.T1 << "s" << std::endl;
-        std::cout << "   T2 (sync forwarding): " << event.T2 << "s" << std::endl;
-        std::cout << "   T3 (end BLD): " << event.T3 << "s" << std::endl;
+        SATLOG_INFO(SATLOG_TMM, "TMM: Predicted link-down event scheduled for link {}", event.linkId);
+        SATLOG_INFO(SATLOG_TMM, "   Link: {}<->{}", event.nodeA, event.nodeB);
+        SATLOG_INFO(SATLOG_TMM, "   T0 (actual failure): {}s", event.T0);
+        SATLOG_INFO(SATLOG_TMM, "   T1 (start BLD/BFU): {}s", event.T1);
+        SATLOG_INFO(SATLOG_TMM, "   T2 (sync forwarding): {}s", event.T2);
+        SATLOG_INFO(SATLOG_TMM, "   T3 (end BLD): {}s", event.T3);
+        return m_firstIndex + m_predictedEvents.size() - 1;
+    }
+    
+    uint32_t AddPredictableLinkDown(int linkId, int nodeA, int nodeB, double eventTime) {
+        return AddPredictableLinkDown(PredictableLinkDownEvent(linkId, nodeA, nodeB, eventTime));
+    }
+    
+    const PredictableLinkDownEvent& GetEvent(uint32_t index) const {
+        return m_predictedEvents[index - m_firstIndex];
     }
     
-    const std::vector<PredictableLinkDownEvent>& GetPredictedEvents() const {
+    const std::deque<PredictableLinkDownEvent>& GetPredictedEvents() const {
         return m_predictedEvents;
     }
     
+    /**
+     * The event is over (T3 dispatched, or never scheduled): inactive, then dropped with
+     * the retired events in front of it
+     */
+    void Retire(uint32_t index) {
+        if (index < m_firstIndex || index - m_firstIndex >= m_predictedEvents.size()) return;
+        m_predictedEvents[index - m_firstIndex].active = false;
+        while (!m_predictedEvents.empty() && !m_predictedEvents.front().active) {
+            m_predictedEvents.pop_front();
+            m_firstIndex++;
+        }
+    }
+    
+    uint32_t GetEventCount() const { return m_firstIndex + m_predictedEvents.size(); }
+    size_t GetPeakEvents() const { return m_peakEvents; }
+    
     std::vector<PredictableLinkDownEvent> GetActiveEvents(double currentTime) const {
         std::vector<PredictableLinkDownEvent> activeEvents;
         for (const auto& event : m_predictedEvents) {
@@ -76,11 +116,13 @@ public:
     }
     
     bool IsInBldPeriod(int nodeA, int nodeB, double currentTime) const {
+        SATNET_TIMER(TIMER_BLD_QUERY);
         for (const auto& event : m_predictedEvents) {
             if (event.active && 
                 ((event.nodeA == nodeA && event.nodeB == nodeB) ||
                  (event.nodeA == nodeB && event.nodeA == nodeA)) &&
                 currentTime >= event.T1 && currentTime <= event.T3) {
+                SATNET_COUNT(COUNTER_BLD_HITS, 1);
                 return true;
             }
         }